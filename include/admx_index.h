@@ -0,0 +1,100 @@
+#pragma once
+#include "registry_rule_table.h"
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * AdmxElement:
+ *   How a policy keeps its state in its registry value, after the element
+ *   types of an ADMX definition.
+ */
+enum class AdmxElement {
+    Boolean,    // enabledValue when Enabled, disabledValue when Disabled
+    Decimal,    // a number entered with the policy, e.g. a log size in KB
+    Enum,       // one item of a list, each item a DWORD
+};
+
+/**
+ * AdmxPolicy:
+ *   One policy definition compiled from an ADMX file: the registry value
+ *   Group Policy writes for it and what its states are written as. Keys
+ *   are relative to the hive the policy applies to (HKLM for machine
+ *   policies), mostly under SOFTWARE\Policies. `type` is REG_SZ for the
+ *   policies that store their numbers as text (storeAsText in the ADMX).
+ */
+struct AdmxPolicy {
+    std::string_view name;          // policy name in the ADMX, e.g. "CPL_Personalization_NoLockScreenCamera"
+    std::string_view displayName;   // as shown in the Group Policy editor
+    const wchar_t* key;
+    const wchar_t* valueName;
+    AdmxElement element;
+    DWORD enabledValue;
+    DWORD disabledValue;
+    DWORD type = REG_DWORD;
+};
+
+/**
+ * AdmxSetting:
+ *   One benchmark item over a policy: the state the policy must be in.
+ *   `requirement` is "enabled" or "disabled" for a Boolean policy, which
+ *   the index turns into a test of the policy's enabled or disabled value;
+ *   anything else is a rule expression (see RuleProgram) over the value,
+ *   e.g. "value >= 32768" for a Decimal element. A policy that is not
+ *   configured fails the item.
+ */
+struct AdmxSetting {
+    std::string_view id;
+    std::string_view title;
+    std::string_view policy;        // AdmxPolicy::name
+    std::string_view requirement;
+};
+
+/**
+ * AdmxIndex:
+ *   A table of AdmxPolicies indexed by name. It only references the table,
+ *   which is expected to be in static storage.
+ */
+class AdmxIndex {
+public:
+    AdmxIndex(const AdmxPolicy* policies, size_t count);
+
+    size_t size() const { return count; }
+
+    // Policy named `name`, or nullptr
+    const AdmxPolicy* find(std::string_view name) const;
+
+private:
+    const AdmxPolicy* policies;
+    size_t count;
+    std::vector<const AdmxPolicy*> byName;
+};
+
+/**
+ * AdmxRuleSet:
+ *   AdmxSettings compiled against an AdmxIndex into a RegistryRuleTable,
+ *   one row per setting in the order given, so a whole section of policy
+ *   settings is evaluated in one pass over its keys in sorted order, each
+ *   key read once. The set owns the rows and the expressions and details
+ *   they point to. A setting naming a policy the index does not have gets
+ *   a row whose expression does not compile, so it reports an Error.
+ */
+class AdmxRuleSet {
+public:
+    AdmxRuleSet(const AdmxIndex& index, const AdmxSetting* settings, size_t count);
+
+    AdmxRuleSet(const AdmxRuleSet&) = delete;
+    AdmxRuleSet& operator=(const AdmxRuleSet&) = delete;
+
+    const RegistryRuleTable& getTable() const { return table; }
+
+private:
+    std::vector<RegistryRule> compile(const AdmxIndex& index, const AdmxSetting* settings, size_t count);
+    const char* keep(std::string text);
+
+    std::deque<std::string> text;       // never moves what it holds
+    std::vector<RegistryRule> rows;
+    RegistryRuleTable table;
+};
@@ -1,19 +1,35 @@
 #pragma once
 #include "benchmark_types.h"
-#include <sal.h>
-#include <windows.h>
-#include <lm.h>
+#include "platform.h"
+#include "probes/probe_inputs.h"
+#include "probes/system_probe.h"
+#include "scalar_rule.h"
 #include <string>
-#include <memory>
+#include <string_view>
 
 class BenchmarkCheck {
 public:
     virtual ~BenchmarkCheck() = default;
     virtual BenchmarkResult check() = 0;
-    virtual std::string getId() const = 0;
-    virtual std::string getName() const = 0;
+
+    // Benchmark ID and title, from string literals in static storage
+    virtual std::string_view getId() const = 0;
+    virtual std::string_view getName() const = 0;
+
+    // Declares the probe data check() will read, so the engine can prefetch it
+    virtual void declareInputs(ProbeInputs&) const {}
+
+    /**
+     * The range comparison this check amounts to, if it is one. Such checks
+     * implement check() as checkScalar() and word their details in
+     * describeScalar, so per-host and columnar evaluation report the same.
+     */
+    virtual const ScalarRule* getScalarRule() const { return nullptr; }
+    virtual std::string describeScalar(CheckStatus, DWORD) const { return std::string(); }
 
 protected:
+    BenchmarkResult checkScalar() const;
+    SystemProbe& probe() const { return SystemProbe::current(); }
     HRESULT getRegistryDwordValue(const std::wstring& path, const std::wstring& value, DWORD& data);
     HRESULT getSecurityPolicy(const std::wstring& policyName, DWORD& value);
     std::string getLastErrorAsString();
@@ -1,16 +1,88 @@
 #pragma once
 #include "benchmark_section.h"
+#include "check_context.h"
+#include "run_context.h"
+#include "probes/host_collection.h"
+#include "probes/probe_inputs.h"
+#include <chrono>
+#include <iosfwd>
 #include <vector>
 #include <memory>
 
 class BenchmarkEngine {
 public:
     void registerSection(std::unique_ptr<BenchmarkSection> section);
+    void setProbe(std::shared_ptr<SystemProbe> probe);
+    void setJobs(unsigned int jobs);
+    void setCheckTimeout(std::chrono::milliseconds timeout);
+    void setSectionTimeout(std::chrono::milliseconds timeout);
+    void setTiming(bool enabled);
     void runChecks();
+
+    // Reads what the registered sections declared from the probe, without
+    // evaluating any check
+    HostCollection collect() const;
     void printResults() const;
     void exportResults(const std::string& filename) const;
 
+    /**
+     * Evaluates every registered check against `run` on the calling thread,
+     * in registration order, honouring the check and section timeouts.
+     * Sections and checks keep no per-system state, so several threads may
+     * evaluate different runs at once (one per host in fleet mode).
+     * With `selected` (one flag per check, in registration order), only
+     * the flagged checks are run and returned; the caller has the others'
+     * results from elsewhere (the columnar plan, a memo).
+     */
+    std::vector<BenchmarkResult> evaluate(RunContext& run, const std::vector<bool>* selected = nullptr) const;
+
+    // Every registered check, in registration order
+    const std::vector<BenchmarkCheck*>& getChecks() const { return checks; }
+
+    // What the registered checks declared they read
+    const ProbeInputs& getDeclaredInputs() const { return declaredInputs; }
+
+    /**
+     * CSV layout of exportResults, for callers that stream results elsewhere.
+     * When a registered section has per-user results, a User SID column
+     * follows Details and each user's outcome is a row of its own after
+     * the check's roll-up row, which leaves the column empty. `prefix`
+     * starts every row written for the result.
+     */
+    void writeCsvHeader(std::ostream& out) const;
+    void writeCsvRow(std::ostream& out, const BenchmarkResult& result,
+                     const std::string& prefix = std::string()) const;
+
 private:
+    struct SectionBudget;
+
+    // Steady-clock span of a section's checks, relative to the start of the run
+    struct SectionTiming {
+        int sectionNumber = 0;
+        std::string sectionName;
+        std::chrono::microseconds start{std::chrono::microseconds::max()};
+        std::chrono::microseconds end{0};
+        std::vector<std::chrono::microseconds> checkDurations;
+    };
+
+    CheckTiming prefetchInputs(RunContext& run, CheckContext::Clock::time_point origin) const;
+    void runScheduledChecks(RunContext& run);
+    void printSectionTimings() const;
+    BenchmarkResult runCheck(BenchmarkCheck& check, SectionBudget& budget, RunContext& run,
+                             CheckContext::Clock::time_point origin) const;
+
     std::vector<std::unique_ptr<BenchmarkSection>> sections;
+    std::vector<BenchmarkCheck*> checks;        // of every section, flattened at registration
+    std::vector<size_t> sectionOfCheck;
+    ProbeInputs declaredInputs;     // of every registered check, collected once
     std::vector<BenchmarkResult> results;
+    std::vector<SectionTiming> sectionTimings;
+    CheckTiming prefetchTiming;     // the run's bulk read of declared inputs, before any check
+    std::shared_ptr<SystemProbe> probe = SystemProbe::createDefault();
+    unsigned int jobs = 1;
+    std::chrono::milliseconds checkTimeout{0};
+    std::chrono::milliseconds sectionTimeout{0};
+    bool timing = false;
+    bool perUserResults = false;    // some registered section has them
+    CheckContext::Clock::time_point runStart;
 };
\ No newline at end of file
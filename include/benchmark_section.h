@@ -1,7 +1,57 @@
 #pragma once
 #include "benchmark_check.h"
-#include <vector>
+#include <array>
+#include <cstddef>
 #include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * CheckList:
+ *   A section's checks in registration order, as a view over pointers the
+ *   section keeps in static storage.
+ */
+class CheckList {
+public:
+    CheckList() = default;
+    CheckList(BenchmarkCheck* const* checks, size_t count) : checks(checks), count(count) {}
+
+    BenchmarkCheck* const* begin() const { return checks; }
+    BenchmarkCheck* const* end() const { return checks + count; }
+    size_t size() const { return count; }
+    BenchmarkCheck* operator[](size_t index) const { return checks[index]; }
+
+private:
+    BenchmarkCheck* const* checks = nullptr;
+    size_t count = 0;
+};
+
+/**
+ * CheckArray:
+ *   One object of each listed check type and a std::array of pointers to
+ *   them, in the order listed. A section keeps its checks in a
+ *   function-local static CheckArray, built once per process when the
+ *   section is first registered, instead of allocating every check. Checks
+ *   keep no per-run state, so every engine and worker can share them.
+ */
+template <typename... Checks>
+class CheckArray {
+public:
+    static constexpr size_t kSize = sizeof...(Checks);
+
+    CheckArray() : CheckArray(std::index_sequence_for<Checks...>()) {}
+
+    CheckList list() const { return CheckList(pointers.data(), pointers.size()); }
+    BenchmarkCheck* operator[](size_t index) const { return pointers[index]; }
+
+private:
+    template <size_t... I>
+    explicit CheckArray(std::index_sequence<I...>) : pointers{ { &std::get<I>(objects)... } } {}
+
+    std::tuple<Checks...> objects;
+    std::array<BenchmarkCheck*, kSize> pointers;
+};
 
 class BenchmarkSection {
 public:
@@ -11,6 +61,14 @@ public:
     virtual std::string getSectionName() const = 0;
     virtual int getSectionNumber() const = 0;
 
+    // Declares the probe data the section's shared snapshots read
+    virtual void declareInputs(ProbeInputs&) const {}
+
+    // True if the section's results carry per-user outcomes (BenchmarkResult::users)
+    virtual bool hasPerUserResults() const { return false; }
+
+    CheckList getChecks() const { return checks; }
+
 protected:
-    std::vector<std::unique_ptr<BenchmarkCheck>> checks;
+    CheckList checks;
 };
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 enum class CheckStatus {
     Pass,
@@ -8,12 +12,38 @@ enum class CheckStatus {
     Error
 };
 
+// System calls a check caused through the probe. Data served from a run's
+// shared caches costs nothing, so only the check that filled them pays.
+struct ProbeCallCounts {
+    uint32_t registryOpens = 0;
+    uint32_t processSpawns = 0;
+    uint32_t netApiCalls = 0;
+};
+
+// Steady-clock start and end of a check, relative to the start of its run
+struct CheckTiming {
+    std::chrono::microseconds start{0};
+    std::chrono::microseconds end{0};
+    ProbeCallCounts calls;
+
+    std::chrono::microseconds duration() const { return end - start; }
+};
+
+// Outcome of a per-user check for one user, whose hive it was read from
+struct UserResult {
+    std::string sid;            // "S-1-5-21-...-1001"
+    CheckStatus status;
+    std::string details;
+};
+
 struct BenchmarkResult {
     std::string checkId;
     std::string checkName;
     CheckStatus status;
     std::string details;
+    CheckTiming timing;
+    std::vector<UserResult> users;      // per-user checks: each user's outcome, status is their roll-up
     
-    BenchmarkResult(const std::string& id, const std::string& name, CheckStatus st, const std::string& det)
+    BenchmarkResult(std::string_view id, std::string_view name, CheckStatus st, const std::string& det)
         : checkId(id), checkName(name), status(st), details(det) {}
 };
\ No newline at end of file
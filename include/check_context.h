@@ -0,0 +1,74 @@
+#pragma once
+#include "benchmark_types.h"
+#include <atomic>
+#include <chrono>
+
+class RunContext;
+
+/**
+ * CheckContext:
+ *   Execution state for the check running on the current thread.
+ *   The engine installs one around every check it runs. Helpers that
+ *   can block for a long time (child processes, pipes) poll isCancelled()
+ *   and give up once the check's deadline has passed. The context also
+ *   links the check to the RunContext (probe and shared snapshots) of the
+ *   run it belongs to, and counts the system calls probes make for it.
+ */
+class CheckContext {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class ProbeCall {
+        RegistryOpen,
+        ProcessSpawn,
+        NetApi
+    };
+
+    explicit CheckContext(Clock::time_point deadline = Clock::time_point::max(),
+                          RunContext* run = nullptr);
+
+    /** Context of the check running on this thread, or nullptr. */
+    static CheckContext* current();
+
+    Clock::time_point getDeadline() const { return deadline; }
+    RunContext* getRun() const { return run; }
+    bool isCancelled() const;
+    void cancel();
+
+    /**
+     * Called by a helper that gave up on its work because the check was
+     * cancelled, so the check's result is incomplete. Only then does the
+     * engine report the check as timed out.
+     */
+    void markAborted();
+    bool wasAborted() const { return aborted.load(); }
+
+    /** Counts a call against the current check; a no-op outside one. */
+    static void recordProbeCall(ProbeCall call);
+    const ProbeCallCounts& getProbeCalls() const { return probeCalls; }
+
+    /**
+     * Adds calls made for the check under other contexts, such as those of
+     * the workers of a pool the check fanned out to, once they have joined.
+     */
+    void addProbeCalls(const ProbeCallCounts& calls);
+
+    /** Installs a context as current for the lifetime of the scope. */
+    class Scope {
+    public:
+        explicit Scope(CheckContext& context);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        CheckContext* previous;
+    };
+
+private:
+    Clock::time_point deadline;
+    RunContext* run;
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> aborted{false};
+    ProbeCallCounts probeCalls;     // only touched by the check's own thread
+};
\ No newline at end of file
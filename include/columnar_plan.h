@@ -0,0 +1,61 @@
+#pragma once
+#include "benchmark_engine.h"
+#include "scalar_rule.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * ColumnarPlan:
+ *   The scalar rules of an engine's checks, laid out for evaluation across
+ *   many hosts at once. Each distinct rule input is one column holding the
+ *   value of every host of a Batch, next to a bitmap of the hosts where it
+ *   could not be read. evaluate() runs one ScalarKernels range test per rule
+ *   over its column, or the rule's RuleProgram through the batch
+ *   interpreter, so the verdicts of a whole batch come out as bitmaps
+ *   without a virtual check() call or a string per host. Details text is
+ *   only produced when result() is asked for a row.
+ *
+ *   A plan is built once and shared, read-only, by every worker; each
+ *   worker fills its own Batch.
+ */
+class ColumnarPlan {
+public:
+    struct Batch {
+        size_t hostCount = 0;
+        std::vector<std::vector<uint32_t>> values;      // [column][host]
+        std::vector<std::vector<uint64_t>> missing;     // [column] bitmap of unreadable values
+        std::vector<std::vector<uint64_t>> passed;      // [rule] bitmap, filled by evaluate()
+    };
+
+    explicit ColumnarPlan(const BenchmarkEngine& engine);
+
+    size_t getCheckCount() const { return checks.size(); }
+    size_t getRuleCount() const { return rules.size(); }
+    size_t getColumnCount() const { return columns.size(); }
+
+    // True if check `checkIndex` (registration order) is evaluated columnar
+    bool isColumnar(size_t checkIndex) const { return ruleOfCheck[checkIndex] >= 0; }
+
+    Batch newBatch(size_t hostCount) const;
+
+    // Reads every column's value of host `host` from its run
+    void gather(RunContext& run, Batch& batch, size_t host) const;
+
+    // Runs every rule's range kernel or program over the batch
+    void evaluate(Batch& batch) const;
+
+    // Result of columnar check `checkIndex` for host `host` of an evaluated batch
+    BenchmarkResult result(const Batch& batch, size_t checkIndex, size_t host) const;
+
+private:
+    struct Rule {
+        const BenchmarkCheck* check;
+        const ScalarRule* rule;
+        size_t column;
+    };
+
+    std::vector<const BenchmarkCheck*> checks;
+    std::vector<int> ruleOfCheck;               // -1 for checks that run per host
+    std::vector<Rule> rules;
+    std::vector<const ScalarRule*> columns;     // the first rule reading each column
+};
\ No newline at end of file
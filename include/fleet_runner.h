@@ -0,0 +1,62 @@
+#pragma once
+#include "benchmark_engine.h"
+#include "probes/snapshot_image.h"
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * FleetRunner:
+ *   Evaluates the engine's sections against many hosts in one process.
+ *   Every subdirectory of the fleet directory is one host's SnapshotBundle
+ *   and its name is the host ID. Hosts are split into batches spread over
+ *   a work-stealing pool. For each host of its batch a worker loads the
+ *   bundle through a SubtreeStore shared by the whole run, runs the checks
+ *   that have no ScalarRule with BenchmarkEngine::evaluate, gathers the
+ *   scalar rule inputs into the batch's columns and drops the bundle. The
+ *   scalar rules are then evaluated for the whole batch by ColumnarPlan,
+ *   and the batch's rows are appended to the output. Sections, checks, the
+ *   columnar plan and the store are shared by every host.
+ *
+ *   The store keeps one copy of each distinct declared registry key and
+ *   policy file, and a per-host check's result is memoized on the ids of
+ *   the keys it declared plus the host's policy files. A host only runs the
+ *   checks whose inputs no earlier host had, so the work grows with the
+ *   number of distinct configurations rather than the number of hosts.
+ *   Checks therefore see only the registry values they declared.
+ */
+class FleetRunner {
+public:
+    struct Summary {
+        size_t hosts = 0;
+        size_t loadFailures = 0;
+        size_t passed = 0;
+        size_t failed = 0;
+        size_t errors = 0;
+        size_t notApplicable = 0;
+        size_t columnarRules = 0;   // checks evaluated by the columnar plan
+        size_t distinctSubtrees = 0;    // registry key contents in the SubtreeStore
+        size_t distinctFiles = 0;       // policy file contents in the SubtreeStore
+        size_t memoizedResults = 0;     // per-host check results reused
+    };
+
+    FleetRunner(const BenchmarkEngine& engine, unsigned int jobs);
+
+    // Full image that the hosts' delta images are laid over
+    void setBaseline(std::shared_ptr<const SnapshotImage> baseline);
+
+    // Subdirectories of `directory`, sorted by name
+    static std::vector<std::string> discoverHosts(const std::string& directory);
+
+    /**
+     * Evaluates every host and streams "Host,<result columns>" CSV rows to
+     * `out`, one batch of hosts at a time, in completion order. A host whose
+     * bundle cannot be loaded gets a single ERROR row naming the file.
+     */
+    Summary run(const std::string& directory, const std::vector<std::string>& hosts, std::ostream& out) const;
+
+private:
+    const BenchmarkEngine& engine;
+    unsigned int jobs;
+    std::shared_ptr<const SnapshotImage> baseline;
+};
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include "platform.h"
+#include <cstddef>
+#include <string>
+
+/**
+ * MappedFile:
+ *   Read-only memory mapping of a whole file: mmap on POSIX, a file
+ *   mapping on Windows. Parsers work directly on the mapped bytes, so
+ *   large snapshots are paged in on demand instead of being read into
+ *   memory up front. Move-only; the view is unmapped on destruction.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    HRESULT open(const std::string& fileName);
+
+    const BYTE* data() const { return view; }
+    size_t size() const { return length; }
+
+private:
+    void close();
+
+    const BYTE* view = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+/**
+ * platform.h:
+ *   On Windows this is just <windows.h>. Elsewhere it supplies the handful
+ *   of Win32 types, status codes and constants the checks use, so the rule
+ *   set compiles unchanged and runs against a snapshot probe backend.
+ */
+#ifdef _WIN32
+
+// Keep <windows.h> from defining min/max macros over std::min/std::max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <lm.h>
+
+#else
+
+#include <cstdint>
+
+typedef uint32_t DWORD;
+typedef uint8_t  BYTE;
+typedef int32_t  LONG;
+typedef int32_t  HRESULT;
+typedef int      BOOL;
+typedef DWORD    NET_API_STATUS;
+
+#ifndef TRUE
+#define TRUE  1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#define S_OK                            ((HRESULT)0)
+#define SUCCEEDED(hr)                   (((HRESULT)(hr)) >= 0)
+#define FAILED(hr)                      (((HRESULT)(hr)) < 0)
+#define HRESULT_FROM_WIN32(x)           ((HRESULT)(x) <= 0 ? (HRESULT)(x) \
+                                         : (HRESULT)(((x) & 0x0000FFFF) | (7 << 16) | 0x80000000))
+
+#define ERROR_SUCCESS                   0L
+#define ERROR_FILE_NOT_FOUND            2L
+#define ERROR_ACCESS_DENIED             5L
+#define ERROR_INVALID_DATA              13L
+#define ERROR_NOT_SUPPORTED             50L
+#define ERROR_OPEN_FAILED               110L
+#define ERROR_MORE_DATA                 234L
+#define ERROR_SERVICE_DOES_NOT_EXIST    1060L
+#define ERROR_NOT_FOUND                 1168L
+#define ERROR_NONE_MAPPED               1332L
+#define ERROR_NO_SUCH_ALIAS             1376L
+#define ERROR_TIMEOUT                   1460L
+
+#define NERR_Success                    0
+#define NERR_UserNotFound               2221
+#define TIMEQ_FOREVER                   ((DWORD)-1)
+
+#define REG_NONE                        0
+#define REG_SZ                          1
+#define REG_EXPAND_SZ                   2
+#define REG_BINARY                      3
+#define REG_DWORD                       4
+#define REG_MULTI_SZ                    7
+#define REG_QWORD                       11
+
+#define UF_ACCOUNTDISABLE               0x0002
+
+#define SERVICE_BOOT_START              0x00000000
+#define SERVICE_SYSTEM_START            0x00000001
+#define SERVICE_AUTO_START              0x00000002
+#define SERVICE_DEMAND_START            0x00000003
+#define SERVICE_DISABLED                0x00000004
+
+#define SERVICE_STOPPED                 0x00000001
+#define SERVICE_RUNNING                 0x00000004
+
+#endif
\ No newline at end of file
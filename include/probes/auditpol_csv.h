@@ -0,0 +1,25 @@
+#pragma once
+#include "system_probe.h"
+#include <string>
+#include <vector>
+
+/**
+ * AuditpolCsv:
+ *   Parser for the CSV that `auditpol /get /category:* /r` prints and that
+ *   `auditpol /backup` writes. Both start with the columns
+ *     Machine Name,Policy Target,Subcategory,Subcategory GUID,Inclusion Setting,...
+ *   and /backup adds a numeric Setting Value (0-3) at the end. Columns are
+ *   taken by position, since the header itself is localized.
+ *
+ *   The encoding is taken from the byte order mark (UTF-16LE or UTF-8) and
+ *   is UTF-8 without one; live auditpol output, already decoded from the
+ *   console code page, goes through parseText. Subcategory names
+ *   are localized and may be lossy in legacy-encoded files; GUIDs are not,
+ *   so rows without a GUID (the global options of a backup) are skipped.
+ */
+class AuditpolCsv {
+public:
+    static HRESULT parse(const BYTE* data, size_t size, std::vector<AuditSubcategorySetting>& settings);
+    static HRESULT parseText(const std::wstring& text, std::vector<AuditSubcategorySetting>& settings);
+    static HRESULT load(const std::string& fileName, std::vector<AuditSubcategorySetting>& settings);
+};
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+#include "probe_inputs.h"
+#include "system_probe.h"
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * HostCollection:
+ *   Everything the registered sections read from one host, captured in a
+ *   single pass by the collector and evaluated elsewhere. What the host
+ *   answered is kept as data; a read that failed is kept as a status, so
+ *   evaluating the collection fails that read the same way rather than
+ *   reporting it as not found or empty.
+ */
+struct HostCollection {
+    struct RegistryEntry {
+        std::wstring path;
+        std::wstring valueName;
+        RegistryValue value;
+    };
+
+    enum class Query : uint32_t { Registry = 1, Services, Service, Right, AuditPolicy };
+
+    // The bulk queries (services, audit policy) are recorded whatever they
+    // returned, so an empty list is known to be the host's; registry
+    // values, services and rights only when reading them failed for a
+    // reason other than their not existing
+    struct QueryStatus {
+        Query query;
+        std::wstring name;          // key path, service or right; empty for a bulk query
+        std::wstring valueName;     // registry only
+        HRESULT status;
+    };
+
+    std::vector<RegistryEntry> registry;
+    std::optional<PasswordModals> password;
+    std::optional<LockoutModals> lockout;
+    std::optional<PasswordProperties> passwordProperties;
+    std::vector<std::pair<std::wstring, UserAccountInfo>> users;          // queried name -> info
+    std::vector<std::pair<std::wstring, std::vector<std::wstring>>> groups;
+    std::vector<ServiceEntry> services;
+    std::vector<std::pair<std::wstring, std::vector<std::wstring>>> rights;
+    std::vector<AuditSubcategorySetting> auditPolicy;
+    std::vector<QueryStatus> statuses;
+};
+
+/**
+ * Collector:
+ *   Walks the union of what the registered checks and sections declared
+ *   in ProbeInputs and reads it from `probe`, each registry key in one
+ *   batched read and each bulk query (services, audit policy, modals)
+ *   once. No rule logic runs.
+ */
+class Collector {
+public:
+    static HostCollection collect(const ProbeInputs& inputs, SystemProbe& probe);
+};
+
+/**
+ * HostCollectionFile:
+ *   The self-describing text form of a HostCollection: UTF-8, one
+ *   tab-separated record per line, the first field naming the record.
+ *     win11-benchmark-collection  1
+ *     registry  <path>  <value name>  <type>  <data as hex>
+ *     password  <min len>  <max age>  <min age>  <force logoff>  <history>
+ *     lockout   <duration>  <observation window>  <threshold>
+ *     passwordproperties  <complexity>  <clear text password>
+ *     user      <queried name>  <name>  <flags>
+ *     group     <group>  <member>...
+ *     service   <name>  <start type>  <current state>
+ *     right     <right>  <sid>...
+ *     audit     <subcategory>  <guid>  <inclusion setting>
+ *     status    <query>  <name>  <value name>  <hresult>
+ *   A status names its query as registry, services, service, right or
+ *   audit. Numbers are decimal, in the units the live APIs report. Tabs,
+ *   line breaks and backslashes inside names are escaped as \t, \n, \r
+ *   and \\. Records of kinds this version does not know are skipped.
+ */
+class HostCollectionFile {
+public:
+    static void write(const HostCollection& collection, std::ostream& out);
+    static HRESULT parse(const BYTE* data, size_t size, HostCollection& collection);
+    static HRESULT load(const std::string& fileName, HostCollection& collection);
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include "system_probe.h"
+
+/**
+ * LiveSystemProbe:
+ *   SystemProbe backend that queries the running Windows host through the
+ *   registry, NetAPI, SCM, LSA, auditpol.exe and secedit.exe. Windows only.
+ *
+ *   Account name lookups are memoized for the life of the process, since
+ *   on a domain member each one may be a round trip to a DC.
+ */
+class LiveSystemProbe : public SystemProbe {
+public:
+    HRESULT queryRegistryValue(const std::wstring& path, const std::wstring& valueName,
+                               RegistryValue& value) override;
+    HRESULT queryRegistryValues(const std::wstring& path, std::vector<RegistryLookup>& lookups) override;
+    HRESULT queryPasswordModals(PasswordModals& modals) override;
+    HRESULT queryLockoutModals(LockoutModals& modals) override;
+    HRESULT queryPasswordProperties(PasswordProperties& properties) override;
+    HRESULT queryUserInfo(const std::wstring& userName, UserAccountInfo& info) override;
+    HRESULT queryLocalGroupMembers(const std::wstring& groupName,
+                                   std::vector<std::wstring>& members) override;
+    HRESULT queryServices(std::vector<ServiceEntry>& services) override;
+    HRESULT lookupAccountSid(const std::wstring& accountName, std::wstring& sid) override;
+    HRESULT queryAccountsWithRight(const std::wstring& rightName,
+                                   std::vector<std::wstring>& sids) override;
+    HRESULT queryAuditPolicy(std::vector<AuditSubcategorySetting>& settings) override;
+    HRESULT queryUserProfiles(std::vector<UserProfile>& profiles) override;
+    HRESULT openUserHive(const UserProfile& profile, std::shared_ptr<const RegistrySource>& hive) override;
+
+private:
+    friend class LoadedUserHive;
+
+    // LookupAccountNameW + ConvertSidToStringSidW, without the memo
+    static HRESULT LookupAccountSidUncached(const std::wstring& accountName, std::wstring& sid);
+
+    // QueryServiceConfigW start type of one service; buffer is reused across calls
+    static HRESULT QueryStartType(SC_HANDLE hSCM, const std::wstring& serviceName,
+                                  std::vector<BYTE>& buffer, DWORD& startType);
+
+    // RegQueryValueExW on a key that is already open
+    static LONG ReadValue(HKEY hKey, const std::wstring& valueName, RegistryValue& value);
+
+    /**
+     * Runs `auditpol.exe <arguments>` and returns its stdout. Kills the
+     * process and returns an empty string if the running check's
+     * CheckContext is cancelled before auditpol.exe finishes.
+     */
+    static std::wstring RunAuditpol(const std::wstring& arguments);
+
+    /**
+     * Runs `secedit.exe <arguments>` and waits for it to exit successfully.
+     * Kills the process and fails with ERROR_CANCELLED if the running
+     * check's CheckContext is cancelled first.
+     */
+    static HRESULT RunSecedit(const std::wstring& arguments);
+};
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * ProbeInputs:
+ *   Probe data a check is going to read, declared up front so the engine
+ *   can fetch it in bulk before any check runs and the collector knows what
+ *   to capture. Registry values are grouped by key path (case-insensitively)
+ *   so each key is read in one go. Other data is declared by the query that
+ *   returns it; names are kept once, case-insensitively.
+ */
+class ProbeInputs {
+public:
+    struct RegistryKey {
+        std::wstring path;
+        std::vector<std::wstring> valueNames;
+    };
+
+    void addRegistryValue(const std::wstring& path, const std::wstring& valueName);
+
+    // Queries that return everything at once
+    void addAccountModals() { accountModals = true; }
+    void addServices() { services = true; }
+    void addAuditPolicy() { auditPolicy = true; }
+
+    void addUser(const std::wstring& userName);
+    void addLocalGroup(const std::wstring& groupName);
+    void addAccountRight(const std::wstring& rightName);
+
+    // Keyed by lower-cased path
+    const std::map<std::wstring, RegistryKey>& getRegistryKeys() const { return registryKeys; }
+
+    bool needsAccountModals() const { return accountModals; }
+    bool needsServices() const { return services; }
+    bool needsAuditPolicy() const { return auditPolicy; }
+    const std::vector<std::wstring>& getUsers() const { return users; }
+    const std::vector<std::wstring>& getLocalGroups() const { return localGroups; }
+    const std::vector<std::wstring>& getAccountRights() const { return accountRights; }
+
+private:
+    static void addName(std::vector<std::wstring>& names, const std::wstring& name);
+
+    std::map<std::wstring, RegistryKey> registryKeys;
+    bool accountModals = false;
+    bool services = false;
+    bool auditPolicy = false;
+    std::vector<std::wstring> users;
+    std::vector<std::wstring> localGroups;
+    std::vector<std::wstring> accountRights;
+};
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include "registry_source.h"
+#include "../mapped_file.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * RegExportSource:
+ *   RegistrySource over a `regedit /e` export (UTF-16LE with a BOM, the
+ *   format regedit writes). The file is memory-mapped and tokenized in one
+ *   pass that records where every key and value sits in the mapping; no
+ *   text is copied. A value's data is only decoded when it is looked up.
+ *
+ *   Keys under HKEY_LOCAL_MACHINE are indexed by their HKLM-relative path;
+ *   keys of other hives keep their full path. When a key or value appears
+ *   more than once, the last occurrence wins, as it would on import.
+ */
+class RegExportSource : public RegistrySource {
+public:
+    static HRESULT load(const std::string& fileName, std::shared_ptr<RegExportSource>& source);
+
+    HRESULT queryValue(const std::wstring& path, const std::wstring& valueName,
+                       RegistryValue& value) const override;
+
+    size_t getKeyCount() const { return keys.size(); }
+    size_t getValueCount() const { return values.size(); }
+
+private:
+    static constexpr uint32_t kNoValue = UINT32_MAX;
+
+    // Views into the mapping. A name is kept as written, escapes included.
+    struct ValueRecord {
+        std::u16string_view name;
+        std::u16string_view data;
+        uint32_t next;              // earlier value of the same key
+    };
+
+    struct FoldHash {
+        size_t operator()(std::u16string_view s) const;
+    };
+    struct FoldEqual {
+        bool operator()(std::u16string_view a, std::u16string_view b) const;
+    };
+
+    HRESULT parse();
+
+    static bool nameEquals(std::u16string_view escapedName, const std::wstring& name);
+    static HRESULT decodeData(std::u16string_view data, RegistryValue& value);
+
+    MappedFile file;
+    std::unordered_map<std::u16string_view, uint32_t, FoldHash, FoldEqual> keys;   // path -> newest value
+    std::vector<ValueRecord> values;
+};
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+#include "registry_source.h"
+#include "../mapped_file.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/**
+ * RegfHiveSource:
+ *   RegistrySource over a raw hive file (regf format: the SYSTEM, SOFTWARE,
+ *   SECURITY and SAM files of System32\config, or a user's NTUSER.DAT).
+ *   The file is memory-mapped and nothing is read up front: a lookup walks
+ *   from the root key down its path one nk cell at a time, using the
+ *   lh/lf hashes and hints to skip non-matching subkeys, so only the pages
+ *   along that path are ever touched. Names and data are read in place.
+ *
+ *   The hive's root is mounted at mountPath under HKEY_LOCAL_MACHINE, so a
+ *   SOFTWARE hive mounted at L"SOFTWARE" answers for paths beginning with
+ *   SOFTWARE\. In a SYSTEM hive, CurrentControlSet resolves to the control
+ *   set named by Select\Current. An empty mountPath takes paths relative
+ *   to the hive root.
+ *
+ *   Transaction logs are not replayed; a hive copied from a running system
+ *   may miss its most recent changes.
+ */
+class RegfHiveSource : public RegistrySource {
+public:
+    static HRESULT load(const std::string& fileName, const std::wstring& mountPath,
+                        std::shared_ptr<RegfHiveSource>& source);
+
+    HRESULT queryValue(const std::wstring& path, const std::wstring& valueName,
+                       RegistryValue& value) const override;
+
+    // Value of the key at hivePath, a path relative to the hive root
+    HRESULT queryHiveValue(std::wstring_view hivePath, const std::wstring& valueName,
+                           RegistryValue& value) const;
+
+private:
+    static constexpr uint32_t kNoCell = UINT32_MAX;
+
+    HRESULT parseHeader();
+
+    // Cell payload at a hive-bin offset, or nullptr if it is out of bounds,
+    // unallocated or smaller than minSize
+    const BYTE* cell(uint32_t offset, uint32_t minSize, uint32_t* payloadSize = nullptr) const;
+
+    uint32_t findKey(std::wstring_view hivePath) const;
+    uint32_t findSubkey(uint32_t keyCell, std::wstring_view name) const;
+    uint32_t searchSubkeyList(uint32_t listCell, std::wstring_view name, uint32_t nameHash, int depth) const;
+    bool keyNameEquals(uint32_t keyCell, std::wstring_view name) const;
+    HRESULT readValueData(const BYTE* vk, RegistryValue& value) const;
+
+    MappedFile file;
+    std::wstring mountPath;
+    uint32_t rootCell = kNoCell;
+    uint32_t minorVersion = 0;
+    std::wstring currentControlSet;     // "ControlSet001" in a SYSTEM hive
+};
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+#include "system_probe.h"
+
+/**
+ * RegistrySource:
+ *   Read-only registry data captured from a host (an export file, a hive)
+ *   that a SnapshotProbe consults for values it does not hold itself.
+ *   Paths are relative to HKEY_LOCAL_MACHINE and matched case-insensitively.
+ *   Lookups must be safe to run concurrently.
+ */
+class RegistrySource {
+public:
+    virtual ~RegistrySource() = default;
+
+    // ERROR_FILE_NOT_FOUND if the source has no such key or value
+    virtual HRESULT queryValue(const std::wstring& path, const std::wstring& valueName,
+                               RegistryValue& value) const = 0;
+};
\ No newline at end of file
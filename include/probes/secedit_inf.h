@@ -0,0 +1,41 @@
+#pragma once
+#include "system_probe.h"
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * SeceditPolicy:
+ *   Account policy and user rights read from a security template, already
+ *   in the form the live probe reports them: NetUserModalsGet units
+ *   (seconds, TIMEQ_FOREVER for "never") and string SIDs.
+ */
+struct SeceditPolicy {
+    bool hasPasswordModals = false;
+    PasswordModals password;
+    bool hasLockoutModals = false;
+    LockoutModals lockout;
+    std::optional<DWORD> passwordComplexity;    // PasswordProperties, when the template gives them
+    std::optional<DWORD> clearTextPassword;
+    bool hasPrivilegeRights = false;    // the template has the section, even if empty
+    std::map<std::wstring, std::vector<std::wstring>> rights;   // "SeNetworkLogonRight" -> SIDs
+};
+
+/**
+ * SeceditInf:
+ *   Parser for the INF that `secedit /export /cfg FILE` writes
+ *   (UTF-16LE). Reads the [System Access] password, password property and
+ *   lockout keys and every line of [Privilege Rights]; other sections are
+ *   skipped.
+ *
+ *   Template ages are in days and lockout times in minutes, with -1 for
+ *   "never"/"until unlocked". Rights list "*S-1-..." SIDs, or account
+ *   names that secedit could not map; well-known names are translated,
+ *   other names are kept as written and simply never match a SID.
+ */
+class SeceditInf {
+public:
+    static HRESULT parse(const BYTE* data, size_t size, SeceditPolicy& policy);
+    static HRESULT load(const std::string& fileName, SeceditPolicy& policy);
+};
\ No newline at end of file
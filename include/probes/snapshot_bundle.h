@@ -0,0 +1,66 @@
+#pragma once
+#include "host_collection.h"
+#include "snapshot_image.h"
+#include "snapshot_probe.h"
+#include "subtree_store.h"
+#include <iosfwd>
+#include <string>
+
+/**
+ * SnapshotBundle:
+ *   The captured files an offline evaluation of one host reads. Any of
+ *   them may be absent; what is missing is simply not in the snapshot.
+ *
+ *   On the command line each file is named by its own option. In fleet
+ *   mode every host is a directory holding the files under fixed names:
+ *     registry.reg                       regedit export of HKLM
+ *     SYSTEM, SOFTWARE, SECURITY, SAM    raw hive files
+ *     auditpol.csv                       auditpol /r output or /backup file
+ *     secedit.inf                        secedit /export template
+ *     collection.txt                     HostCollectionFile from --collect
+ *     snapshot.img                       SnapshotImage from --collect-image
+ *
+ *   A delta snapshot.img is laid over `baseline`, which the caller opens
+ *   once and shares between bundles.
+ *
+ *   `userHiveDir` holds copies of users' NTUSER.DAT files, each named
+ *   <SID>.DAT or kept as <SID>\NTUSER.DAT, for the per-user sections.
+ *   Fleet mode does not read user hives.
+ */
+struct SnapshotBundle {
+    std::string regExport;
+    std::string hiveDir;
+    std::string auditpolCsv;
+    std::string seceditInf;
+    std::string collection;
+    std::string image;
+    std::string userHiveDir;
+    std::shared_ptr<const SnapshotImage> baseline;
+
+    // The well-known files present in `directory`
+    static SnapshotBundle fromDirectory(const std::string& directory);
+
+    bool empty() const;
+
+    /**
+     * Loads every file of the bundle into a new SnapshotProbe. On failure
+     * `failedFile` names the file that could not be read. When `log` is
+     * given, a line is written to it for each file loaded.
+     */
+    HRESULT load(std::shared_ptr<SnapshotProbe>& probe, std::string& failedFile,
+                 std::ostream* log = nullptr) const;
+
+    /**
+     * Like load, but through a fleet's SubtreeStore: only the declared
+     * registry values are read from the registry files, and the probe keeps
+     * the interned copies instead of the files. Policy files are parsed once
+     * per distinct content. `content` receives the store ids the snapshot is
+     * made of.
+     */
+    HRESULT loadShared(SubtreeStore& store, std::shared_ptr<SnapshotProbe>& probe,
+                       SnapshotContent& content, std::string& failedFile) const;
+
+private:
+    HRESULT loadRegistry(SnapshotProbe& snapshot, std::string& failedFile, std::ostream* log) const;
+    HRESULT loadUserProfiles(SnapshotProbe& snapshot, std::string& failedFile, std::ostream* log) const;
+};
\ No newline at end of file
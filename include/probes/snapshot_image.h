@@ -0,0 +1,111 @@
+#pragma once
+#include "../mapped_file.h"
+#include "host_collection.h"
+#include "registry_source.h"
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/**
+ * SnapshotImage:
+ *   Binary form of a HostCollection that is queried in place. Opening one
+ *   maps the file and checks its header and table bounds, nothing more;
+ *   a registry lookup hashes the folded path and value name, binary
+ *   searches the index and compares the interned strings in the mapping.
+ *
+ *   Layout (little-endian, every table 8-byte aligned):
+ *     header      magic "W11SNAPI", version, flags, the offset and size of
+ *                 the registry block and of the policy block, the content
+ *                 hash of both blocks and, for a delta, its baseline's hash
+ *     block       table count, then {offset, count} per table, relative to
+ *                 the block, followed by the tables
+ *   The registry block holds the string table (char offsets, UTF-16
+ *   chars), the index ({FNV-1a hash, record} sorted by hash), fixed-width
+ *   value records (path, name, type, data offset, data size) and the
+ *   value data. The policy block holds its own string table and the
+ *   modals, user, group, service, right, audit and query status records,
+ *   with member and SID lists in a shared list table. Both blocks only refer to their
+ *   own contents, so the policy block of two hosts with the same settings
+ *   is byte-identical wherever it sits in the file.
+ *
+ *   Records refer to strings by id and every id and range is checked when
+ *   it is read, so a damaged file fails its lookups rather than the process.
+ *
+ *   A delta image holds only what differs from a full baseline image,
+ *   which it names by content hash: changed and added values, and
+ *   removal records for values, users, groups, services, rights, audit
+ *   subcategories and query statuses the baseline has but the host does
+ *   not. A delta is opened on top of its baseline and answers registry
+ *   lookups from its own index first, then from the baseline's, without
+ *   copying either.
+ */
+struct PolicyDelta;
+
+class SnapshotImage : public RegistrySource {
+public:
+    /**
+     * Maps an image. A delta image needs the full image it was taken
+     * against as `baseline` and fails with ERROR_NOT_FOUND without it.
+     */
+    static HRESULT open(const std::string& fileName, std::shared_ptr<SnapshotImage>& image,
+                        std::shared_ptr<const SnapshotImage> baseline = nullptr);
+    static void write(const HostCollection& collection, std::ostream& out);
+
+    // Writes what `collection` changes relative to the full image `baseline`
+    static HRESULT writeDelta(const HostCollection& collection, const SnapshotImage& baseline, std::ostream& out);
+
+    bool isDelta() const;
+    uint64_t getContentHash() const;
+    const std::shared_ptr<const SnapshotImage>& getBaseline() const { return baseline; }
+
+    // Everything a full image holds, copied out
+    HRESULT readCollection(HostCollection& collection) const;
+
+    HRESULT queryValue(const std::wstring& path, const std::wstring& valueName,
+                       RegistryValue& value) const override;
+
+    size_t getValueCount() const;
+
+    // The policy block as stored, for interning by content
+    const BYTE* policyData() const { return file.data() + policyOffset; }
+    size_t policySize() const { return policyLength; }
+
+    // Reads the non-registry part of a collection out of a policy block
+    static HRESULT parsePolicy(const BYTE* data, size_t size, HostCollection& collection);
+
+    // Reads the policy block of a delta image
+    static HRESULT parsePolicyDelta(const BYTE* data, size_t size, PolicyDelta& delta);
+
+private:
+    HRESULT findValue(const std::u16string& path, const std::u16string& valueName, RegistryValue& value) const;
+
+    MappedFile file;
+    std::shared_ptr<const SnapshotImage> baseline;
+    size_t registryOffset = 0;
+    size_t registryLength = 0;
+    size_t policyOffset = 0;
+    size_t policyLength = 0;
+};
+
+/**
+ * PolicyDelta:
+ *   The policy records of a delta image. Changed records replace the
+ *   baseline's record of the same name (case-insensitively; audit settings
+ *   by GUID; query statuses by query, name and value name) and removed
+ *   names drop it. Modals, with the password properties, are replaced as
+ *   a whole when the delta carries them.
+ */
+struct PolicyDelta {
+    HostCollection changed;
+    bool replacesModals = false;
+    std::vector<std::wstring> removedUsers;
+    std::vector<std::wstring> removedGroups;
+    std::vector<std::wstring> removedServices;
+    std::vector<std::wstring> removedRights;
+    std::vector<std::wstring> removedAudit;
+    std::vector<std::wstring> removedStatuses;
+
+    void applyTo(HostCollection& collection) const;
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include "registry_source.h"
+#include "system_probe.h"
+#include <map>
+#include <optional>
+
+/**
+ * SnapshotProbe:
+ *   In-memory SystemProbe backend. Loaders fill it with data captured from
+ *   a host, after which it answers every query without touching the local
+ *   system, so the full rule set can be evaluated on any platform.
+ *
+ *   Registry values not set directly are looked up in the attached
+ *   RegistrySources (exports, hives), in the order they were added.
+ *
+ *   Services, user rights, the audit policy and user profiles are answered
+ *   only once a loader has supplied that kind of data, by setting an entry
+ *   of it or by marking it loaded when the source had none; until then
+ *   their queries fail with ERROR_NOT_FOUND, like the modals do, rather
+ *   than report an empty list the host never had.
+ *
+ *   A read that failed on the host is replayed by setting its failure: the
+ *   registry value, service, right or whole list then fails with the
+ *   host's HRESULT, whatever other sources hold.
+ *
+ *   Names (registry paths, services, groups, accounts, rights) are matched
+ *   case-insensitively, as Windows does. Populate it before handing it to
+ *   the engine; queries are read-only and may run concurrently.
+ */
+class SnapshotProbe : public SystemProbe {
+public:
+    enum class ListData { Services, Rights, AuditPolicy, UserProfiles, Count };
+
+    void setRegistryValue(const std::wstring& path, const std::wstring& valueName, RegistryValue value);
+    void setRegistryDword(const std::wstring& path, const std::wstring& valueName, DWORD data);
+    void addRegistrySource(std::shared_ptr<const RegistrySource> source);
+    void setPasswordModals(const PasswordModals& modals);
+    void setLockoutModals(const LockoutModals& modals);
+    void setPasswordProperties(const PasswordProperties& properties);
+    void setUserInfo(const std::wstring& userName, const UserAccountInfo& info);
+    void setLocalGroupMembers(const std::wstring& groupName, std::vector<std::wstring> members);
+    void setServiceConfig(const std::wstring& serviceName, const ServiceConfig& config);
+    void setAccountSid(const std::wstring& accountName, const std::wstring& sid);
+    void setAccountsWithRight(const std::wstring& rightName, std::vector<std::wstring> sids);
+    void setAuditSubcategory(const std::wstring& subcategory, const std::wstring& setting,
+                             const std::wstring& guid = std::wstring());
+
+    // A user whose hive is the NTUSER.DAT copy profile.hiveFile
+    void addUserProfile(UserProfile profile);
+
+    // Marks `kind` as supplied even if no entry of it is set
+    void markLoaded(ListData kind);
+
+    void setListFailure(ListData kind, HRESULT status);
+    void setRegistryFailure(const std::wstring& path, const std::wstring& valueName, HRESULT status);
+    void setServiceFailure(const std::wstring& serviceName, HRESULT status);
+    void setRightFailure(const std::wstring& rightName, HRESULT status);
+
+    HRESULT queryRegistryValue(const std::wstring& path, const std::wstring& valueName,
+                               RegistryValue& value) override;
+    HRESULT queryPasswordModals(PasswordModals& modals) override;
+    HRESULT queryLockoutModals(LockoutModals& modals) override;
+    HRESULT queryPasswordProperties(PasswordProperties& properties) override;
+    HRESULT queryUserInfo(const std::wstring& userName, UserAccountInfo& info) override;
+    HRESULT queryLocalGroupMembers(const std::wstring& groupName,
+                                   std::vector<std::wstring>& members) override;
+    HRESULT queryServices(std::vector<ServiceEntry>& services) override;
+    HRESULT lookupAccountSid(const std::wstring& accountName, std::wstring& sid) override;
+    HRESULT queryAccountsWithRight(const std::wstring& rightName,
+                                   std::vector<std::wstring>& sids) override;
+    HRESULT queryAuditPolicy(std::vector<AuditSubcategorySetting>& settings) override;
+    HRESULT queryUserProfiles(std::vector<UserProfile>& profiles) override;
+    HRESULT openUserHive(const UserProfile& profile, std::shared_ptr<const RegistrySource>& hive) override;
+
+private:
+    static std::wstring registryKey(const std::wstring& path, const std::wstring& valueName);
+    HRESULT listStatus(ListData kind) const;
+
+    // All map keys are lower-cased
+    std::map<std::wstring, RegistryValue> registryValues;
+    std::map<std::wstring, HRESULT> registryFailures;
+    std::vector<std::shared_ptr<const RegistrySource>> registrySources;
+    std::optional<PasswordModals> passwordModals;
+    std::optional<LockoutModals> lockoutModals;
+    std::optional<PasswordProperties> passwordProperties;
+    std::map<std::wstring, UserAccountInfo> users;
+    std::map<std::wstring, std::vector<std::wstring>> groupMembers;
+    std::map<std::wstring, ServiceEntry> services;
+    std::map<std::wstring, std::wstring> accountSids;
+    std::map<std::wstring, std::vector<std::wstring>> rights;
+    std::map<std::wstring, HRESULT> rightFailures;
+    std::map<std::wstring, AuditSubcategorySetting> auditSettings;
+    std::vector<UserProfile> userProfiles;
+    std::optional<HRESULT> listStatuses[static_cast<size_t>(ListData::Count)];
+};
\ No newline at end of file
@@ -0,0 +1,185 @@
+#pragma once
+#include "../mapped_file.h"
+#include "probe_inputs.h"
+#include "registry_source.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * RegistrySubtree:
+ *   The declared values of one registry key as read on a host, one lookup
+ *   per value in ProbeInputs order (failed reads keep their status).
+ *   Immutable once interned; hosts with the same content share it.
+ */
+struct RegistrySubtree {
+    uint32_t id = 0;            // dense within its store, from 1
+    uint64_t hash = 0;
+    std::vector<RegistryLookup> values;
+};
+
+// What a host snapshot is made of, as SubtreeStore ids. Two hosts with the
+// same content look exactly alike to every check.
+struct SnapshotContent {
+    std::vector<uint32_t> subtreeIds;   // one per declared key
+    uint32_t auditpolId = 0;            // 0 if the host has no such file
+    uint32_t seceditId = 0;
+    uint32_t collectionId = 0;
+    uint32_t imagePolicyId = 0;         // policy block of a snapshot image or its baseline
+    uint32_t imageDeltaId = 0;          // policy block of a delta image
+};
+
+/**
+ * SubtreeStore:
+ *   Content-addressed store of the snapshot data a fleet shares. Hosts built
+ *   from one image hold identical values under most of the keys the checks
+ *   read (Lsa, Netlogon, the firewall profiles), so each declared key's
+ *   values are hashed and interned once and every host references the
+ *   shared copy. Policy files (auditpol.csv, secedit.inf, collections) and
+ *   the policy blocks of snapshot images are likewise parsed once per
+ *   distinct content, and a delta's policy is laid over its baseline's once
+ *   per distinct pair. Memory therefore tracks how many
+ *   distinct configurations the fleet has rather than how many hosts, and
+ *   the ids of a host's content can key memoized results.
+ *
+ *   Content is compared in full on a hash match, so distinct data never
+ *   shares an id. Safe to use from every worker at once.
+ */
+class SubtreeStore {
+public:
+    explicit SubtreeStore(const ProbeInputs& inputs);
+
+    // Declared keys, in the order of ingest()'s subtrees
+    size_t getKeyCount() const { return keys.size(); }
+
+    // Index of the declared key `path`, or -1
+    int findKey(const std::wstring& path) const;
+
+    // Reads every declared key from `probe` and interns the values
+    std::vector<std::shared_ptr<const RegistrySubtree>> ingest(SystemProbe& probe);
+
+    /**
+     * Maps `fileName` and returns the result of `parse` on its bytes, parsing
+     * only if no file with the same content was parsed into a T before.
+     * `id` identifies the content among files parsed into a T.
+     */
+    template <typename T>
+    HRESULT internFile(const std::string& fileName, HRESULT (*parse)(const BYTE*, size_t, T&),
+                       std::shared_ptr<const T>& parsed, uint32_t& id);
+
+    // Like internFile, for bytes that are already in memory
+    template <typename T>
+    HRESULT internData(const BYTE* data, size_t size, HRESULT (*parse)(const BYTE*, size_t, T&),
+                       std::shared_ptr<const T>& parsed, uint32_t& id);
+
+    /**
+     * Returns the T that `merge()` derives from two interned contents, given
+     * by their ids, calling it only for the first host with that pair.
+     */
+    template <typename T, typename Merge>
+    std::shared_ptr<const T> internMerged(uint32_t firstId, uint32_t secondId, Merge merge);
+
+    size_t getSubtreeCount() const;
+    size_t getFileCount() const;
+
+private:
+    struct FileEntry {
+        std::type_index type;
+        uint32_t id;
+        std::vector<BYTE> bytes;
+        std::shared_ptr<const void> parsed;
+    };
+
+    static uint64_t hashBytes(const BYTE* data, size_t size);
+
+    std::shared_ptr<const RegistrySubtree> intern(std::vector<RegistryLookup> values);
+    const FileEntry* matchFile(std::type_index type, uint64_t hash, const BYTE* data, size_t size) const;
+    const FileEntry* findFile(std::type_index type, uint64_t hash, const BYTE* data, size_t size) const;
+    const FileEntry* addFile(std::type_index type, uint64_t hash, const BYTE* data, size_t size,
+                             std::shared_ptr<const void> parsed);
+
+    std::vector<ProbeInputs::RegistryKey> keys;
+    std::map<std::wstring, size_t> keyIndex;    // by lower-cased path
+
+    mutable std::mutex mutex;
+    std::unordered_multimap<uint64_t, std::shared_ptr<const RegistrySubtree>> subtrees;
+    std::unordered_multimap<uint64_t, std::unique_ptr<FileEntry>> files;
+    std::map<std::type_index, uint32_t> fileCounts;
+    std::map<std::tuple<std::type_index, uint32_t, uint32_t>, std::shared_ptr<const void>> merged;
+};
+
+template <typename T>
+HRESULT SubtreeStore::internFile(const std::string& fileName, HRESULT (*parse)(const BYTE*, size_t, T&),
+                                 std::shared_ptr<const T>& parsed, uint32_t& id)
+{
+    MappedFile file;
+    HRESULT hr = file.open(fileName);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    return internData(file.data(), file.size(), parse, parsed, id);
+}
+
+template <typename T>
+HRESULT SubtreeStore::internData(const BYTE* data, size_t size, HRESULT (*parse)(const BYTE*, size_t, T&),
+                                 std::shared_ptr<const T>& parsed, uint32_t& id)
+{
+    std::type_index type(typeid(T));
+    uint64_t hash = hashBytes(data, size);
+    const FileEntry* entry = findFile(type, hash, data, size);
+    if (!entry) {
+        // Two workers may parse the same new content at once; addFile keeps
+        // whichever comes first
+        auto result = std::make_shared<T>();
+        HRESULT hr = parse(data, size, *result);
+        if (FAILED(hr)) {
+            return hr;
+        }
+        entry = addFile(type, hash, data, size, std::move(result));
+    }
+
+    parsed = std::static_pointer_cast<const T>(entry->parsed);
+    id = entry->id;
+    return S_OK;
+}
+
+template <typename T, typename Merge>
+std::shared_ptr<const T> SubtreeStore::internMerged(uint32_t firstId, uint32_t secondId, Merge merge)
+{
+    auto key = std::make_tuple(std::type_index(typeid(T)), firstId, secondId);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = merged.find(key);
+        if (it != merged.end()) {
+            return std::static_pointer_cast<const T>(it->second);
+        }
+    }
+
+    // Merged outside the lock; as with internData, the first result is kept
+    std::shared_ptr<const T> result = std::make_shared<const T>(merge());
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::static_pointer_cast<const T>(merged.emplace(key, std::move(result)).first->second);
+}
+
+/**
+ * SubtreeSource:
+ *   RegistrySource over one host's interned subtrees. It answers only for
+ *   the declared values; anything else is not found.
+ */
+class SubtreeSource : public RegistrySource {
+public:
+    SubtreeSource(const SubtreeStore& store, std::vector<std::shared_ptr<const RegistrySubtree>> subtrees);
+
+    HRESULT queryValue(const std::wstring& path, const std::wstring& valueName,
+                       RegistryValue& value) const override;
+
+private:
+    const SubtreeStore& store;
+    std::vector<std::shared_ptr<const RegistrySubtree>> subtrees;
+};
\ No newline at end of file
@@ -0,0 +1,163 @@
+#pragma once
+#include "../platform.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class RegistrySource;
+
+/**
+ * Plain data returned by a SystemProbe. These mirror the Win32 structures
+ * the checks used to read directly, without depending on <windows.h>.
+ */
+struct RegistryValue {
+    DWORD type = REG_NONE;
+    std::vector<BYTE> data;
+};
+
+// One value of a batched registry read; the caller fills in valueName
+struct RegistryLookup {
+    std::wstring valueName;
+    HRESULT status = S_OK;
+    RegistryValue value;
+};
+
+// USER_MODALS_INFO_0
+struct PasswordModals {
+    DWORD minPasswdLen = 0;
+    DWORD maxPasswdAge = 0;
+    DWORD minPasswdAge = 0;
+    DWORD forceLogoff = 0;
+    DWORD passwordHistLen = 0;
+};
+
+// USER_MODALS_INFO_3
+struct LockoutModals {
+    DWORD lockoutDuration = 0;
+    DWORD lockoutObservationWindow = 0;
+    DWORD lockoutThreshold = 0;
+};
+
+// The password properties of the account domain (PasswordComplexity and
+// ClearTextPassword in a security template's [System Access]), 1 or 0
+struct PasswordProperties {
+    DWORD passwordComplexity = 0;
+    DWORD clearTextPassword = 0;    // passwords stored using reversible encryption
+};
+
+// Where the SAM keeps the account domain's fixed-size "F" record, which
+// holds the password properties
+constexpr wchar_t kSamAccountDomainKey[] = L"SAM\\SAM\\Domains\\Account";
+
+// USER_INFO_1 (the fields the checks use)
+struct UserAccountInfo {
+    std::wstring name;
+    DWORD flags = 0;
+};
+
+// One row of `auditpol /get /category:* /r`
+struct AuditSubcategorySetting {
+    std::wstring subcategory;       // "Credential Validation"
+    std::wstring guid;              // "{0CCE923F-69AE-11D9-BED3-505054503030}"
+    std::wstring inclusionSetting;  // "Success and Failure"
+};
+
+// QUERY_SERVICE_CONFIG start type and SERVICE_STATUS current state
+struct ServiceConfig {
+    DWORD startType = 0;
+    DWORD currentState = 0;
+};
+
+// One installed service. status is the outcome of reading its configuration.
+struct ServiceEntry {
+    std::wstring name;          // key name, e.g. "Spooler"
+    HRESULT status = S_OK;
+    ServiceConfig config;
+};
+
+// One user profile of the host, from ProfileList
+struct UserProfile {
+    std::wstring sid;           // "S-1-5-21-...-1001"
+    std::string hiveFile;       // the profile's NTUSER.DAT
+    bool loaded = false;        // the hive is mounted under HKEY_USERS\<sid>
+};
+
+/**
+ * SystemProbe:
+ *   Every piece of system state a check reads goes through this interface.
+ *   LiveSystemProbe answers from the running Windows host; SnapshotProbe
+ *   answers from data captured earlier, on any platform.
+ *
+ *   All methods return an HRESULT. Lookups of something that does not
+ *   exist fail with the Win32 code the live API would have reported
+ *   (ERROR_FILE_NOT_FOUND for registry values, ERROR_SERVICE_DOES_NOT_EXIST
+ *   for services, and so on). Implementations must be safe to call from
+ *   several worker threads at once.
+ */
+class SystemProbe {
+public:
+    virtual ~SystemProbe() = default;
+
+    /**
+     * Probe for the check running on this thread: the one of the current
+     * RunContext, or the process default outside an engine run.
+     */
+    static SystemProbe& current();
+
+    /** LiveSystemProbe on Windows, an empty SnapshotProbe elsewhere. */
+    static std::shared_ptr<SystemProbe> createDefault();
+
+    // Registry value under HKEY_LOCAL_MACHINE\<path>
+    virtual HRESULT queryRegistryValue(const std::wstring& path, const std::wstring& valueName,
+                                       RegistryValue& value) = 0;
+
+    /**
+     * Several values of one key in a single read. Sets each lookup's status
+     * and value, and returns the failure to open the key, if any. The
+     * default implementation calls queryRegistryValue once per value.
+     */
+    virtual HRESULT queryRegistryValues(const std::wstring& path, std::vector<RegistryLookup>& lookups);
+
+    // NetUserModalsGet levels 0 and 3
+    virtual HRESULT queryPasswordModals(PasswordModals& modals) = 0;
+    virtual HRESULT queryLockoutModals(LockoutModals& modals) = 0;
+
+    /**
+     * The account domain's password properties. The default implementation
+     * decodes them from the SAM's "F" record (kSamAccountDomainKey), which
+     * only SYSTEM can read on a live host; a mounted SAM hive has it too.
+     */
+    virtual HRESULT queryPasswordProperties(PasswordProperties& properties);
+
+    // NetUserGetInfo level 1
+    virtual HRESULT queryUserInfo(const std::wstring& userName, UserAccountInfo& info) = 0;
+
+    // NetLocalGroupGetMembers level 2 ("DOMAIN\name" strings)
+    virtual HRESULT queryLocalGroupMembers(const std::wstring& groupName,
+                                           std::vector<std::wstring>& members) = 0;
+
+    // Every installed Win32 service (EnumServicesStatusEx + QueryServiceConfig)
+    virtual HRESULT queryServices(std::vector<ServiceEntry>& services) = 0;
+
+    // LookupAccountName, as a string SID ("S-1-5-32-544")
+    virtual HRESULT lookupAccountSid(const std::wstring& accountName, std::wstring& sid) = 0;
+
+    // LsaEnumerateAccountsWithUserRight, as string SIDs
+    virtual HRESULT queryAccountsWithRight(const std::wstring& rightName,
+                                           std::vector<std::wstring>& sids) = 0;
+
+    // Every advanced audit subcategory with its inclusion setting
+    virtual HRESULT queryAuditPolicy(std::vector<AuditSubcategorySetting>& settings) = 0;
+
+    // Profiles of the host's user accounts, without the service profiles
+    virtual HRESULT queryUserProfiles(std::vector<UserProfile>& profiles) = 0;
+
+    /**
+     * Opens the registry hive of `profile`, taking paths relative to its
+     * root (HKEY_USERS\<sid>). Nothing is read up front: a loaded hive is
+     * read in place, and an unloaded NTUSER.DAT is mapped and walked only
+     * along the paths looked up, so the cost follows the keys read rather
+     * than the size of the hive.
+     */
+    virtual HRESULT openUserHive(const UserProfile& profile, std::shared_ptr<const RegistrySource>& hive) = 0;
+};
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include "probes/probe_inputs.h"
+#include "probes/system_probe.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * RegistryCache:
+ *   Per-run cache of registry values. prefetch() reads every declared value
+ *   with one probe call per distinct key; lookups are then served from
+ *   memory. A value nobody declared is read on first use and cached too,
+ *   so the number of registry reads tracks distinct keys, not checks.
+ *
+ *   Failed reads are cached with their HRESULT, just like values; a value
+ *   of a key that could not be opened is cached with the open's failure.
+ */
+class RegistryCache {
+public:
+    explicit RegistryCache(SystemProbe& probe);
+
+    void prefetch(const ProbeInputs& inputs);
+
+    HRESULT getValue(const std::wstring& path, const std::wstring& valueName, RegistryValue& value);
+    HRESULT getDword(const std::wstring& path, const std::wstring& valueName, DWORD& data);
+
+    /**
+     * Fills every lookup of one key, each with its value and status as
+     * getValue would. Values not cached yet are read together in a single
+     * probe call, so the key is opened at most once.
+     */
+    void getValues(const std::wstring& path, std::vector<RegistryLookup>& lookups);
+
+private:
+    struct Entry {
+        HRESULT status = S_OK;
+        RegistryValue value;
+    };
+
+    static std::wstring cacheKey(const std::wstring& path, const std::wstring& valueName);
+
+    SystemProbe& probe;
+    std::mutex mutex;
+    std::unordered_map<std::wstring, Entry> entries;
+};
\ No newline at end of file
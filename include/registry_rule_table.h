@@ -0,0 +1,132 @@
+#pragma once
+#include "benchmark_check.h"
+#include "registry_cache.h"
+#include "probes/registry_source.h"
+#include "rule_program.h"
+#include "scalar_rule.h"
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * RegistryRule:
+ *   One row of a registry rule table: a check that reads a single value
+ *   under HKLM (or the root of a user hive) and tests it with a rule
+ *   expression (see RuleProgram), with the text to report for each
+ *   outcome. A REG_DWORD value is tested as a number, a REG_SZ value as
+ *   the decimal number it holds (ADMX decimals stored as text), a
+ *   REG_MULTI_SZ value by its strings. A value that is missing, of another
+ *   type than `type`, or not the number expected gets `missingStatus`, an
+ *   Error unless the row says otherwise (a policy that is not configured
+ *   fails). Every row whose expression does not compile is an Error.
+ *   Details may contain "{}", which is replaced by the DWORD read.
+ */
+struct RegistryRule {
+    std::string_view id;
+    std::string_view title;
+    const wchar_t* path;
+    const wchar_t* valueName;
+    DWORD type;                     // REG_DWORD, REG_SZ or REG_MULTI_SZ
+    std::string_view expression;
+    const char* errorDetails;
+    const char* passDetails;
+    const char* failDetails;
+    CheckStatus missingStatus = CheckStatus::Error;
+};
+
+/**
+ * RegistryRuleTable:
+ *   Evaluates a table of RegistryRules with one generic evaluator instead
+ *   of a check class per rule. Every row's expression is compiled once,
+ *   with the table. The rows are kept in the order given; a key-sorted
+ *   index groups rows that read the same key, so evaluate() makes one pass
+ *   over the keys and fetches each key's values with one batched read.
+ *
+ *   The engine schedules, times and batches checks one by one, so each row
+ *   is also registered as a RegistryRuleCheck (see RegistryRuleChecks),
+ *   which reads its key's values for all of the key's rows at once.
+ *   REG_DWORD rows expose their program as a ScalarRule, which lets fleet
+ *   mode evaluate them columnar.
+ */
+class RegistryRuleTable {
+public:
+    RegistryRuleTable(const RegistryRule* rules, size_t count);
+
+    size_t size() const { return count; }
+    const RegistryRule& operator[](size_t row) const { return rules[row]; }
+    const RuleProgram& getProgram(size_t row) const { return programs[row]; }
+
+    void declareInputs(ProbeInputs& inputs) const;
+
+    // Results of every row, in row order, read through `registry`
+    std::vector<BenchmarkResult> evaluate(RegistryCache& registry) const;
+
+    // Results of every row, in row order, read from `source` (a user hive)
+    // with the rows visited in key order
+    std::vector<BenchmarkResult> evaluate(const RegistrySource& source) const;
+
+    // Result of one row given what reading its value returned
+    BenchmarkResult evaluate(size_t row, HRESULT status, const RegistryValue& value) const;
+
+    // Reads one row's value through `registry`, in one batched read with
+    // every other row of its key, so those then come from the cache
+    HRESULT read(RegistryCache& registry, size_t row, RegistryValue& value) const;
+
+    static std::string describe(const RegistryRule& rule, CheckStatus status, DWORD value);
+
+private:
+    const RegistryRule* rules;
+    size_t count;
+    std::vector<RuleProgram> programs;
+    std::vector<size_t> keyOrder;   // rows sorted by folded path, then value name
+    std::vector<size_t> keyGroup;   // per row, where its key's rows start in keyOrder
+};
+
+/**
+ * RegistryRuleCheck:
+ *   One row of a RegistryRuleTable as a BenchmarkCheck, so the engine can
+ *   schedule it. It holds no state beyond the row and its ScalarRule.
+ */
+class RegistryRuleCheck : public BenchmarkCheck {
+public:
+    RegistryRuleCheck(const RegistryRuleTable& table, size_t row);
+
+    BenchmarkResult check() override;
+    std::string_view getId() const override { return table[row].id; }
+    std::string_view getName() const override { return table[row].title; }
+    void declareInputs(ProbeInputs& inputs) const override;
+
+    // Only for REG_DWORD rows whose expression compiled
+    const ScalarRule* getScalarRule() const override { return scalar.program ? &scalar : nullptr; }
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+
+private:
+    const RegistryRuleTable& table;
+    size_t row;
+    ScalarRule scalar;
+};
+
+/**
+ * RegistryRuleChecks:
+ *   A Check (a RegistryRuleCheck unless given, built from the table and a
+ *   row) for every row of a table of N rows, held in a std::array so a
+ *   section can keep them in static storage.
+ */
+template <size_t N, typename Check = RegistryRuleCheck>
+class RegistryRuleChecks {
+public:
+    explicit RegistryRuleChecks(const RegistryRuleTable& table)
+        : RegistryRuleChecks(table, std::make_index_sequence<N>()) {}
+
+    BenchmarkCheck* operator[](size_t row) { return &checks[row]; }
+
+private:
+    template <size_t... I>
+    RegistryRuleChecks(const RegistryRuleTable& table, std::index_sequence<I...>)
+        : checks{ { Check(table, I)... } } {}
+
+    std::array<Check, N> checks;
+};
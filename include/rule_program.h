@@ -0,0 +1,73 @@
+#pragma once
+#include "platform.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Audit inclusion flags, named `success` and `failure` in rule expressions
+constexpr DWORD kAuditSuccess = 1;
+constexpr DWORD kAuditFailure = 2;
+
+// Flags of an auditpol inclusion setting such as "Success and Failure"
+DWORD parseAuditFlags(const std::wstring& inclusionSetting);
+
+// What a program tests: a number (a DWORD, audit flags) and, for
+// multi-sz values, their strings
+struct RuleInput {
+    DWORD number = 0;
+    const std::vector<std::wstring>* strings = nullptr;
+};
+
+/**
+ * RuleProgram:
+ *   A rule expression compiled to bytecode, so a comparison can ship as
+ *   data instead of C++. The language:
+ *     value == N   (also != < <= > >=)    comparison, unsigned
+ *     value in [LOW, HIGH]                inclusive range
+ *     value in {N, N, ...}                set membership
+ *     value & MASK == N   (or !=)         bitmask test
+ *     value has FLAGS                     every bit of FLAGS is set
+ *     value contains "text"               a multi-sz string equals text,
+ *                                         case-insensitively
+ *     !  &&  ||  ( )                      combining tests
+ *   Numbers are decimal or 0x hex; `success`, `failure` and `none` name
+ *   audit flags, and `a|b` ORs constants.
+ *
+ *   The bytecode is postfix: an opcode word followed by its operands.
+ *   Comparisons are lowered to a few primitive tests, each pushing one bit
+ *   on a stack kept in a single 64-bit word that the combinators pop, so
+ *   test() makes no data-dependent branches and a program is a few dozen
+ *   bytes. evaluateBatch() runs the same program over a column of values
+ *   with a stack of bitmaps, the ranges going through ScalarKernels.
+ */
+class RuleProgram {
+public:
+    // A program that failed to compile, or was never compiled, tests false
+    RuleProgram() = default;
+    explicit RuleProgram(std::string_view expression);
+
+    static HRESULT compile(std::string_view expression, RuleProgram& program);
+
+    HRESULT getStatus() const { return status; }
+    const std::string& getExpression() const { return expression; }
+
+    // True if only the number is tested, so evaluateBatch applies
+    bool isNumeric() const { return strings.empty(); }
+
+    bool test(const RuleInput& input) const;
+    bool test(DWORD value) const { return test(RuleInput{ value, nullptr }); }
+
+    // Bit i of `bits` is test(values[i]); fills ScalarKernels::bitmapWords(count) words
+    void evaluateBatch(const uint32_t* values, size_t count, uint64_t* bits) const;
+
+private:
+    friend class RuleCompiler;
+
+    std::vector<uint32_t> code;
+    std::vector<std::wstring> strings;      // lower-cased operands of `contains`
+    std::string expression;
+    size_t maxDepth = 0;
+    HRESULT status = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include "check_context.h"
+#include "probes/system_probe.h"
+#include "registry_cache.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+
+/**
+ * RunContext:
+ *   State shared by every check of one benchmark run against one system:
+ *   the probe the checks read through, and snapshots of probe data that
+ *   several checks need. A snapshot is built the first time any check asks
+ *   for it and is then shared, immutable, by the rest of the run, including
+ *   checks running on other workers. Registry values are cached separately,
+ *   per value, in the run's RegistryCache.
+ */
+class RunContext {
+public:
+    explicit RunContext(std::shared_ptr<SystemProbe> probe);
+
+    /**
+     * Context of the run the current check belongs to. Outside an engine
+     * run this is a process-wide context over the default probe.
+     */
+    static RunContext& current();
+
+    SystemProbe& getProbe() const { return *probe; }
+    RegistryCache& getRegistry() { return registry; }
+
+    /**
+     * Worker threads the run was given (--jobs). A check that fans its own
+     * work out to a pool sizes the pool from this, not from the machine.
+     */
+    void setJobs(unsigned int jobs) { this->jobs = jobs > 0 ? jobs : 1; }
+    unsigned int getJobs() const { return jobs; }
+
+    /**
+     * Returns this run's T, calling build(SystemProbe&) to produce it on
+     * first use. Concurrent callers wait for the one build in progress.
+     * The build runs under the calling check's deadline; if that cut it
+     * short (the check's context was aborted), the partial T is returned
+     * to that check only and the next caller builds again.
+     */
+    template <typename T, typename Build>
+    std::shared_ptr<const T> getOrBuild(Build build);
+
+private:
+    struct Slot {
+        std::mutex mutex;
+        std::shared_ptr<const void> value;
+    };
+
+    std::shared_ptr<Slot> slotFor(std::type_index type);
+
+    std::shared_ptr<SystemProbe> probe;
+    RegistryCache registry;
+    unsigned int jobs = 1;
+    std::mutex mutex;
+    std::map<std::type_index, std::shared_ptr<Slot>> slots;
+};
+
+template <typename T, typename Build>
+std::shared_ptr<const T> RunContext::getOrBuild(Build build) {
+    std::shared_ptr<Slot> slot = slotFor(std::type_index(typeid(T)));
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    if (slot->value) {
+        return std::static_pointer_cast<const T>(slot->value);
+    }
+
+    auto built = std::make_shared<const T>(build(*probe));
+    CheckContext* context = CheckContext::current();
+    if (!context || !context->wasAborted()) {
+        slot->value = built;
+    }
+    return built;
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * ScalarKernels:
+ *   Range tests over a column of values, one per host, packed into a
+ *   bitmap: bit i (word i / 64, bit i % 64) is set when
+ *   low <= values[i] <= high. The comparison is unsigned.
+ *
+ *   On x86-64 the AVX2 kernel is used when the CPU supports it and the SSE2
+ *   kernel otherwise; other targets get the portable scalar loop. All of
+ *   them produce identical bitmaps.
+ */
+class ScalarKernels {
+public:
+    // Words of a bitmap holding `count` bits
+    static size_t bitmapWords(size_t count) { return (count + 63) / 64; }
+
+    // Fills bitmapWords(count) words of `bits`; unused trailing bits are 0
+    static void inRange(const uint32_t* values, size_t count, uint32_t low, uint32_t high, uint64_t* bits);
+
+    static void inRangeScalar(const uint32_t* values, size_t count, uint32_t low, uint32_t high, uint64_t* bits);
+
+    // "avx2", "sse2" or "scalar": the kernel inRange dispatches to
+    static const char* getKernelName();
+};
\ No newline at end of file
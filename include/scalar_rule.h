@@ -0,0 +1,38 @@
+#pragma once
+#include "benchmark_types.h"
+#include "platform.h"
+#include "rule_program.h"
+#include <string>
+
+/**
+ * ScalarRule:
+ *   A check that comes down to one DWORD compared against an inclusive
+ *   range: Pass when low <= value <= high, Fail otherwise, and
+ *   `missingStatus` when the value cannot be read. Checks of this shape
+ *   expose their rule through BenchmarkCheck::getScalarRule so that fleet
+ *   mode can evaluate it for a whole batch of hosts at once (see
+ *   ColumnarPlan) instead of calling check() host by host.
+ *
+ *   A rule with a `program` passes when that rule expression holds for the
+ *   value instead, low and high being unused; the program must be numeric.
+ *
+ *   `read` fetches the value for the run of the current check. Rules with
+ *   the same reader, path and value name share one input column.
+ */
+struct ScalarRule {
+    HRESULT (*read)(const ScalarRule& rule, DWORD& value);
+    std::wstring path;          // registry key, for registry-backed readers
+    std::wstring valueName;
+    DWORD low;
+    DWORD high;
+    CheckStatus missingStatus;
+    const RuleProgram* program = nullptr;
+
+    bool passes(DWORD value) const { return program ? program->test(value) : (low <= value && value <= high); }
+};
+
+// Upper bound of a rule that only has a minimum
+constexpr DWORD kScalarNoMaximum = 0xFFFFFFFF;
+
+// Reader for HKLM\<rule.path>\<rule.valueName> through the run's registry cache
+HRESULT readRegistryDword(const ScalarRule& rule, DWORD& value);
\ No newline at end of file
@@ -1,13 +1,20 @@
 #pragma once
-#include <windows.h>
-#include <sal.h>
-#include <lm.h>
-#include <lmaccess.h>
-#include <ntsecapi.h>
 #include "../../../include/benchmark_section.h"
 
-#pragma comment(lib, "netapi32.lib")
-#pragma comment(lib, "advapi32.lib")
+/**
+ * AccountPolicySnapshot:
+ *   USER_MODALS_INFO_0 and _3, and the domain's password properties, as
+ *   read once for a run. A failed fetch keeps its HRESULT so every check
+ *   depending on it still reports the error.
+ */
+struct AccountPolicySnapshot {
+    HRESULT passwordStatus = S_OK;
+    PasswordModals password;
+    HRESULT lockoutStatus = S_OK;
+    LockoutModals lockout;
+    HRESULT propertiesStatus = S_OK;
+    PasswordProperties properties;
+};
 
 class AccountPoliciesSection : public BenchmarkSection {
 public:
@@ -15,14 +22,20 @@ public:
     std::vector<BenchmarkResult> runChecks() override;
     std::string getSectionName() const override { return "Account Policies"; }
     int getSectionNumber() const override { return 1; }
+    void declareInputs(ProbeInputs& inputs) const override;
+
+    // Shared, read-only policy snapshot of the current run
+    static std::shared_ptr<const AccountPolicySnapshot> getPolicySnapshot();
 };
 
 // Password Policy Checks
 class PasswordHistoryCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId() const override { return "1.1.1"; }
-    std::string getName() const override { 
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    std::string_view getId() const override { return "1.1.1"; }
+    std::string_view getName() const override { 
         return "Ensure 'Enforce password history' is set to '24 or more password(s)'";
     }
 };
@@ -30,8 +43,10 @@ public:
 class MaxPasswordAgeCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId() const override { return "1.1.2"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    std::string_view getId() const override { return "1.1.2"; }
+    std::string_view getName() const override {
         return "Ensure 'Maximum password age' is set to '365 or fewer days, but not 0'";
     }
 };
@@ -39,8 +54,10 @@ public:
 class MinPasswordAgeCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId() const override { return "1.1.3"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    std::string_view getId() const override { return "1.1.3"; }
+    std::string_view getName() const override {
         return "Ensure 'Minimum password age' is set to '1 or more day(s)'";
     }
 };
@@ -48,8 +65,10 @@ public:
 class MinPasswordLengthCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId() const override { return "1.1.4"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    std::string_view getId() const override { return "1.1.4"; }
+    std::string_view getName() const override {
         return "Ensure 'Minimum password length' is set to '14 or more character(s)'";
     }
 };
@@ -57,8 +76,11 @@ public:
 class PasswordComplexityCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId() const override { return "1.1.5"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    void declareInputs(ProbeInputs& inputs) const override;
+    std::string_view getId() const override { return "1.1.5"; }
+    std::string_view getName() const override {
         return "Ensure 'Password must meet complexity requirements' is set to 'Enabled'";
     }
 };
@@ -66,8 +88,11 @@ public:
 class RelaxMinPasswordLengthCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId() const override { return "1.1.6"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    void declareInputs(ProbeInputs& inputs) const override;
+    std::string_view getId() const override { return "1.1.6"; }
+    std::string_view getName() const override {
         return "Ensure 'Relax minimum password length limits' is set to 'Enabled'";
     }
 };
@@ -75,8 +100,10 @@ public:
 class StorePwdReversibleCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId() const override { return "1.1.7"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    std::string_view getId() const override { return "1.1.7"; }
+    std::string_view getName() const override {
         return "Ensure 'Store passwords using reversible encryption' is set to 'Disabled'";
     }
 };
@@ -85,8 +112,10 @@ public:
 class AccountLockoutDurationCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId() const override { return "1.2.1"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    std::string_view getId() const override { return "1.2.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Account lockout duration' is set to '15 or more minute(s)'";
     }
 };
@@ -94,8 +123,10 @@ public:
 class AccountLockoutThresholdCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId() const override { return "1.2.2"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    std::string_view getId() const override { return "1.2.2"; }
+    std::string_view getName() const override {
         return "Ensure 'Account lockout threshold' is set to '5 or fewer invalid logon attempt(s), but not 0'";
     }
 };
@@ -103,8 +134,11 @@ public:
 class AllowAdminLockoutCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId() const override { return "1.2.3"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    void declareInputs(ProbeInputs& inputs) const override;
+    std::string_view getId() const override { return "1.2.3"; }
+    std::string_view getName() const override {
         return "Ensure 'Allow Administrator account lockout' is set to 'Enabled'";
     }
 };
@@ -112,8 +146,10 @@ public:
 class ResetLockoutCounterCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId() const override { return "1.2.4"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    std::string_view getId() const override { return "1.2.4"; }
+    std::string_view getName() const override {
         return "Ensure 'Reset account lockout counter after' is set to '15 or more minute(s)'";
     }
 };
\ No newline at end of file
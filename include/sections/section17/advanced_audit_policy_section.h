@@ -1,9 +1,34 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
-#include <windows.h>
 #include "../../../include/benchmark_section.h"
+#include "../../../include/rule_program.h"
+
+/**
+ * AuditPolicyTable:
+ *   Every advanced audit subcategory of the system, read with a single
+ *   `auditpol /get /category:* /r` per run (or an offline auditpol CSV).
+ *   Lookups by subcategory GUID or name are case-insensitive. A failed
+ *   read keeps its HRESULT so each check still reports it.
+ */
+class AuditPolicyTable {
+public:
+    AuditPolicyTable(HRESULT status, std::vector<AuditSubcategorySetting> settings);
+
+    HRESULT getStatus() const { return status; }
+
+    // nullptr if the subcategory is not in the table
+    const AuditSubcategorySetting* find(const std::wstring& subcategory) const;
+    const AuditSubcategorySetting* findByGuid(const std::wstring& guid) const;
+
+private:
+    HRESULT status;
+    std::vector<AuditSubcategorySetting> settings;
+    std::unordered_map<std::wstring, size_t> byName;    // lower-cased subcategory -> index
+    std::unordered_map<std::wstring, size_t> byGuid;    // lower-cased "{GUID}" -> index
+};
 
 /**
  * AdvancedAuditPolicySection:
@@ -18,20 +43,19 @@ public:
 
     std::string getSectionName() const override { return "Advanced Audit Policy Configuration"; }
     int getSectionNumber() const override { return 17; }
+    void declareInputs(ProbeInputs& inputs) const override;
 
-    /**
-     * For each advanced audit subcategory, run `auditpol.exe /get /subcategory:"NAME" /r`,
-     * parse the output, and check if it includes the `expectedSetting` text
-     * (e.g. "Success and Failure", "Failure", or "include Success").
-     */
-    static bool CheckAuditSetting(const std::wstring& subcategory, const std::wstring& expectedSetting);
+    // Shared, read-only audit policy of the current run
+    static std::shared_ptr<const AuditPolicyTable> getAuditPolicy();
 
-private:
     /**
-     * Helper to run `auditpol.exe` with given arguments, capture stdout,
-     * and return it as a single wstring.
+     * Look up the subcategory's inclusion setting in the run's audit policy
+     * table (by its well-known GUID, then by name) and test its audit flags
+     * with the `expected` program (e.g. "value has success|failure"). Fails
+     * when the table could not be read, so the check reports an error
+     * rather than a non-compliant setting.
      */
-    static std::wstring RunAuditpol(const std::wstring& arguments);
+    static HRESULT CheckAuditSetting(const std::wstring& subcategory, const RuleProgram& expected, bool& pass);
 };
 
 // -----------------------------------------------------------------------------------
@@ -46,8 +70,8 @@ private:
 class AuditCredentialValidationCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.1.1"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.1.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Credential Validation' is set to 'Success and Failure'";
     }
 };
@@ -56,8 +80,8 @@ public:
 class AuditApplicationGroupManagementCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.2.1"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.2.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Application Group Management' is set to 'Success and Failure'";
     }
 };
@@ -66,8 +90,8 @@ public:
 class AuditSecurityGroupManagementCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.2.2"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.2.2"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Security Group Management' is set to include 'Success'";
     }
 };
@@ -76,8 +100,8 @@ public:
 class AuditUserAccountManagementCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.2.3"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.2.3"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit User Account Management' is set to 'Success and Failure'";
     }
 };
@@ -86,8 +110,8 @@ public:
 class AuditPNPActivityCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.3.1"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.3.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit PNP Activity' is set to include 'Success'";
     }
 };
@@ -96,8 +120,8 @@ public:
 class AuditProcessCreationCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.3.2"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.3.2"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Process Creation' is set to include 'Success'";
     }
 };
@@ -106,8 +130,8 @@ public:
 class AuditAccountLockoutCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.5.1"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.5.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Account Lockout' is set to include 'Failure'";
     }
 };
@@ -116,8 +140,8 @@ public:
 class AuditGroupMembershipCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.5.2"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.5.2"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Group Membership' is set to include 'Success'";
     }
 };
@@ -126,8 +150,8 @@ public:
 class AuditLogoffCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.5.3"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.5.3"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Logoff' is set to include 'Success'";
     }
 };
@@ -136,8 +160,8 @@ public:
 class AuditLogonCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.5.4"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.5.4"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Logon' is set to 'Success and Failure'";
     }
 };
@@ -146,8 +170,8 @@ public:
 class AuditOtherLogonEventsCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.5.5"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.5.5"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Other Logon/Logoff Events' is set to 'Success and Failure'";
     }
 };
@@ -156,8 +180,8 @@ public:
 class AuditSpecialLogonCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.5.6"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.5.6"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Special Logon' is set to include 'Success'";
     }
 };
@@ -166,8 +190,8 @@ public:
 class AuditDetailedFileShareCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.6.1"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.6.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Detailed File Share' is set to include 'Failure'";
     }
 };
@@ -176,8 +200,8 @@ public:
 class AuditFileShareCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.6.2"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.6.2"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit File Share' is set to 'Success and Failure'";
     }
 };
@@ -186,8 +210,8 @@ public:
 class AuditOtherObjectAccessEventsCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.6.3"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.6.3"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Other Object Access Events' is set to 'Success and Failure'";
     }
 };
@@ -196,8 +220,8 @@ public:
 class AuditRemovableStorageCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.6.4"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.6.4"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Removable Storage' is set to 'Success and Failure'";
     }
 };
@@ -206,8 +230,8 @@ public:
 class AuditPolicyChangeCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.7.1"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.7.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Audit Policy Change' is set to include 'Success'";
     }
 };
@@ -216,8 +240,8 @@ public:
 class AuditAuthenticationPolicyChangeCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.7.2"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.7.2"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Authentication Policy Change' is set to include 'Success'";
     }
 };
@@ -226,8 +250,8 @@ public:
 class AuditAuthorizationPolicyChangeCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.7.3"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.7.3"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Authorization Policy Change' is set to include 'Success'";
     }
 };
@@ -236,8 +260,8 @@ public:
 class AuditMPSSVCRuleLevelPolicyCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.7.4"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.7.4"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit MPSSVC Rule-Level Policy Change' is set to 'Success and Failure'";
     }
 };
@@ -246,8 +270,8 @@ public:
 class AuditOtherPolicyChangeEventsCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.7.5"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.7.5"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Other Policy Change Events' is set to include 'Failure'";
     }
 };
@@ -256,8 +280,8 @@ public:
 class AuditSensitivePrivilegeUseCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.8.1"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.8.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Sensitive Privilege Use' is set to 'Success and Failure'";
     }
 };
@@ -266,8 +290,8 @@ public:
 class AuditIPsecDriverCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.9.1"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.9.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit IPsec Driver' is set to 'Success and Failure'";
     }
 };
@@ -276,8 +300,8 @@ public:
 class AuditOtherSystemEventsCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.9.2"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.9.2"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Other System Events' is set to 'Success and Failure'";
     }
 };
@@ -286,8 +310,8 @@ public:
 class AuditSecurityStateChangeCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.9.3"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.9.3"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Security State Change' is set to include 'Success'";
     }
 };
@@ -296,8 +320,8 @@ public:
 class AuditSecuritySystemExtensionCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.9.4"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.9.4"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit Security System Extension' is set to include 'Success'";
     }
 };
@@ -306,8 +330,8 @@ public:
 class AuditSystemIntegrityCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "17.9.5"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "17.9.5"; }
+    std::string_view getName() const override {
         return "Ensure 'Audit System Integrity' is set to 'Success and Failure'";
     }
 };
\ No newline at end of file
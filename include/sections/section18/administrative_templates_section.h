@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "../../../include/benchmark_section.h"
+
+/**
+ * AdministrativeTemplatesSection:
+ *   Section 18 of the benchmark, "Administrative Templates (Computer)".
+ *   Every item is a machine policy from an ADMX file, so the section has
+ *   no check classes: the policy definitions Group Policy uses (key, value,
+ *   element type, what Enabled and Disabled are written as) are compiled
+ *   into an AdmxIndex, and the benchmark items are AdmxSettings over it
+ *   that become rows of one RegistryRuleTable. runChecks() evaluates the
+ *   whole section in a single pass over the policy keys in sorted order.
+ *
+ *   A policy that is not configured fails its item.
+ */
+class AdministrativeTemplatesSection : public BenchmarkSection {
+public:
+    void initialize() override;
+    std::vector<BenchmarkResult> runChecks() override;
+    std::string getSectionName() const override { return "Administrative Templates (Computer)"; }
+    int getSectionNumber() const override { return 18; }
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../../include/benchmark_section.h"
+#include "../../../include/registry_rule_table.h"
+
+/**
+ * UserPolicySnapshot:
+ *   Every user's outcome for every section 19 setting, from one pass over
+ *   the host's user profiles. `rows` of a user follow the settings' order.
+ *   A failed profile enumeration is kept in `status`.
+ */
+struct UserPolicySnapshot {
+    struct User {
+        std::string sid;
+        std::vector<BenchmarkResult> rows;
+    };
+
+    HRESULT status = S_OK;
+    std::vector<User> users;
+};
+
+/**
+ * UserAdministrativeTemplatesSection:
+ *   Section 19 of the benchmark, "Administrative Templates (User)". Its
+ *   settings are per-user ADMX policies, so they hold for the host only if
+ *   they hold in the hive of every user with a profile on it, loaded or
+ *   not. The settings become a RegistryRuleTable over hive-relative paths,
+ *   like section 18's, and each user's hive is evaluated against the whole
+ *   table in one key-ordered pass (see getUserPolicies).
+ *
+ *   Each setting is one check whose result rolls up the users' outcomes
+ *   and lists them, by SID, in BenchmarkResult::users.
+ */
+class UserAdministrativeTemplatesSection : public BenchmarkSection {
+public:
+    void initialize() override;
+    std::vector<BenchmarkResult> runChecks() override;
+    std::string getSectionName() const override { return "Administrative Templates (User)"; }
+    int getSectionNumber() const override { return 19; }
+    bool hasPerUserResults() const override { return true; }
+
+    /**
+     * Shared, read-only per-user results of the current run. Built on first
+     * use by evaluating the users' hives on a worker pool of the run's job
+     * count, one task per user: a hive is opened only by the worker that
+     * evaluates it and released when it is done, so at most one hive per
+     * worker is open. The workers run under the deadline of the check that
+     * asked; users left once it has passed are not evaluated and the check
+     * times out.
+     */
+    static std::shared_ptr<const UserPolicySnapshot> getUserPolicies();
+};
+
+/**
+ * UserPolicyCheck:
+ *   One section 19 setting. Passes when every user complies, fails when
+ *   any user does not, and is not applicable on a host without user
+ *   profiles.
+ */
+class UserPolicyCheck : public BenchmarkCheck {
+public:
+    UserPolicyCheck(const RegistryRuleTable& table, size_t row) : table(table), row(row) {}
+
+    BenchmarkResult check() override;
+    std::string_view getId() const override { return table[row].id; }
+    std::string_view getName() const override { return table[row].title; }
+
+private:
+    const RegistryRuleTable& table;
+    size_t row;
+};
@@ -1,6 +1,5 @@
 #pragma once
 #include "../../../include/benchmark_section.h"
-#include <lm.h>
 #include <vector>
 #include <string>
 
@@ -8,7 +7,7 @@ class RestrictedGroupsSection : public BenchmarkSection {
 public:
     void initialize() override;
     std::vector<BenchmarkResult> runChecks() override;
-    std::strisng getSectionName() const override { return "Restricted Groups"; }
+    std::string getSectionName() const override { return "Restricted Groups"; }
     int getSectionNumber() const override { return 4; }
 
 protected:
@@ -20,8 +19,9 @@ protected:
 class RestrictedGroupCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId() const override { return "4.1"; }
-    std::string getName() const override {
+    void declareInputs(ProbeInputs& inputs) const override;
+    std::string_view getId() const override { return "4.1"; }
+    std::string_view getName() const override {
         return "Ensure appropriate groups are configured with restricted membership";
     }
 protected:
@@ -4,10 +4,32 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
-#include <windows.h>
 #include "../../../include/benchmark_section.h"
 
+/**
+ * ServiceSnapshot:
+ *   Every installed service with its start type and current state, read
+ *   with one SCM enumeration per run. Lookups by service name are
+ *   case-insensitive. A failed enumeration keeps its HRESULT so each
+ *   check still reports it.
+ */
+class ServiceSnapshot {
+public:
+    ServiceSnapshot(HRESULT status, std::vector<ServiceEntry> services);
+
+    HRESULT getStatus() const { return status; }
+
+    // nullptr if no such service is installed
+    const ServiceEntry* find(const std::wstring& serviceName) const;
+
+private:
+    HRESULT status;
+    std::vector<ServiceEntry> services;
+    std::unordered_map<std::wstring, size_t> byName;    // lower-cased name -> index
+};
+
 // The new section class for Section 5 of your CIS Benchmark
 class SystemServicesSection : public BenchmarkSection {
 public:
@@ -15,17 +37,23 @@ public:
     std::vector<BenchmarkResult> runChecks() override;
     std::string getSectionName() const override { return "System Services"; }
     int getSectionNumber() const override { return 5; }
+    void declareInputs(ProbeInputs& inputs) const override;
+
+    // Shared, read-only service snapshot of the current run
+    static std::shared_ptr<const ServiceSnapshot> getServiceSnapshot();
 
-    // Helper to check if a service is either "Not Installed" or has "SERVICE_DISABLED"
-    static bool IsServiceDisabledOrNotInstalled(const std::wstring& serviceName);
+    // Helper to check if a service is either "Not Installed" or has "SERVICE_DISABLED".
+    // Fails, leaving `compliant` unset, if the SCM or the service's
+    // configuration could not be read.
+    static HRESULT IsServiceDisabledOrNotInstalled(const std::wstring& serviceName, bool& compliant);
 };
 
 // 5.1
 class BluetoothAudioGatewayCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.1"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Bluetooth Audio Gateway Service (BTAGService)' is set to 'Disabled'";
     }
 };
@@ -34,8 +62,8 @@ public:
 class BluetoothSupportServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.2"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.2"; }
+    std::string_view getName() const override {
         return "Ensure 'Bluetooth Support Service (bthserv)' is set to 'Disabled'";
     }
 };
@@ -44,8 +72,8 @@ public:
 class ComputerBrowserCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.3"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.3"; }
+    std::string_view getName() const override {
         return "Ensure 'Computer Browser (Browser)' is set to 'Disabled' or 'Not Installed'";
     }
 };
@@ -54,8 +82,8 @@ public:
 class DownloadedMapsManagerCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.4"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.4"; }
+    std::string_view getName() const override {
         return "Ensure 'Downloaded Maps Manager (MapsBroker)' is set to 'Disabled'";
     }
 };
@@ -64,8 +92,8 @@ public:
 class GeolocationServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.5"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.5"; }
+    std::string_view getName() const override {
         return "Ensure 'Geolocation Service (lfsvc)' is set to 'Disabled'";
     }
 };
@@ -74,8 +102,8 @@ public:
 class IISAdminServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.6"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.6"; }
+    std::string_view getName() const override {
         return "Ensure 'IIS Admin Service (IISADMIN)' is set to 'Disabled' or 'Not Installed'";
     }
 };
@@ -84,8 +112,8 @@ public:
 class InfraredMonitorServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.7"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.7"; }
+    std::string_view getName() const override {
         return "Ensure 'Infrared monitor service (irmon)' is set to 'Disabled' or 'Not Installed'";
     }
 };
@@ -94,8 +122,8 @@ public:
 class LinkLayerTopologyDiscoveryMapperCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.8"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.8"; }
+    std::string_view getName() const override {
         return "Ensure 'Link-Layer Topology Discovery Mapper (lltdsvc)' is set to 'Disabled'";
     }
 };
@@ -104,8 +132,8 @@ public:
 class LxssManagerCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.9"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.9"; }
+    std::string_view getName() const override {
         return "Ensure 'LxssManager (LxssManager)' is set to 'Disabled' or 'Not Installed'";
     }
 };
@@ -114,8 +142,8 @@ public:
 class MicrosoftFTPServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.10"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.10"; }
+    std::string_view getName() const override {
         return "Ensure 'Microsoft FTP Service (FTPSVC)' is set to 'Disabled' or 'Not Installed'";
     }
 };
@@ -124,8 +152,8 @@ public:
 class MicrosoftiSCSIInitiatorServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.11"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.11"; }
+    std::string_view getName() const override {
         return "Ensure 'Microsoft iSCSI Initiator Service (MSiSCSI)' is set to 'Disabled'";
     }
 };
@@ -134,8 +162,8 @@ public:
 class OpenSSHServerCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.12"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.12"; }
+    std::string_view getName() const override {
         return "Ensure 'OpenSSH SSH Server (sshd)' is set to 'Disabled' or 'Not Installed'";
     }
 };
@@ -144,8 +172,8 @@ public:
 class PeerNameResolutionProtocolCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.13"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.13"; }
+    std::string_view getName() const override {
         return "Ensure 'Peer Name Resolution Protocol (PNRPsvc)' is set to 'Disabled'";
     }
 };
@@ -154,8 +182,8 @@ public:
 class PeerNetworkingGroupingCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.14"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.14"; }
+    std::string_view getName() const override {
         return "Ensure 'Peer Networking Grouping (p2psvc)' is set to 'Disabled'";
     }
 };
@@ -164,8 +192,8 @@ public:
 class PeerNetworkingIdentityManagerCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.15"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.15"; }
+    std::string_view getName() const override {
         return "Ensure 'Peer Networking Identity Manager (p2pimsvc)' is set to 'Disabled'";
     }
 };
@@ -174,8 +202,8 @@ public:
 class PNRPMachineNamePublicationServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.16"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.16"; }
+    std::string_view getName() const override {
         return "Ensure 'PNRP Machine Name Publication Service (PNRPAutoReg)' is set to 'Disabled'";
     }
 };
@@ -184,8 +212,8 @@ public:
 class PrintSpoolerCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.17"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.17"; }
+    std::string_view getName() const override {
         return "Ensure 'Print Spooler (Spooler)' is set to 'Disabled'";
     }
 };
@@ -194,8 +222,8 @@ public:
 class ProblemReportsServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.18"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.18"; }
+    std::string_view getName() const override {
         return "Ensure 'Problem Reports and Solutions Control Panel Support (wercplsupport)' is set to 'Disabled'";
     }
 };
@@ -204,8 +232,8 @@ public:
 class RemoteAccessAutoConnectionManagerCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.19"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.19"; }
+    std::string_view getName() const override {
         return "Ensure 'Remote Access Auto Connection Manager (RasAuto)' is set to 'Disabled'";
     }
 };
@@ -214,8 +242,8 @@ public:
 class RemoteDesktopConfigurationCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.20"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.20"; }
+    std::string_view getName() const override {
         return "Ensure 'Remote Desktop Configuration (SessionEnv)' is set to 'Disabled'";
     }
 };
@@ -224,8 +252,8 @@ public:
 class RemoteDesktopServicesCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.21"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.21"; }
+    std::string_view getName() const override {
         return "Ensure 'Remote Desktop Services (TermService)' is set to 'Disabled'";
     }
 };
@@ -234,8 +262,8 @@ public:
 class RemoteDesktopServicesUserModePortRedirectorCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.22"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.22"; }
+    std::string_view getName() const override {
         return "Ensure 'Remote Desktop Services UserMode Port Redirector (UmRdpService)' is set to 'Disabled'";
     }
 };
@@ -244,8 +272,8 @@ public:
 class RPCLocatorCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.23"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.23"; }
+    std::string_view getName() const override {
         return "Ensure 'Remote Procedure Call (RPC) Locator (RpcLocator)' is set to 'Disabled'";
     }
 };
@@ -254,8 +282,8 @@ public:
 class RemoteRegistryCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.24"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.24"; }
+    std::string_view getName() const override {
         return "Ensure 'Remote Registry (RemoteRegistry)' is set to 'Disabled'";
     }
 };
@@ -264,8 +292,8 @@ public:
 class RoutingAndRemoteAccessCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.25"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.25"; }
+    std::string_view getName() const override {
         return "Ensure 'Routing and Remote Access (RemoteAccess)' is set to 'Disabled'";
     }
 };
@@ -274,8 +302,8 @@ public:
 class ServerServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.26"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.26"; }
+    std::string_view getName() const override {
         return "Ensure 'Server (LanmanServer)' is set to 'Disabled'";
     }
 };
@@ -284,8 +312,8 @@ public:
 class SimpleTCPIPServicesCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.27"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.27"; }
+    std::string_view getName() const override {
         return "Ensure 'Simple TCP/IP Services (simptcp)' is set to 'Disabled' or 'Not Installed'";
     }
 };
@@ -294,8 +322,8 @@ public:
 class SNMPServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.28"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.28"; }
+    std::string_view getName() const override {
         return "Ensure 'SNMP Service (SNMP)' is set to 'Disabled' or 'Not Installed'";
     }
 };
@@ -304,8 +332,8 @@ public:
 class SpecialAdministrationConsoleHelperCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.29"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.29"; }
+    std::string_view getName() const override {
         return "Ensure 'Special Administration Console Helper (sacsvr)' is set to 'Disabled' or 'Not Installed'";
     }
 };
@@ -314,8 +342,8 @@ public:
 class SSDPDiscoveryCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.30"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.30"; }
+    std::string_view getName() const override {
         return "Ensure 'SSDP Discovery (SSDPSRV)' is set to 'Disabled'";
     }
 };
@@ -324,8 +352,8 @@ public:
 class UPnPDeviceHostCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.31"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.31"; }
+    std::string_view getName() const override {
         return "Ensure 'UPnP Device Host (upnphost)' is set to 'Disabled'";
     }
 };
@@ -334,8 +362,8 @@ public:
 class WebManagementServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.32"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.32"; }
+    std::string_view getName() const override {
         return "Ensure 'Web Management Service (WMSvc)' is set to 'Disabled' or 'Not Installed'";
     }
 };
@@ -344,8 +372,8 @@ public:
 class WindowsErrorReportingServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.33"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.33"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Error Reporting Service (WerSvc)' is set to 'Disabled'";
     }
 };
@@ -354,8 +382,8 @@ public:
 class WindowsEventCollectorCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.34"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.34"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Event Collector (Wecsvc)' is set to 'Disabled'";
     }
 };
@@ -364,8 +392,8 @@ public:
 class WindowsMediaPlayerNetworkSharingServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.35"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.35"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Media Player Network Sharing Service (WMPNetworkSvc)' is set to 'Disabled' or 'Not Installed'";
     }
 };
@@ -374,8 +402,8 @@ public:
 class WindowsMobileHotspotServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.36"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.36"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Mobile Hotspot Service (icssvc)' is set to 'Disabled'";
     }
 };
@@ -384,8 +412,8 @@ public:
 class WindowsPushNotificationsSystemServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.37"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.37"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Push Notifications System Service (WpnService)' is set to 'Disabled'";
     }
 };
@@ -394,8 +422,8 @@ public:
 class WindowsPushToInstallServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.38"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.38"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows PushToInstall Service (PushToInstall)' is set to 'Disabled'";
     }
 };
@@ -404,8 +432,8 @@ public:
 class WindowsRemoteManagementCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.39"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.39"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Remote Management (WinRM)' is set to 'Disabled'";
     }
 };
@@ -414,8 +442,8 @@ public:
 class WorldWideWebPublishingServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.40"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.40"; }
+    std::string_view getName() const override {
         return "Ensure 'World Wide Web Publishing Service (W3SVC)' is set to 'Disabled' or 'Not Installed'";
     }
 };
@@ -424,8 +452,8 @@ public:
 class XboxAccessoryManagementServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.41"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.41"; }
+    std::string_view getName() const override {
         return "Ensure 'Xbox Accessory Management Service (XboxGipSvc)' is set to 'Disabled'";
     }
 };
@@ -434,8 +462,8 @@ public:
 class XboxLiveAuthManagerCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.42"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.42"; }
+    std::string_view getName() const override {
         return "Ensure 'Xbox Live Auth Manager (XblAuthManager)' is set to 'Disabled'";
     }
 };
@@ -444,8 +472,8 @@ public:
 class XboxLiveGameSaveCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.43"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.43"; }
+    std::string_view getName() const override {
         return "Ensure 'Xbox Live Game Save (XblGameSave)' is set to 'Disabled'";
     }
 };
@@ -454,8 +482,8 @@ public:
 class XboxLiveNetworkingServiceCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "5.44"; }
-    std::string getName() const override {
+    std::string_view getId()   const override { return "5.44"; }
+    std::string_view getName() const override {
         return "Ensure 'Xbox Live Networking Service (XboxNetApiSvc)' is set to 'Disabled'";
     }
 };
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <windows.h>
 #include <string>
 #include <vector>
 #include <memory>               // for std::unique_ptr
@@ -29,26 +28,35 @@ public:
     int getSectionNumber() const override       { return 9; }
 
     /**
-     * Helper function to read from:
+     * Scalar rule for a check that wants the DWORD <valueName> under
      *   HKLM\SOFTWARE\Policies\Microsoft\WindowsFirewall\<profileKey>
-     * and compare the DWORD found in <valueName> to expectedValue.
+     * to equal expectedValue. A missing value fails the check.
      */
-    static bool CheckFirewallPolicyDword(
+    static ScalarRule FirewallPolicyDwordRule(
         const std::wstring& profileKey,
         const std::wstring& valueName,
         DWORD expectedValue
     );
 
-private:
     /**
-     * Helper to run a registry query for:
-     *   HKLM\SOFTWARE\Policies\Microsoft\WindowsFirewall\<profileKey>
+     * Declares the value a FirewallPolicyDwordRule will read, so the
+     * engine can prefetch it with the rest of the profile key.
      */
-    static bool ReadFirewallRegDword(
+    static void DeclareFirewallPolicyDword(
+        ProbeInputs& inputs,
         const std::wstring& profileKey,
-        const std::wstring& valueName,
-        DWORD& outValue
+        const std::wstring& valueName
     );
+
+private:
+    // HKLM-relative path of SOFTWARE\Policies\Microsoft\WindowsFirewall\<profileKey>
+    static std::wstring PolicyKeyPath(const std::wstring& profileKey);
+
+    /**
+     * Scalar rule reader: the REG_DWORD rule.valueName under rule.path,
+     * from the run's registry cache.
+     */
+    static HRESULT ReadFirewallRegDword(const ScalarRule& rule, DWORD& outValue);
 };
 
 /* --------------------------------------------------------------------------
@@ -66,8 +74,11 @@ private:
 class FirewallDomainStateCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "9.1.1"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    void declareInputs(ProbeInputs& inputs) const override;
+    std::string_view getId()   const override { return "9.1.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Firewall: Domain: Firewall state' is set to 'On (recommended)'";
     }
 };
@@ -76,8 +87,11 @@ public:
 class FirewallDomainInboundActionCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "9.1.2"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    void declareInputs(ProbeInputs& inputs) const override;
+    std::string_view getId()   const override { return "9.1.2"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Firewall: Domain: Inbound connections' is set to 'Block (default)'";
     }
 };
@@ -86,8 +100,11 @@ public:
 class FirewallDomainNotifyCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "9.1.3"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    void declareInputs(ProbeInputs& inputs) const override;
+    std::string_view getId()   const override { return "9.1.3"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Firewall: Domain: Display a notification' is set to 'No'";
     }
 };
@@ -96,8 +113,11 @@ public:
 class FirewallPrivateStateCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "9.2.1"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    void declareInputs(ProbeInputs& inputs) const override;
+    std::string_view getId()   const override { return "9.2.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Firewall: Private: Firewall state' is set to 'On (recommended)'";
     }
 };
@@ -106,8 +126,11 @@ public:
 class FirewallPrivateInboundActionCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "9.2.2"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    void declareInputs(ProbeInputs& inputs) const override;
+    std::string_view getId()   const override { return "9.2.2"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Firewall: Private: Inbound connections' is set to 'Block (default)'";
     }
 };
@@ -116,8 +139,11 @@ public:
 class FirewallPublicStateCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "9.3.1"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    void declareInputs(ProbeInputs& inputs) const override;
+    std::string_view getId()   const override { return "9.3.1"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Firewall: Public: Firewall state' is set to 'On (recommended)'";
     }
 };
@@ -126,8 +152,11 @@ public:
 class FirewallPublicInboundActionCheck : public BenchmarkCheck {
 public:
     BenchmarkResult check() override;
-    std::string getId()   const override { return "9.3.2"; }
-    std::string getName() const override {
+    const ScalarRule* getScalarRule() const override;
+    std::string describeScalar(CheckStatus status, DWORD value) const override;
+    void declareInputs(ProbeInputs& inputs) const override;
+    std::string_view getId()   const override { return "9.3.2"; }
+    std::string_view getName() const override {
         return "Ensure 'Windows Firewall: Public: Inbound connections' is set to 'Block (default)'";
     }
 };
\ No newline at end of file
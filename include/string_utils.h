@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <cwctype>
+
+// Case-insensitive helpers for Windows names (registry paths, services,
+// accounts), which compare without regard to case.
+
+inline std::wstring toLowerCopy(const std::wstring& s) {
+    std::wstring lower(s);
+    for (auto& ch : lower) {
+        ch = static_cast<wchar_t>(towlower(ch));
+    }
+    return lower;
+}
+
+inline bool equalsIgnoreCase(const std::wstring& a, const std::wstring& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (towlower(a[i]) != towlower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool containsIgnoreCase(const std::wstring& haystack, const std::wstring& needle) {
+    return toLowerCopy(haystack).find(toLowerCopy(needle)) != std::wstring::npos;
+}
+
+// Narrows a wide string holding ASCII text (IDs, names) for console output.
+inline std::string narrow(const std::wstring& s) {
+    std::string out;
+    out.reserve(s.size());
+    for (wchar_t ch : s) {
+        out.push_back(ch < 0x80 ? static_cast<char>(ch) : '?');
+    }
+    return out;
+}
\ No newline at end of file
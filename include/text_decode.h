@@ -0,0 +1,13 @@
+#pragma once
+#include "platform.h"
+#include <string>
+
+/**
+ * Decodes a text file captured from a Windows host (exports, templates,
+ * CSV) by its byte order mark: UTF-16LE or UTF-8, and UTF-8 when there is
+ * none. Malformed sequences become U+FFFD rather than failing the file.
+ */
+std::wstring decodeText(const BYTE* data, size_t size);
+
+// UTF-8 encoding of `text`, for the text files this tool writes itself.
+std::string encodeUtf8(const std::wstring& text);
\ No newline at end of file
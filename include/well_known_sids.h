@@ -0,0 +1,79 @@
+#pragma once
+#include <cwctype>
+#include <string_view>
+
+/**
+ * Built-in principals whose SIDs are the same on every Windows machine.
+ * Names are the English account names LookupAccountNameW accepts, with or
+ * without their "BUILTIN\" / "NT AUTHORITY\" prefix.
+ */
+struct WellKnownSid {
+    std::wstring_view name;
+    std::wstring_view sid;
+};
+
+inline constexpr WellKnownSid kWellKnownSids[] = {
+    { L"Everyone",                                          L"S-1-1-0" },
+    { L"NETWORK",                                           L"S-1-5-2" },
+    { L"BATCH",                                             L"S-1-5-3" },
+    { L"INTERACTIVE",                                       L"S-1-5-4" },
+    { L"SERVICE",                                           L"S-1-5-6" },
+    { L"ANONYMOUS LOGON",                                   L"S-1-5-7" },
+    { L"ENTERPRISE DOMAIN CONTROLLERS",                     L"S-1-5-9" },
+    { L"Authenticated Users",                               L"S-1-5-11" },
+    { L"SYSTEM",                                            L"S-1-5-18" },
+    { L"LOCAL SYSTEM",                                      L"S-1-5-18" },
+    { L"LOCAL SERVICE",                                     L"S-1-5-19" },
+    { L"NETWORK SERVICE",                                   L"S-1-5-20" },
+    { L"Administrators",                                    L"S-1-5-32-544" },
+    { L"Users",                                             L"S-1-5-32-545" },
+    { L"Guests",                                            L"S-1-5-32-546" },
+    { L"Power Users",                                       L"S-1-5-32-547" },
+    { L"Account Operators",                                 L"S-1-5-32-548" },
+    { L"Server Operators",                                  L"S-1-5-32-549" },
+    { L"Print Operators",                                   L"S-1-5-32-550" },
+    { L"Backup Operators",                                  L"S-1-5-32-551" },
+    { L"Replicator",                                        L"S-1-5-32-552" },
+    { L"Remote Desktop Users",                              L"S-1-5-32-555" },
+    { L"Network Configuration Operators",                   L"S-1-5-32-556" },
+    { L"Performance Monitor Users",                         L"S-1-5-32-558" },
+    { L"Performance Log Users",                             L"S-1-5-32-559" },
+    { L"Distributed COM Users",                             L"S-1-5-32-562" },
+    { L"IIS_IUSRS",                                         L"S-1-5-32-568" },
+    { L"Cryptographic Operators",                           L"S-1-5-32-569" },
+    { L"Event Log Readers",                                 L"S-1-5-32-573" },
+    { L"Hyper-V Administrators",                            L"S-1-5-32-578" },
+    { L"Remote Management Users",                           L"S-1-5-32-580" },
+    { L"Local account",                                     L"S-1-5-113" },
+    { L"Local account and member of Administrators group",  L"S-1-5-114" },
+};
+
+inline bool wellKnownNameEquals(std::wstring_view a, std::wstring_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (towlower(a[i]) != towlower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// SID string of a built-in principal, or an empty view if accountName is not one
+inline std::wstring_view findWellKnownSid(std::wstring_view accountName) {
+    for (std::wstring_view authority : { std::wstring_view(L"BUILTIN\\"), std::wstring_view(L"NT AUTHORITY\\") }) {
+        if (accountName.size() > authority.size() &&
+            wellKnownNameEquals(accountName.substr(0, authority.size()), authority))
+        {
+            accountName.remove_prefix(authority.size());
+            break;
+        }
+    }
+    for (const auto& entry : kWellKnownSids) {
+        if (wellKnownNameEquals(entry.name, accountName)) {
+            return entry.sid;
+        }
+    }
+    return std::wstring_view();
+}
\ No newline at end of file
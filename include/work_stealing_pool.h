@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+
+/**
+ * WorkStealingPool:
+ *   Runs a fixed set of independent tasks on a group of worker threads.
+ *   Every worker owns a deque seeded with a contiguous share of the task
+ *   indices. A worker pops from the back of its own deque and, once that
+ *   is empty, steals from the front of another worker's deque, so a
+ *   long tail of slow tasks in one share is spread across all threads.
+ */
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned int workerCount);
+
+    /**
+     * Calls task(i) for every i in [0, taskCount) and blocks until all
+     * of them have finished. The first exception thrown by a task is
+     * rethrown on the calling thread after the workers have joined.
+     */
+    void run(size_t taskCount, const std::function<void(size_t)>& task);
+
+private:
+    unsigned int workerCount;
+};
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "include/admx_index.h"
+#include <algorithm>
+
+AdmxIndex::AdmxIndex(const AdmxPolicy* policies, size_t count)
+    : policies(policies), count(count), byName(count) {
+    for (size_t i = 0; i < count; i++) {
+        byName[i] = &policies[i];
+    }
+    std::sort(byName.begin(), byName.end(), [](const AdmxPolicy* a, const AdmxPolicy* b) {
+        return a->name < b->name;
+    });
+}
+
+const AdmxPolicy* AdmxIndex::find(std::string_view name) const {
+    auto it = std::lower_bound(byName.begin(), byName.end(), name, [](const AdmxPolicy* policy, std::string_view name) {
+        return policy->name < name;
+    });
+    return (it != byName.end() && (*it)->name == name) ? *it : nullptr;
+}
+
+AdmxRuleSet::AdmxRuleSet(const AdmxIndex& index, const AdmxSetting* settings, size_t count)
+    : rows(compile(index, settings, count)), table(rows.data(), rows.size()) {}
+
+const char* AdmxRuleSet::keep(std::string value) {
+    text.push_back(std::move(value));
+    return text.back().c_str();
+}
+
+std::vector<RegistryRule> AdmxRuleSet::compile(const AdmxIndex& index, const AdmxSetting* settings, size_t count) {
+    std::vector<RegistryRule> compiled;
+    compiled.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const AdmxSetting& setting = settings[i];
+        const AdmxPolicy* policy = index.find(setting.policy);
+        if (!policy) {
+            const char* reason = keep("unknown ADMX policy '" + std::string(setting.policy) + "'");
+            compiled.push_back({ setting.id, setting.title, L"", L"", REG_DWORD, reason,
+                                 reason, reason, reason, CheckStatus::Error });
+            continue;
+        }
+
+        std::string name(policy->displayName);
+        std::string expression;
+        const char* passDetails = nullptr;
+        const char* failDetails = nullptr;
+        bool enabled = setting.requirement == "enabled";
+        if (policy->element == AdmxElement::Boolean && (enabled || setting.requirement == "disabled")) {
+            // The state is whatever the ADMX writes for it, which is 0 as
+            // often as 1 (a "Turn off ..." policy enabled is often 0)
+            const char* state = enabled ? "Enabled" : "Disabled";
+            expression = "value == " + std::to_string(enabled ? policy->enabledValue : policy->disabledValue);
+            passDetails = keep("'" + name + "' is " + state);
+            failDetails = keep("'" + name + "' is not " + state);
+        } else {
+            expression.assign(setting.requirement);
+            passDetails = keep("'" + name + "' is set to {}");
+            failDetails = keep("'" + name + "' is not configured to satisfy '" + expression + "'");
+        }
+
+        compiled.push_back({ setting.id, setting.title, policy->key, policy->valueName, policy->type,
+                             keep(std::move(expression)), keep("Failed to read '" + name + "'"),
+                             passDetails, failDetails, CheckStatus::Fail });
+    }
+    return compiled;
+}
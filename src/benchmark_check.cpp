@@ -0,0 +1,83 @@
+#include "include/benchmark_check.h"
+#include "include/run_context.h"
+#include <iomanip>
+#include <sstream>
+
+// Utility function implementations
+#ifdef _WIN32
+std::string BenchmarkCheck::getLastErrorAsString() {
+    DWORD errorMessageID = ::GetLastError();
+    if (errorMessageID == 0) {
+        return "No error message available";
+    }
+    
+    LPSTR messageBuffer = nullptr;
+    size_t size = FormatMessageA(
+        FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+        NULL,
+        errorMessageID,
+        MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+        (LPSTR)&messageBuffer,
+        0,
+        NULL
+    );
+    
+    std::string message(messageBuffer, size);
+    LocalFree(messageBuffer);
+    
+    std::ostringstream oss;
+    oss << "Error (0x" << std::hex << std::setw(8) << std::setfill('0') << errorMessageID << "): " << message;
+    return oss.str();
+}
+
+std::string BenchmarkCheck::getNetApiErrorAsString(NET_API_STATUS nStatus) {
+    HMODULE hModule = NULL;
+    LPSTR messageBuffer = nullptr;
+    
+    FormatMessageA(
+        FORMAT_MESSAGE_ALLOCATE_BUFFER | 
+        FORMAT_MESSAGE_FROM_SYSTEM |
+        FORMAT_MESSAGE_IGNORE_INSERTS,
+        NULL,
+        nStatus,
+        MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+        (LPSTR)&messageBuffer,
+        0,
+        NULL
+    );
+    
+    std::string message = messageBuffer ? messageBuffer : "Unknown error";
+    LocalFree(messageBuffer);
+    
+    std::ostringstream oss;
+    oss << "NetApi Error (0x" << std::hex << std::setw(8) << std::setfill('0') << nStatus << "): " << message;
+    return oss.str();
+}
+#else
+std::string BenchmarkCheck::getLastErrorAsString() {
+    return "No error message available";
+}
+
+std::string BenchmarkCheck::getNetApiErrorAsString(NET_API_STATUS nStatus) {
+    std::ostringstream oss;
+    oss << "NetApi Error (0x" << std::hex << std::setw(8) << std::setfill('0') << nStatus << ")";
+    return oss.str();
+}
+#endif
+
+// Registry access implementation
+HRESULT BenchmarkCheck::getRegistryDwordValue(const std::wstring& path, const std::wstring& value, DWORD& data) {
+    return RunContext::current().getRegistry().getDword(path, value, data);
+}
+
+
+// Evaluates getScalarRule() for the current run, one host at a time
+BenchmarkResult BenchmarkCheck::checkScalar() const {
+    const ScalarRule& rule = *getScalarRule();
+    DWORD value = 0;
+    CheckStatus status = rule.missingStatus;
+    if (SUCCEEDED(rule.read(rule, value))) {
+        status = rule.passes(value) ? CheckStatus::Pass : CheckStatus::Fail;
+    }
+    return BenchmarkResult(getId(), getName(), status, describeScalar(status, value));
+}
\ No newline at end of file
@@ -1,20 +1,239 @@
 #include "include/benchmark_engine.h"
+#include "include/work_stealing_pool.h"
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <optional>
+
+namespace {
+const char* statusLabel(CheckStatus status) {
+    switch (status) {
+        case CheckStatus::Pass:
+            return "PASS";
+        case CheckStatus::Fail:
+            return "FAIL";
+        case CheckStatus::Error:
+            return "ERROR";
+        case CheckStatus::NotApplicable:
+            return "N/A";
+    }
+    return "";
+}
+}
 
 void BenchmarkEngine::registerSection(std::unique_ptr<BenchmarkSection> section) {
     section->initialize();
+    section->declareInputs(declaredInputs);
+    perUserResults = perUserResults || section->hasPerUserResults();
+    for (BenchmarkCheck* check : section->getChecks()) {
+        check->declareInputs(declaredInputs);
+        checks.push_back(check);
+        sectionOfCheck.push_back(sections.size());
+    }
     sections.push_back(std::move(section));
 }
 
+void BenchmarkEngine::setProbe(std::shared_ptr<SystemProbe> probe) {
+    this->probe = std::move(probe);
+}
+
+void BenchmarkEngine::setJobs(unsigned int jobs) {
+    this->jobs = jobs > 0 ? jobs : 1;
+}
+
+void BenchmarkEngine::setCheckTimeout(std::chrono::milliseconds timeout) {
+    checkTimeout = timeout;
+}
+
+void BenchmarkEngine::setSectionTimeout(std::chrono::milliseconds timeout) {
+    sectionTimeout = timeout;
+}
+
+void BenchmarkEngine::setTiming(bool enabled) {
+    timing = enabled;
+}
+
 void BenchmarkEngine::runChecks() {
+    // Everything the checks of this run share: the probe and the snapshots
+    // sections build from it
+    RunContext run(probe);
+    run.setJobs(jobs);
+    runStart = CheckContext::Clock::now();
+    prefetchTiming = prefetchInputs(run, runStart);
+
+    // Time budgets and timings are taken per check, so they always go through
+    // the scheduler; with one job it simply runs the checks inline, in order.
+    if (jobs > 1 || checkTimeout.count() > 0 || sectionTimeout.count() > 0 || timing) {
+        runScheduledChecks(run);
+        return;
+    }
+
+    // Serial fallback: let each section run its own checks in order.
+    CheckContext context(CheckContext::Clock::time_point::max(), &run);
+    CheckContext::Scope scope(context);
     for (const auto& section : sections) {
         auto sectionResults = section->runChecks();
         results.insert(results.end(), sectionResults.begin(), sectionResults.end());
     }
 }
 
+HostCollection BenchmarkEngine::collect() const {
+    return Collector::collect(declaredInputs, *probe);
+}
+
+// Fetches what every registered check declared it will read in bulk, so
+// registry keys are opened once per run rather than once per check. The reads
+// happen before any check runs, so they are timed and counted here, for the
+// run, under a context of their own; checks served from the cache count none.
+CheckTiming BenchmarkEngine::prefetchInputs(RunContext& run, CheckContext::Clock::time_point origin) const {
+    auto sinceOrigin = [origin](CheckContext::Clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(t - origin);
+    };
+
+    CheckContext context(CheckContext::Clock::time_point::max(), &run);
+    CheckContext::Scope scope(context);
+    CheckTiming prefetched;
+    prefetched.start = sinceOrigin(CheckContext::Clock::now());
+    run.getRegistry().prefetch(declaredInputs);
+    prefetched.end = sinceOrigin(CheckContext::Clock::now());
+    prefetched.calls = context.getProbeCalls();
+    return prefetched;
+}
+
+// A section's time budget starts when its first check starts, which under the
+// pool may be some time after the run itself began.
+struct BenchmarkEngine::SectionBudget {
+    std::mutex mutex;
+    bool started = false;
+    CheckContext::Clock::time_point deadline = CheckContext::Clock::time_point::max();
+};
+
+std::vector<BenchmarkResult> BenchmarkEngine::evaluate(RunContext& run, const std::vector<bool>* selected) const {
+    CheckContext::Clock::time_point origin = CheckContext::Clock::now();
+    prefetchInputs(run, origin);
+
+    std::vector<BenchmarkResult> evaluated;
+    evaluated.reserve(checks.size());
+    size_t index = 0;
+    for (const auto& section : sections) {
+        SectionBudget budget;
+        for (BenchmarkCheck* check : section->getChecks()) {
+            if (selected && !(*selected)[index++]) {
+                continue;
+            }
+            evaluated.push_back(runCheck(*check, budget, run, origin));
+        }
+    }
+    return evaluated;
+}
+
+// Runs every check of every section, as flattened at registration, on a
+// work-stealing pool, so a section with many slow checks is spread across all
+// workers instead of pinning one thread. Each check writes into its own slot,
+// and the slots are read back in registration order so the output matches a
+// serial run.
+void BenchmarkEngine::runScheduledChecks(RunContext& run) {
+    std::vector<SectionBudget> budgets(sections.size());
+
+    std::vector<std::optional<BenchmarkResult>> slots(checks.size());
+    auto task = [&](size_t i) {
+        slots[i].emplace(runCheck(*checks[i], budgets[sectionOfCheck[i]], run, runStart));
+    };
+
+    if (jobs > 1) {
+        WorkStealingPool pool(jobs);
+        pool.run(checks.size(), task);
+    } else {
+        for (size_t i = 0; i < checks.size(); i++) {
+            task(i);
+        }
+    }
+
+    sectionTimings.assign(sections.size(), SectionTiming());
+    for (size_t s = 0; s < sections.size(); s++) {
+        sectionTimings[s].sectionNumber = sections[s]->getSectionNumber();
+        sectionTimings[s].sectionName = sections[s]->getSectionName();
+    }
+
+    results.reserve(results.size() + slots.size());
+    for (size_t i = 0; i < slots.size(); i++) {
+        const CheckTiming& checkTiming = slots[i]->timing;
+        SectionTiming& sectionTiming = sectionTimings[sectionOfCheck[i]];
+        sectionTiming.start = std::min(sectionTiming.start, checkTiming.start);
+        sectionTiming.end = std::max(sectionTiming.end, checkTiming.end);
+        sectionTiming.checkDurations.push_back(checkTiming.duration());
+
+        results.push_back(std::move(*slots[i]));
+    }
+}
+
+// Runs one check under a CheckContext whose deadline is the earlier of the
+// check's own budget and what is left of its section's budget. A check whose
+// work was cut short by the deadline is reported as an error; one that still
+// finished with a real result keeps it, with the overrun noted. Either way the
+// rest of the run carries on. Timings are relative to `origin`.
+BenchmarkResult BenchmarkEngine::runCheck(BenchmarkCheck& check, SectionBudget& budget, RunContext& run,
+                                          CheckContext::Clock::time_point origin) const {
+    using Clock = CheckContext::Clock;
+    Clock::time_point start = Clock::now();
+    Clock::time_point sectionDeadline;
+    {
+        std::lock_guard<std::mutex> lock(budget.mutex);
+        if (!budget.started) {
+            budget.started = true;
+            if (sectionTimeout.count() > 0) {
+                budget.deadline = start + sectionTimeout;
+            }
+        }
+        sectionDeadline = budget.deadline;
+    }
+
+    auto sinceRunStart = [origin](Clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(t - origin);
+    };
+
+    if (start >= sectionDeadline) {
+        BenchmarkResult skipped(check.getId(), check.getName(), CheckStatus::Error,
+                                "Not run: section time budget of " +
+                                std::to_string(sectionTimeout.count()) + " ms exhausted");
+        skipped.timing.start = skipped.timing.end = sinceRunStart(start);
+        return skipped;
+    }
+
+    Clock::time_point deadline = sectionDeadline;
+    if (checkTimeout.count() > 0 && start + checkTimeout < deadline) {
+        deadline = start + checkTimeout;
+    }
+
+    CheckContext context(deadline, &run);
+    CheckContext::Scope scope(context);
+    BenchmarkResult result = check.check();
+    result.timing.start = sinceRunStart(start);
+    result.timing.end = sinceRunStart(Clock::now());
+    result.timing.calls = context.getProbeCalls();
+
+    if (context.wasAborted()) {
+        result.status = CheckStatus::Error;
+        if (deadline == sectionDeadline) {
+            result.details = "Timed out: section time budget of " +
+                             std::to_string(sectionTimeout.count()) + " ms exhausted";
+        } else {
+            result.details = "Timed out after " + std::to_string(checkTimeout.count()) + " ms";
+        }
+    } else if (context.isCancelled()) {
+        if (deadline == sectionDeadline) {
+            result.details += " (finished after the section time budget of " +
+                              std::to_string(sectionTimeout.count()) + " ms)";
+        } else {
+            result.details += " (finished after the " + std::to_string(checkTimeout.count()) +
+                              " ms check timeout)";
+        }
+    }
+    return result;
+}
+
 void BenchmarkEngine::printResults() const {
     int passed = 0, failed = 0, error = 0, na = 0;
 
@@ -44,7 +263,11 @@ void BenchmarkEngine::printResults() const {
                 break;
         }
         
-        std::cout << "\nDetails: " << result.details << "\n\n";
+        std::cout << "\nDetails: " << result.details << "\n";
+        for (const auto& user : result.users) {
+            std::cout << "  " << user.sid << ": " << statusLabel(user.status) << " - " << user.details << "\n";
+        }
+        std::cout << "\n";
     }
     
     std::cout << std::string(80, '-') << "\n";
@@ -53,6 +276,51 @@ void BenchmarkEngine::printResults() const {
     std::cout << "Failed: " << failed << "\n";
     std::cout << "Errors: " << error << "\n";
     std::cout << "Not Applicable: " << na << "\n";
+
+    if (timing) {
+        printSectionTimings();
+    }
+}
+
+// Per-section check latency: min / p50 / p95 / max (nearest rank), plus the
+// wall-clock span of the whole section.
+void BenchmarkEngine::printSectionTimings() const {
+    auto ms = [](std::chrono::microseconds us) { return us.count() / 1000.0; };
+
+    std::cout << "\nSection timings (ms):\n";
+    std::cout << std::left << std::setw(6) << "Sect" << std::right
+              << std::setw(8) << "Checks" << std::setw(11) << "Wall"
+              << std::setw(11) << "Min" << std::setw(11) << "P50"
+              << std::setw(11) << "P95" << std::setw(11) << "Max" << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (const auto& section : sectionTimings) {
+        std::vector<std::chrono::microseconds> durations = section.checkDurations;
+        if (durations.empty()) {
+            continue;
+        }
+        std::sort(durations.begin(), durations.end());
+        auto percentile = [&durations](size_t p) {
+            size_t rank = (p * durations.size() + 99) / 100;
+            return durations[rank > 0 ? rank - 1 : 0];
+        };
+
+        std::cout << std::left << std::setw(6) << section.sectionNumber << std::right
+                  << std::setw(8) << durations.size()
+                  << std::setw(11) << ms(section.end - section.start)
+                  << std::setw(11) << ms(durations.front())
+                  << std::setw(11) << ms(percentile(50))
+                  << std::setw(11) << ms(percentile(95))
+                  << std::setw(11) << ms(durations.back()) << "  "
+                  << section.sectionName << "\n";
+    }
+
+    // Declared registry values are read once, up front, and not counted
+    // against the checks that use them
+    std::cout << "\nPrefetch of declared inputs: " << ms(prefetchTiming.duration()) << " ms, "
+              << prefetchTiming.calls.registryOpens << " registry open(s)"
+              << " (not included in per-check probe call counts)\n";
+    std::cout << std::defaultfloat;
 }
 
 void BenchmarkEngine::exportResults(const std::string& filename) const {
@@ -62,31 +330,50 @@ void BenchmarkEngine::exportResults(const std::string& filename) const {
         return;
     }
 
-    // Write CSV header
-    file << "Check ID,Name,Status,Details\n";
-
-    // Write results
+    writeCsvHeader(file);
     for (const auto& result : results) {
-        file << result.checkId << ",";
-        file << "\"" << result.checkName << "\",";
-        
-        switch (result.status) {
-            case CheckStatus::Pass:
-                file << "PASS,";
-                break;
-            case CheckStatus::Fail:
-                file << "FAIL,";
-                break;
-            case CheckStatus::Error:
-                file << "ERROR,";
-                break;
-            case CheckStatus::NotApplicable:
-                file << "N/A,";
-                break;
-        }
-        
-        file << "\"" << result.details << "\"\n";
+        writeCsvRow(file, result);
     }
 
     file.close();
+}
+
+
+void BenchmarkEngine::writeCsvHeader(std::ostream& out) const {
+    out << "Check ID,Name,Status,Details";
+    if (perUserResults) {
+        out << ",User SID";
+    }
+    if (timing) {
+        out << ",Start (us),End (us),Duration (us),Registry Opens,Process Spawns,NetAPI Calls";
+    }
+    out << "\n";
+}
+
+void BenchmarkEngine::writeCsvRow(std::ostream& out, const BenchmarkResult& result,
+                                  const std::string& prefix) const {
+    out << prefix << result.checkId << ",";
+    out << "\"" << result.checkName << "\",";
+    out << statusLabel(result.status) << ",";
+    out << "\"" << result.details << "\"";
+    if (perUserResults) {
+        out << ",";
+    }
+    if (timing) {
+        const CheckTiming& t = result.timing;
+        out << "," << t.start.count() << "," << t.end.count() << "," << t.duration().count()
+            << "," << t.calls.registryOpens << "," << t.calls.processSpawns
+            << "," << t.calls.netApiCalls;
+    }
+    out << "\n";
+
+    // Users were evaluated together by the check, so their rows have no timing
+    for (const auto& user : result.users) {
+        out << prefix << result.checkId << ",\"" << result.checkName << "\"," << statusLabel(user.status)
+            << ",\"" << user.details << "\"," << user.sid;
+        if (timing) {
+            out << ",,,,,,";
+        }
+        out << "\n";
+    }
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "include/check_context.h"
+
+namespace {
+thread_local CheckContext* currentContext = nullptr;
+}
+
+CheckContext::CheckContext(Clock::time_point deadline, RunContext* run)
+    : deadline(deadline), run(run) {}
+
+CheckContext* CheckContext::current() {
+    return currentContext;
+}
+
+bool CheckContext::isCancelled() const {
+    return cancelled.load() || Clock::now() >= deadline;
+}
+
+void CheckContext::cancel() {
+    cancelled.store(true);
+}
+
+void CheckContext::markAborted() {
+    aborted.store(true);
+}
+
+void CheckContext::recordProbeCall(ProbeCall call) {
+    CheckContext* context = currentContext;
+    if (!context) {
+        return;
+    }
+    switch (call) {
+        case ProbeCall::RegistryOpen:
+            context->probeCalls.registryOpens++;
+            break;
+        case ProbeCall::ProcessSpawn:
+            context->probeCalls.processSpawns++;
+            break;
+        case ProbeCall::NetApi:
+            context->probeCalls.netApiCalls++;
+            break;
+    }
+}
+
+void CheckContext::addProbeCalls(const ProbeCallCounts& calls) {
+    probeCalls.registryOpens += calls.registryOpens;
+    probeCalls.processSpawns += calls.processSpawns;
+    probeCalls.netApiCalls += calls.netApiCalls;
+}
+
+CheckContext::Scope::Scope(CheckContext& context)
+    : previous(currentContext) {
+    currentContext = &context;
+}
+
+CheckContext::Scope::~Scope() {
+    currentContext = previous;
+}
\ No newline at end of file
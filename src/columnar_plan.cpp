@@ -0,0 +1,86 @@
+#include "include/columnar_plan.h"
+#include "include/check_context.h"
+#include "include/scalar_kernels.h"
+#include "include/string_utils.h"
+
+ColumnarPlan::ColumnarPlan(const BenchmarkEngine& engine) {
+    for (BenchmarkCheck* check : engine.getChecks()) {
+        checks.push_back(check);
+        const ScalarRule* rule = check->getScalarRule();
+        if (!rule) {
+            ruleOfCheck.push_back(-1);
+            continue;
+        }
+
+        size_t column = 0;
+        while (column < columns.size() &&
+               !(columns[column]->read == rule->read &&
+                 equalsIgnoreCase(columns[column]->path, rule->path) &&
+                 equalsIgnoreCase(columns[column]->valueName, rule->valueName)))
+        {
+            column++;
+        }
+        if (column == columns.size()) {
+            columns.push_back(rule);
+        }
+
+        ruleOfCheck.push_back(static_cast<int>(rules.size()));
+        rules.push_back(Rule{ check, rule, column });
+    }
+}
+
+ColumnarPlan::Batch ColumnarPlan::newBatch(size_t hostCount) const {
+    Batch batch;
+    batch.hostCount = hostCount;
+    batch.values.assign(columns.size(), std::vector<uint32_t>(hostCount, 0));
+    batch.missing.assign(columns.size(), std::vector<uint64_t>(ScalarKernels::bitmapWords(hostCount), 0));
+    batch.passed.assign(rules.size(), std::vector<uint64_t>(ScalarKernels::bitmapWords(hostCount), 0));
+    return batch;
+}
+
+void ColumnarPlan::gather(RunContext& run, Batch& batch, size_t host) const {
+    // Readers resolve the run through the current CheckContext, as checks do
+    CheckContext context(CheckContext::Clock::time_point::max(), &run);
+    CheckContext::Scope scope(context);
+
+    for (size_t c = 0; c < columns.size(); c++) {
+        DWORD value = 0;
+        if (SUCCEEDED(columns[c]->read(*columns[c], value))) {
+            batch.values[c][host] = static_cast<uint32_t>(value);
+        } else {
+            batch.missing[c][host / 64] |= uint64_t(1) << (host % 64);
+        }
+    }
+}
+
+void ColumnarPlan::evaluate(Batch& batch) const {
+    for (size_t r = 0; r < rules.size(); r++) {
+        const ScalarRule& rule = *rules[r].rule;
+        if (rule.program) {
+            rule.program->evaluateBatch(batch.values[rules[r].column].data(), batch.hostCount,
+                                        batch.passed[r].data());
+            continue;
+        }
+        ScalarKernels::inRange(batch.values[rules[r].column].data(), batch.hostCount,
+                               static_cast<uint32_t>(rule.low), static_cast<uint32_t>(rule.high),
+                               batch.passed[r].data());
+    }
+}
+
+BenchmarkResult ColumnarPlan::result(const Batch& batch, size_t checkIndex, size_t host) const {
+    const Rule& rule = rules[ruleOfCheck[checkIndex]];
+    size_t word = host / 64;
+    uint64_t bit = uint64_t(1) << (host % 64);
+
+    CheckStatus status;
+    if (batch.missing[rule.column][word] & bit) {
+        status = rule.rule->missingStatus;
+    } else if (batch.passed[ruleOfCheck[checkIndex]][word] & bit) {
+        status = CheckStatus::Pass;
+    } else {
+        status = CheckStatus::Fail;
+    }
+    DWORD value = batch.values[rule.column][host];
+    return BenchmarkResult(rule.check->getId(), rule.check->getName(), status,
+                           rule.check->describeScalar(status, value));
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "include/fleet_runner.h"
+#include "include/columnar_plan.h"
+#include "include/probes/snapshot_bundle.h"
+#include "include/probes/subtree_store.h"
+#include "include/work_stealing_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <shared_mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+// Hosts per columnar batch: 4 KB of values per rule input
+constexpr size_t kMaxBatchHosts = 1024;
+
+// Results of the per-host checks, keyed by the check and the store ids of
+// everything it could have read: the subtrees of the keys it declared and
+// the host's policy files. Hosts that agree on those get the same result
+// without running the check again.
+class ResultMemo {
+public:
+    ResultMemo(const BenchmarkEngine& engine, const SubtreeStore& store, const ColumnarPlan& plan) {
+        const std::vector<BenchmarkCheck*>& checks = engine.getChecks();
+        checkKeys.resize(checks.size());
+        for (size_t c = 0; c < checks.size(); c++) {
+            if (plan.isColumnar(c)) {
+                continue;
+            }
+            ProbeInputs inputs;
+            checks[c]->declareInputs(inputs);
+            for (const auto& entry : inputs.getRegistryKeys()) {
+                checkKeys[c].push_back(static_cast<size_t>(store.findKey(entry.second.path)));
+            }
+        }
+    }
+
+    std::string key(size_t checkIndex, const SnapshotContent& content) const {
+        std::vector<uint32_t> ids;
+        ids.reserve(6 + checkKeys[checkIndex].size());
+        ids.push_back(static_cast<uint32_t>(checkIndex));
+        ids.push_back(content.auditpolId);
+        ids.push_back(content.seceditId);
+        ids.push_back(content.collectionId);
+        ids.push_back(content.imagePolicyId);
+        ids.push_back(content.imageDeltaId);
+        for (size_t k : checkKeys[checkIndex]) {
+            ids.push_back(content.subtreeIds[k]);
+        }
+        return std::string(reinterpret_cast<const char*>(ids.data()), ids.size() * sizeof(uint32_t));
+    }
+
+    std::optional<BenchmarkResult> find(const std::string& key) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = results.find(key);
+        if (it == results.end()) {
+            return std::nullopt;
+        }
+        hits++;
+        return it->second;
+    }
+
+    // Errors may be transient (a timeout), so they are not reused
+    void add(const std::string& key, const BenchmarkResult& result) {
+        if (result.status == CheckStatus::Error) {
+            return;
+        }
+        BenchmarkResult stored = result;
+        stored.timing = CheckTiming();
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        results.emplace(key, std::move(stored));
+    }
+
+    size_t getHits() const { return hits; }
+
+private:
+    std::vector<std::vector<size_t>> checkKeys;     // declared key indices, per check
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, BenchmarkResult> results;
+    mutable std::atomic<size_t> hits{0};
+};
+}
+
+FleetRunner::FleetRunner(const BenchmarkEngine& engine, unsigned int jobs)
+    : engine(engine), jobs(jobs > 0 ? jobs : 1)
+{
+}
+
+void FleetRunner::setBaseline(std::shared_ptr<const SnapshotImage> baseline) {
+    this->baseline = std::move(baseline);
+}
+
+std::vector<std::string> FleetRunner::discoverHosts(const std::string& directory) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> hosts;
+    std::error_code ec;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_directory(ec)) {
+            hosts.push_back(it->path().filename().string());
+        }
+    }
+    std::sort(hosts.begin(), hosts.end());
+    return hosts;
+}
+
+FleetRunner::Summary FleetRunner::run(const std::string& directory, const std::vector<std::string>& hosts,
+                                      std::ostream& out) const
+{
+    std::atomic<size_t> loadFailures{0};
+    std::atomic<size_t> passed{0}, failed{0}, errors{0}, notApplicable{0};
+    std::mutex outMutex;
+
+    {
+        std::lock_guard<std::mutex> lock(outMutex);
+        out << "Host,";
+        engine.writeCsvHeader(out);
+    }
+
+    // Checks with a ScalarRule are evaluated a batch of hosts at a time by the
+    // columnar plan; the rest run per host unless the memo already has their
+    // result for the same content. Batches shrink for small fleets so every
+    // worker still gets several.
+    ColumnarPlan plan(engine);
+    SubtreeStore store(engine.getDeclaredInputs());
+    ResultMemo memo(engine, store, plan);
+    size_t batchSize = (hosts.size() + jobs * 4 - 1) / (jobs * 4);
+    batchSize = std::max<size_t>(1, std::min(batchSize, kMaxBatchHosts));
+    size_t batchCount = (hosts.size() + batchSize - 1) / batchSize;
+
+    auto evaluateBatch = [&](size_t b) {
+        size_t first = b * batchSize;
+        size_t count = std::min(batchSize, hosts.size() - first);
+        ColumnarPlan::Batch batch = plan.newBatch(count);
+        std::vector<std::string> loadErrors(count);
+        std::vector<std::vector<BenchmarkResult>> hostResults(count);
+
+        for (size_t h = 0; h < count; h++) {
+            SnapshotBundle bundle = SnapshotBundle::fromDirectory(
+                (std::filesystem::path(directory) / hosts[first + h]).string());
+            bundle.baseline = baseline;
+            std::shared_ptr<SnapshotProbe> probe;
+            SnapshotContent content;
+            std::string failedFile;
+            HRESULT hr = bundle.empty() ? HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)
+                                        : bundle.loadShared(store, probe, content, failedFile);
+            if (FAILED(hr)) {
+                std::ostringstream reason;
+                reason << (bundle.empty() ? "No snapshot files found" : "Failed to load " + failedFile)
+                       << " (0x" << std::hex << static_cast<DWORD>(hr) << ")";
+                loadErrors[h] = reason.str();
+                continue;
+            }
+
+            std::vector<std::string> memoKeys(plan.getCheckCount());
+            std::vector<std::optional<BenchmarkResult>> memoized(plan.getCheckCount());
+            std::vector<bool> selected(plan.getCheckCount(), false);
+            bool anySelected = false;
+            for (size_t c = 0; c < plan.getCheckCount(); c++) {
+                if (plan.isColumnar(c)) {
+                    continue;
+                }
+                memoKeys[c] = memo.key(c, content);
+                memoized[c] = memo.find(memoKeys[c]);
+                selected[c] = !memoized[c];
+                anySelected = anySelected || selected[c];
+            }
+
+            RunContext run(probe);
+            std::vector<BenchmarkResult> evaluated;
+            if (anySelected) {
+                evaluated = engine.evaluate(run, &selected);
+            }
+            plan.gather(run, batch, h);
+
+            size_t next = 0;
+            for (size_t c = 0; c < plan.getCheckCount(); c++) {
+                if (memoized[c]) {
+                    hostResults[h].push_back(std::move(*memoized[c]));
+                } else if (selected[c]) {
+                    memo.add(memoKeys[c], evaluated[next]);
+                    hostResults[h].push_back(std::move(evaluated[next++]));
+                }
+            }
+        }
+
+        plan.evaluate(batch);
+
+        std::ostringstream rows;
+        for (size_t h = 0; h < count; h++) {
+            const std::string& host = hosts[first + h];
+            if (!loadErrors[h].empty()) {
+                // One row for the host, with no check, through the engine so it
+                // has the same columns as every other row
+                loadFailures++;
+                engine.writeCsvRow(rows, BenchmarkResult("", "", CheckStatus::Error, loadErrors[h]),
+                                   "\"" + host + "\",");
+                continue;
+            }
+
+            size_t next = 0;
+            for (size_t c = 0; c < plan.getCheckCount(); c++) {
+                BenchmarkResult result = plan.isColumnar(c) ? plan.result(batch, c, h)
+                                                            : std::move(hostResults[h][next++]);
+                switch (result.status) {
+                    case CheckStatus::Pass:          passed++;        break;
+                    case CheckStatus::Fail:          failed++;        break;
+                    case CheckStatus::Error:         errors++;        break;
+                    case CheckStatus::NotApplicable: notApplicable++; break;
+                }
+                engine.writeCsvRow(rows, result, "\"" + host + "\",");
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(outMutex);
+        out << rows.str();
+    };
+
+    if (jobs > 1) {
+        WorkStealingPool pool(jobs);
+        pool.run(batchCount, evaluateBatch);
+    } else {
+        for (size_t b = 0; b < batchCount; b++) {
+            evaluateBatch(b);
+        }
+    }
+    out.flush();
+
+    Summary summary;
+    summary.hosts = hosts.size();
+    summary.loadFailures = loadFailures;
+    summary.passed = passed;
+    summary.failed = failed;
+    summary.errors = errors;
+    summary.notApplicable = notApplicable;
+    summary.columnarRules = plan.getRuleCount();
+    summary.distinctSubtrees = store.getSubtreeCount();
+    summary.distinctFiles = store.getFileCount();
+    summary.memoizedResults = memo.getHits();
+    return summary;
+}
\ No newline at end of file
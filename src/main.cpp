@@ -1,9 +1,16 @@
-#include <windows.h>
+#include "include/platform.h"
 #include <iostream>
 #include <string>
 #include <map>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <thread>
 #include "include/benchmark_engine.h"
 #include "include/command_parser.h"
+#include "include/fleet_runner.h"
+#include "include/probes/snapshot_bundle.h"
+#include "include/scalar_kernels.h"
 
 // Section 1
 #include "sections/section1/account_policies.h"
@@ -17,12 +24,45 @@
 #include "sections/section9/windows_firewall_section.h"
 // Section 17
 #include "sections/section17/advanced_audit_policy_section.h"
+// Section 18
+#include "sections/section18/administrative_templates_section.h"
+// Section 19
+#include "sections/section19/user_administrative_templates_section.h"
 
 void printUsage() {
     std::cout << "Usage: Benchmark.exe [options]\n"
               << "Options:\n"
               << "  --section N   Run checks for section N only\n"
               << "  --all         Run all checks\n"
+              << "  --jobs N      Run checks on N worker threads (default 1)\n"
+              << "  --check-timeout MS    Time out a check that runs longer than MS milliseconds\n"
+              << "  --section-timeout MS  Fail checks once a section has run for MS milliseconds\n"
+              << "  --timing      Record per-check timings and probe call counts; declared\n"
+              << "                registry values are prefetched and counted once, for the run\n"
+              << "  --reg-export FILE     Evaluate registry checks against a regedit .reg export\n"
+              << "                        instead of the local system\n"
+              << "  --hive-dir DIR        Evaluate registry checks against the SYSTEM, SOFTWARE,\n"
+              << "                        SECURITY and SAM hive files found in DIR\n"
+              << "  --auditpol-csv FILE   Evaluate section 17 against `auditpol /get /category:* /r`\n"
+              << "                        output or an `auditpol /backup` file\n"
+              << "  --secedit-inf FILE    Evaluate account policies and user rights against a\n"
+              << "                        `secedit /export` security template\n"
+              << "  --collection FILE     Evaluate against a collection written by --collect\n"
+              << "  --image FILE          Evaluate against a snapshot image written by\n"
+              << "                        --collect-image\n"
+              << "  --user-hives DIR      Evaluate section 19 against the users' NTUSER.DAT\n"
+              << "                        copies in DIR, named <SID>.DAT or <SID>\\NTUSER.DAT\n"
+              << "  --collect FILE        Capture everything the selected sections read (all\n"
+              << "                        sections by default) into FILE without evaluating\n"
+              << "  --collect-image FILE  Like --collect, but write a binary snapshot image\n"
+              << "  --baseline FILE       Full snapshot image that delta images are taken\n"
+              << "                        against: --collect-image writes only what differs\n"
+              << "                        from it, and --image and --fleet lay deltas over it\n"
+              << "  --fleet DIR           Evaluate every host bundle (subdirectory) of DIR against\n"
+              << "                        the selected sections (all sections by default) and\n"
+              << "                        write fleet_results.csv; a bundle holds registry.reg,\n"
+              << "                        hive files, auditpol.csv, secedit.inf,\n"
+              << "                        collection.txt and/or snapshot.img\n"
               << "  --list        List available sections\n"
               << "  --help        Display this help message\n";
 }
@@ -38,7 +78,9 @@ void listSections() {
               << "   - Group Membership Control\n"
               << "5. System Services\n"
               << "9. Windows Defender Firewall with Advanced Security\n"
-              << "17. Advanced Audit Policy Configuration\n";
+              << "17. Advanced Audit Policy Configuration\n"
+              << "18. Administrative Templates (Computer)\n"
+              << "19. Administrative Templates (User)\n";
 }
 
 int main(int argc, char* argv[])
@@ -54,6 +96,13 @@ int main(int argc, char* argv[])
         return 0;
     }
 
+    // Offline evaluation reads captured data only and needs no elevation
+    bool offline = cmdParser.hasOption("--reg-export") || cmdParser.hasOption("--hive-dir")
+        || cmdParser.hasOption("--auditpol-csv") || cmdParser.hasOption("--secedit-inf")
+        || cmdParser.hasOption("--collection") || cmdParser.hasOption("--image")
+        || cmdParser.hasOption("--user-hives") || cmdParser.hasOption("--fleet");
+
+#ifdef _WIN32
     // Check for admin privileges
     BOOL isElevated = FALSE;
     HANDLE hToken = NULL;
@@ -68,10 +117,11 @@ int main(int argc, char* argv[])
         CloseHandle(hToken);
     }
 
-    if (!isElevated) {
+    if (!isElevated && !offline) {
         std::cerr << "This program requires administrative privileges to run properly." << std::endl;
         return 1;
     }
+#endif
 
     try {
         BenchmarkEngine engine;
@@ -97,25 +147,164 @@ int main(int argc, char* argv[])
                 case 17:
                     engine.registerSection(std::make_unique<AdvancedAuditPolicySection>());
                     break;
+                case 18:
+                    engine.registerSection(std::make_unique<AdministrativeTemplatesSection>());
+                    break;
+                case 19:
+                    engine.registerSection(std::make_unique<UserAdministrativeTemplatesSection>());
+                    break;
                 default:
                     std::cerr << "Invalid section number\n";
                     return 1;
             }
         }
-        else if (cmdParser.hasOption("--all")) {
-            // Register only sections 1, 2, 4, 5, 9, 17
+        else if (cmdParser.hasOption("--all") || cmdParser.hasOption("--collect")
+                 || cmdParser.hasOption("--collect-image") || cmdParser.hasOption("--fleet")) {
+            // Register only sections 1, 2, 4, 5, 9, 17, 18, 19
             engine.registerSection(std::make_unique<AccountPoliciesSection>());         // section 1
             engine.registerSection(std::make_unique<SecurityOptionsSection>());         // section 2
             engine.registerSection(std::make_unique<RestrictedGroupsSection>());        // section 4
             engine.registerSection(std::make_unique<SystemServicesSection>());          // section 5
             engine.registerSection(std::make_unique<WindowsFirewallSection>());         // section 9
             engine.registerSection(std::make_unique<AdvancedAuditPolicySection>());     // section 17
+            engine.registerSection(std::make_unique<AdministrativeTemplatesSection>()); // section 18
+            engine.registerSection(std::make_unique<UserAdministrativeTemplatesSection>()); // section 19
         }
         else {
             printUsage();
             return 1;
         }
 
+        if (cmdParser.hasOption("--jobs")) {
+            int jobs = std::stoi(cmdParser.getOptionValue("--jobs"));
+            if (jobs < 1) {
+                std::cerr << "Invalid job count\n";
+                return 1;
+            }
+            engine.setJobs(static_cast<unsigned int>(jobs));
+        }
+        if (cmdParser.hasOption("--check-timeout")) {
+            engine.setCheckTimeout(std::chrono::milliseconds(
+                std::stoul(cmdParser.getOptionValue("--check-timeout"))));
+        }
+        if (cmdParser.hasOption("--section-timeout")) {
+            engine.setSectionTimeout(std::chrono::milliseconds(
+                std::stoul(cmdParser.getOptionValue("--section-timeout"))));
+        }
+        if (cmdParser.hasOption("--timing")) {
+            engine.setTiming(true);
+        }
+
+        // Delta images name their baseline by content hash; it must be a full image
+        std::shared_ptr<const SnapshotImage> baseline;
+        if (cmdParser.hasOption("--baseline")) {
+            std::shared_ptr<SnapshotImage> opened;
+            std::string fileName = cmdParser.getOptionValue("--baseline");
+            HRESULT hr = SnapshotImage::open(fileName, opened);
+            if (SUCCEEDED(hr) && opened->isDelta()) {
+                hr = HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+            }
+            if (FAILED(hr)) {
+                std::cerr << "Failed to load baseline " << fileName
+                          << " (0x" << std::hex << static_cast<DWORD>(hr) << std::dec << ")\n";
+                return 1;
+            }
+            baseline = std::move(opened);
+        }
+
+        if (cmdParser.hasOption("--fleet")) {
+            // One worker per core unless --jobs says otherwise; each worker
+            // evaluates one host at a time
+            unsigned int jobs = std::max(1u, std::thread::hardware_concurrency());
+            if (cmdParser.hasOption("--jobs")) {
+                jobs = static_cast<unsigned int>(std::stoi(cmdParser.getOptionValue("--jobs")));
+            }
+
+            std::string fleetDir = cmdParser.getOptionValue("--fleet");
+            std::vector<std::string> hosts = FleetRunner::discoverHosts(fleetDir);
+            if (hosts.empty()) {
+                std::cerr << "No host bundles found in " << fleetDir << "\n";
+                return 1;
+            }
+
+            std::ofstream out("fleet_results.csv");
+            if (!out.is_open()) {
+                std::cerr << "Failed to open output file: fleet_results.csv\n";
+                return 1;
+            }
+
+            FleetRunner runner(engine, jobs);
+            runner.setBaseline(baseline);
+
+            auto started = std::chrono::steady_clock::now();
+            FleetRunner::Summary summary = runner.run(fleetDir, hosts, out);
+            auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started);
+
+            std::cout << "Evaluated " << summary.hosts << " host(s) in " << elapsed.count() << " s"
+                      << " on " << jobs << " worker(s)\n"
+                      << "Columnar rules: " << summary.columnarRules
+                      << " (" << ScalarKernels::getKernelName() << " kernels)\n"
+                      << "Distinct key subtrees: " << summary.distinctSubtrees
+                      << ", policy files: " << summary.distinctFiles
+                      << ", memoized results: " << summary.memoizedResults << "\n"
+                      << "Hosts not loaded: " << summary.loadFailures << "\n"
+                      << "Passed: " << summary.passed << "\n"
+                      << "Failed: " << summary.failed << "\n"
+                      << "Errors: " << summary.errors << "\n"
+                      << "Not Applicable: " << summary.notApplicable << "\n";
+            return 0;
+        }
+
+        if (offline) {
+            SnapshotBundle bundle;
+            bundle.regExport = cmdParser.getOptionValue("--reg-export");
+            bundle.hiveDir = cmdParser.getOptionValue("--hive-dir");
+            bundle.auditpolCsv = cmdParser.getOptionValue("--auditpol-csv");
+            bundle.seceditInf = cmdParser.getOptionValue("--secedit-inf");
+            bundle.collection = cmdParser.getOptionValue("--collection");
+            bundle.image = cmdParser.getOptionValue("--image");
+            bundle.userHiveDir = cmdParser.getOptionValue("--user-hives");
+            bundle.baseline = baseline;
+
+            std::shared_ptr<SnapshotProbe> snapshot;
+            std::string failedFile;
+            HRESULT hr = bundle.load(snapshot, failedFile, &std::cout);
+            if (FAILED(hr)) {
+                std::cerr << "Failed to load " << failedFile
+                          << " (0x" << std::hex << static_cast<DWORD>(hr) << std::dec << ")\n";
+                return 1;
+            }
+            engine.setProbe(snapshot);
+        }
+
+        if (cmdParser.hasOption("--collect") || cmdParser.hasOption("--collect-image")) {
+            // Capture only; the collection is scored elsewhere
+            bool asImage = cmdParser.hasOption("--collect-image");
+            std::string fileName = cmdParser.getOptionValue(asImage ? "--collect-image" : "--collect");
+            std::ofstream out(fileName, std::ios::binary);
+            if (!out.is_open()) {
+                std::cerr << "Failed to open output file: " << fileName << "\n";
+                return 1;
+            }
+            HostCollection collection = engine.collect();
+            if (asImage && baseline) {
+                HRESULT hr = SnapshotImage::writeDelta(collection, *baseline, out);
+                if (FAILED(hr)) {
+                    std::cerr << "Failed to read baseline " << cmdParser.getOptionValue("--baseline")
+                              << " (0x" << std::hex << static_cast<DWORD>(hr) << std::dec << ")\n";
+                    return 1;
+                }
+            } else if (asImage) {
+                SnapshotImage::write(collection, out);
+            } else {
+                HostCollectionFile::write(collection, out);
+            }
+            std::cout << "Collected " << collection.registry.size() << " registry values, "
+                      << collection.services.size() << " services, "
+                      << collection.auditPolicy.size() << " audit subcategories into " << fileName << "\n";
+            return 0;
+        }
+
         // Run checks in all registered sections
         engine.runChecks();
 
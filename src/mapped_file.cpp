@@ -0,0 +1,141 @@
+#include "include/mapped_file.h"
+#include <utility>
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        view = std::exchange(other.view, nullptr);
+        length = std::exchange(other.length, 0);
+#ifdef _WIN32
+        file = std::exchange(other.file, INVALID_HANDLE_VALUE);
+        mapping = std::exchange(other.mapping, nullptr);
+#else
+        fd = std::exchange(other.fd, -1);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+HRESULT MappedFile::open(const std::string& fileName) {
+    close();
+
+    file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+        close();
+        return hr;
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length == 0) {
+        return S_OK;    // nothing to map
+    }
+
+    mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+        close();
+        return hr;
+    }
+    view = static_cast<const BYTE*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!view) {
+        HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+        close();
+        return hr;
+    }
+    return S_OK;
+}
+
+void MappedFile::close() {
+    if (view) {
+        UnmapViewOfFile(view);
+    }
+    if (mapping) {
+        CloseHandle(mapping);
+    }
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+    }
+    view = nullptr;
+    length = 0;
+    mapping = nullptr;
+    file = INVALID_HANDLE_VALUE;
+}
+#else
+namespace {
+HRESULT errnoToHresult(int error) {
+    switch (error) {
+        case ENOENT:
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+        case EACCES:
+        case EPERM:
+            return HRESULT_FROM_WIN32(ERROR_ACCESS_DENIED);
+        default:
+            return HRESULT_FROM_WIN32(ERROR_OPEN_FAILED);
+    }
+}
+}
+
+HRESULT MappedFile::open(const std::string& fileName) {
+    close();
+
+    fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return errnoToHresult(errno);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        HRESULT hr = errnoToHresult(errno);
+        close();
+        return hr;
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length == 0) {
+        return S_OK;    // mmap rejects empty mappings
+    }
+
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        HRESULT hr = errnoToHresult(errno);
+        close();
+        return hr;
+    }
+    view = static_cast<const BYTE*>(mapped);
+    madvise(mapped, length, MADV_SEQUENTIAL);
+    return S_OK;
+}
+
+void MappedFile::close() {
+    if (view) {
+        munmap(const_cast<BYTE*>(view), length);
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    view = nullptr;
+    length = 0;
+    fd = -1;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "include/probes/auditpol_csv.h"
+#include "include/mapped_file.h"
+#include "include/text_decode.h"
+
+namespace {
+// One CSV field starting at line[pos]; quoted fields may contain commas
+std::wstring nextField(const std::wstring& line, size_t& pos) {
+    std::wstring field;
+    if (pos < line.size() && line[pos] == L'"') {
+        for (pos++; pos < line.size(); pos++) {
+            if (line[pos] == L'"') {
+                if (pos + 1 < line.size() && line[pos + 1] == L'"') {
+                    field.push_back(L'"');
+                    pos++;
+                } else {
+                    pos++;
+                    break;
+                }
+            } else {
+                field.push_back(line[pos]);
+            }
+        }
+        while (pos < line.size() && line[pos] != L',') {
+            pos++;
+        }
+    } else {
+        size_t comma = line.find(L',', pos);
+        size_t stop = (comma == std::wstring::npos) ? line.size() : comma;
+        field.assign(line, pos, stop - pos);
+        pos = stop;
+    }
+    if (pos < line.size()) {
+        pos++;  // skip the comma
+    }
+    return field;
+}
+
+// The numeric Setting Value of /backup files is preferred over the
+// Inclusion Setting text, which is localized (and empty on some rows)
+const wchar_t* settingValueText(const std::wstring& value) {
+    if (value == L"0") return L"No Auditing";
+    if (value == L"1") return L"Success";
+    if (value == L"2") return L"Failure";
+    if (value == L"3") return L"Success and Failure";
+    return nullptr;
+}
+}
+
+HRESULT AuditpolCsv::parse(const BYTE* data, size_t size, std::vector<AuditSubcategorySetting>& settings) {
+    settings.clear();
+    if (!data || size == 0) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+    return parseText(decodeText(data, size), settings);
+}
+
+HRESULT AuditpolCsv::parseText(const std::wstring& text, std::vector<AuditSubcategorySetting>& settings) {
+    settings.clear();
+    bool header = true;
+    size_t lineStart = 0;
+    while (lineStart < text.size()) {
+        size_t lineEnd = text.find(L'\n', lineStart);
+        if (lineEnd == std::wstring::npos) {
+            lineEnd = text.size();
+        }
+        std::wstring line(text, lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+        if (!line.empty() && line.back() == L'\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        // First non-empty row is the (localized) column header
+        if (header) {
+            header = false;
+            continue;
+        }
+
+        std::vector<std::wstring> columns;
+        size_t pos = 0;
+        while (pos < line.size() && columns.size() < 7) {
+            columns.push_back(nextField(line, pos));
+        }
+        if (columns.size() < 5 || columns[3].empty() || columns[3][0] != L'{') {
+            continue;
+        }
+
+        AuditSubcategorySetting setting{ columns[2], columns[3], columns[4] };
+        if (columns.size() > 6) {
+            if (const wchar_t* valueText = settingValueText(columns[6])) {
+                setting.inclusionSetting = valueText;
+            }
+        }
+        settings.push_back(std::move(setting));
+    }
+    return settings.empty() ? HRESULT_FROM_WIN32(ERROR_INVALID_DATA) : S_OK;
+}
+
+HRESULT AuditpolCsv::load(const std::string& fileName, std::vector<AuditSubcategorySetting>& settings) {
+    MappedFile file;
+    HRESULT hr = file.open(fileName);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    return parse(file.data(), file.size(), settings);
+}
\ No newline at end of file
@@ -0,0 +1,417 @@
+#include "include/probes/host_collection.h"
+#include "include/mapped_file.h"
+#include "include/text_decode.h"
+#include <cwchar>
+#include <ostream>
+
+namespace {
+const wchar_t kMagic[] = L"win11-benchmark-collection";
+constexpr DWORD kVersion = 1;
+
+struct QueryName {
+    HostCollection::Query query;
+    const wchar_t* name;
+};
+
+const QueryName kQueryNames[] = {
+    { HostCollection::Query::Registry,    L"registry" },
+    { HostCollection::Query::Services,    L"services" },
+    { HostCollection::Query::Service,     L"service" },
+    { HostCollection::Query::Right,       L"right" },
+    { HostCollection::Query::AuditPolicy, L"audit" },
+};
+
+std::wstring escape(const std::wstring& text) {
+    std::wstring out;
+    out.reserve(text.size());
+    for (wchar_t ch : text) {
+        switch (ch) {
+            case L'\\': out += L"\\\\"; break;
+            case L'\t': out += L"\\t"; break;
+            case L'\n': out += L"\\n"; break;
+            case L'\r': out += L"\\r"; break;
+            default: out.push_back(ch); break;
+        }
+    }
+    return out;
+}
+
+std::wstring unescape(const std::wstring& text, size_t begin, size_t end) {
+    std::wstring out;
+    out.reserve(end - begin);
+    for (size_t i = begin; i < end; i++) {
+        if (text[i] != L'\\' || i + 1 == end) {
+            out.push_back(text[i]);
+            continue;
+        }
+        switch (text[++i]) {
+            case L't': out.push_back(L'\t'); break;
+            case L'n': out.push_back(L'\n'); break;
+            case L'r': out.push_back(L'\r'); break;
+            default: out.push_back(text[i]); break;
+        }
+    }
+    return out;
+}
+
+std::vector<std::wstring> splitFields(const std::wstring& text, size_t begin, size_t end) {
+    std::vector<std::wstring> fields;
+    while (true) {
+        size_t tab = text.find(L'\t', begin);
+        if (tab == std::wstring::npos || tab > end) {
+            tab = end;
+        }
+        fields.push_back(unescape(text, begin, tab));
+        if (tab == end) {
+            return fields;
+        }
+        begin = tab + 1;
+    }
+}
+
+bool parseNumber(const std::wstring& text, DWORD& number) {
+    if (text.empty()) {
+        return false;
+    }
+    wchar_t* end = nullptr;
+    unsigned long value = std::wcstoul(text.c_str(), &end, 10);
+    number = static_cast<DWORD>(value);
+    return *end == L'\0';
+}
+
+bool parseHex(const std::wstring& text, std::vector<BYTE>& bytes) {
+    if (text.size() % 2 != 0) {
+        return false;
+    }
+    auto nibble = [](wchar_t ch) -> int {
+        if (ch >= L'0' && ch <= L'9') return ch - L'0';
+        if (ch >= L'a' && ch <= L'f') return ch - L'a' + 10;
+        if (ch >= L'A' && ch <= L'F') return ch - L'A' + 10;
+        return -1;
+    };
+    bytes.clear();
+    bytes.reserve(text.size() / 2);
+    for (size_t i = 0; i < text.size(); i += 2) {
+        int high = nibble(text[i]);
+        int low = nibble(text[i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        bytes.push_back(static_cast<BYTE>((high << 4) | low));
+    }
+    return true;
+}
+
+class RecordWriter {
+public:
+    explicit RecordWriter(std::ostream& out) : out(out) {}
+
+    RecordWriter& field(const std::wstring& text) {
+        line += L'\t';
+        line += escape(text);
+        return *this;
+    }
+
+    RecordWriter& field(DWORD number) {
+        line += L'\t';
+        line += std::to_wstring(number);
+        return *this;
+    }
+
+    RecordWriter& hex(const std::vector<BYTE>& bytes) {
+        static const wchar_t kDigits[] = L"0123456789abcdef";
+        line += L'\t';
+        for (BYTE b : bytes) {
+            line.push_back(kDigits[b >> 4]);
+            line.push_back(kDigits[b & 0x0F]);
+        }
+        return *this;
+    }
+
+    void begin(const wchar_t* kind) {
+        line = kind;
+    }
+
+    void end() {
+        line += L'\n';
+        out << encodeUtf8(line);
+    }
+
+private:
+    std::ostream& out;
+    std::wstring line;
+};
+
+// One record; false if a known kind has the wrong shape
+bool applyRecord(const std::vector<std::wstring>& f, HostCollection& collection) {
+    const std::wstring& kind = f[0];
+    if (kind == L"registry") {
+        HostCollection::RegistryEntry entry;
+        if (f.size() != 5 || !parseNumber(f[3], entry.value.type) || !parseHex(f[4], entry.value.data)) {
+            return false;
+        }
+        entry.path = f[1];
+        entry.valueName = f[2];
+        collection.registry.push_back(std::move(entry));
+    } else if (kind == L"password") {
+        PasswordModals modals;
+        if (f.size() != 6 || !parseNumber(f[1], modals.minPasswdLen) || !parseNumber(f[2], modals.maxPasswdAge)
+            || !parseNumber(f[3], modals.minPasswdAge) || !parseNumber(f[4], modals.forceLogoff)
+            || !parseNumber(f[5], modals.passwordHistLen)) {
+            return false;
+        }
+        collection.password = modals;
+    } else if (kind == L"lockout") {
+        LockoutModals modals;
+        if (f.size() != 4 || !parseNumber(f[1], modals.lockoutDuration)
+            || !parseNumber(f[2], modals.lockoutObservationWindow) || !parseNumber(f[3], modals.lockoutThreshold)) {
+            return false;
+        }
+        collection.lockout = modals;
+    } else if (kind == L"passwordproperties") {
+        PasswordProperties properties;
+        if (f.size() != 3 || !parseNumber(f[1], properties.passwordComplexity)
+            || !parseNumber(f[2], properties.clearTextPassword)) {
+            return false;
+        }
+        collection.passwordProperties = properties;
+    } else if (kind == L"user") {
+        UserAccountInfo info;
+        if (f.size() != 4 || !parseNumber(f[3], info.flags)) {
+            return false;
+        }
+        info.name = f[2];
+        collection.users.emplace_back(f[1], std::move(info));
+    } else if (kind == L"group" || kind == L"right") {
+        if (f.size() < 2) {
+            return false;
+        }
+        auto& target = (kind == L"group") ? collection.groups : collection.rights;
+        target.emplace_back(f[1], std::vector<std::wstring>(f.begin() + 2, f.end()));
+    } else if (kind == L"service") {
+        ServiceEntry entry;
+        if (f.size() != 4 || !parseNumber(f[2], entry.config.startType)
+            || !parseNumber(f[3], entry.config.currentState)) {
+            return false;
+        }
+        entry.name = f[1];
+        collection.services.push_back(std::move(entry));
+    } else if (kind == L"audit") {
+        if (f.size() != 4) {
+            return false;
+        }
+        collection.auditPolicy.push_back(AuditSubcategorySetting{f[1], f[2], f[3]});
+    } else if (kind == L"status") {
+        DWORD status = 0;
+        if (f.size() != 5 || !parseNumber(f[4], status)) {
+            return false;
+        }
+        // A status of a query this version does not make is skipped like an unknown record
+        for (const QueryName& query : kQueryNames) {
+            if (f[1] == query.name) {
+                collection.statuses.push_back({query.query, f[2], f[3], static_cast<HRESULT>(status)});
+                break;
+            }
+        }
+    }
+    return true;
+}
+}
+
+HostCollection Collector::collect(const ProbeInputs& inputs, SystemProbe& probe) {
+    HostCollection collection;
+
+    for (const auto& entry : inputs.getRegistryKeys()) {
+        const ProbeInputs::RegistryKey& key = entry.second;
+        std::vector<RegistryLookup> lookups(key.valueNames.size());
+        for (size_t i = 0; i < lookups.size(); i++) {
+            lookups[i].valueName = key.valueNames[i];
+        }
+        // A key that cannot be opened leaves its failure on every value
+        HRESULT hr = probe.queryRegistryValues(key.path, lookups);
+        for (auto& lookup : lookups) {
+            HRESULT status = FAILED(hr) ? hr : lookup.status;
+            if (SUCCEEDED(status)) {
+                collection.registry.push_back({key.path, lookup.valueName, std::move(lookup.value)});
+            } else if (status != HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)) {
+                collection.statuses.push_back({HostCollection::Query::Registry, key.path, lookup.valueName, status});
+            }
+        }
+    }
+
+    if (inputs.needsAccountModals()) {
+        PasswordModals password;
+        if (SUCCEEDED(probe.queryPasswordModals(password))) {
+            collection.password = password;
+        }
+        LockoutModals lockout;
+        if (SUCCEEDED(probe.queryLockoutModals(lockout))) {
+            collection.lockout = lockout;
+        }
+        PasswordProperties properties;
+        if (SUCCEEDED(probe.queryPasswordProperties(properties))) {
+            collection.passwordProperties = properties;
+        }
+    }
+
+    for (const auto& userName : inputs.getUsers()) {
+        UserAccountInfo info;
+        if (SUCCEEDED(probe.queryUserInfo(userName, info))) {
+            collection.users.emplace_back(userName, std::move(info));
+        }
+    }
+
+    for (const auto& groupName : inputs.getLocalGroups()) {
+        std::vector<std::wstring> members;
+        if (SUCCEEDED(probe.queryLocalGroupMembers(groupName, members))) {
+            collection.groups.emplace_back(groupName, std::move(members));
+        }
+    }
+
+    if (inputs.needsServices()) {
+        std::vector<ServiceEntry> services;
+        HRESULT hr = probe.queryServices(services);
+        collection.statuses.push_back({HostCollection::Query::Services, std::wstring(), std::wstring(), hr});
+        if (FAILED(hr)) {
+            services.clear();
+        }
+        for (auto& service : services) {
+            if (SUCCEEDED(service.status)) {
+                collection.services.push_back(std::move(service));
+            } else {
+                collection.statuses.push_back({HostCollection::Query::Service, service.name, std::wstring(),
+                                               service.status});
+            }
+        }
+    }
+
+    for (const auto& rightName : inputs.getAccountRights()) {
+        std::vector<std::wstring> sids;
+        HRESULT hr = probe.queryAccountsWithRight(rightName, sids);
+        if (SUCCEEDED(hr)) {
+            collection.rights.emplace_back(rightName, std::move(sids));
+        } else {
+            collection.statuses.push_back({HostCollection::Query::Right, rightName, std::wstring(), hr});
+        }
+    }
+
+    if (inputs.needsAuditPolicy()) {
+        HRESULT hr = probe.queryAuditPolicy(collection.auditPolicy);
+        if (FAILED(hr)) {
+            collection.auditPolicy.clear();
+        }
+        collection.statuses.push_back({HostCollection::Query::AuditPolicy, std::wstring(), std::wstring(), hr});
+    }
+    return collection;
+}
+
+void HostCollectionFile::write(const HostCollection& collection, std::ostream& out) {
+    RecordWriter record(out);
+    record.begin(kMagic);
+    record.field(kVersion).end();
+
+    for (const auto& entry : collection.registry) {
+        record.begin(L"registry");
+        record.field(entry.path).field(entry.valueName).field(entry.value.type).hex(entry.value.data).end();
+    }
+    if (collection.password) {
+        const PasswordModals& p = *collection.password;
+        record.begin(L"password");
+        record.field(p.minPasswdLen).field(p.maxPasswdAge).field(p.minPasswdAge)
+              .field(p.forceLogoff).field(p.passwordHistLen).end();
+    }
+    if (collection.lockout) {
+        const LockoutModals& l = *collection.lockout;
+        record.begin(L"lockout");
+        record.field(l.lockoutDuration).field(l.lockoutObservationWindow).field(l.lockoutThreshold).end();
+    }
+    if (collection.passwordProperties) {
+        const PasswordProperties& p = *collection.passwordProperties;
+        record.begin(L"passwordproperties");
+        record.field(p.passwordComplexity).field(p.clearTextPassword).end();
+    }
+    for (const auto& user : collection.users) {
+        record.begin(L"user");
+        record.field(user.first).field(user.second.name).field(user.second.flags).end();
+    }
+    for (const auto& group : collection.groups) {
+        record.begin(L"group");
+        record.field(group.first);
+        for (const auto& member : group.second) {
+            record.field(member);
+        }
+        record.end();
+    }
+    for (const auto& service : collection.services) {
+        record.begin(L"service");
+        record.field(service.name).field(service.config.startType).field(service.config.currentState).end();
+    }
+    for (const auto& right : collection.rights) {
+        record.begin(L"right");
+        record.field(right.first);
+        for (const auto& sid : right.second) {
+            record.field(sid);
+        }
+        record.end();
+    }
+    for (const auto& setting : collection.auditPolicy) {
+        record.begin(L"audit");
+        record.field(setting.subcategory).field(setting.guid).field(setting.inclusionSetting).end();
+    }
+    for (const auto& status : collection.statuses) {
+        for (const QueryName& query : kQueryNames) {
+            if (query.query == status.query) {
+                record.begin(L"status");
+                record.field(query.name).field(status.name).field(status.valueName)
+                      .field(static_cast<DWORD>(status.status)).end();
+            }
+        }
+    }
+}
+
+HRESULT HostCollectionFile::parse(const BYTE* data, size_t size, HostCollection& collection) {
+    collection = HostCollection();
+    if (!data || size == 0) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+
+    std::wstring text = decodeText(data, size);
+    bool sawHeader = false;
+    size_t lineStart = 0;
+    while (lineStart < text.size()) {
+        size_t lineEnd = text.find(L'\n', lineStart);
+        if (lineEnd == std::wstring::npos) {
+            lineEnd = text.size();
+        }
+        size_t contentEnd = (lineEnd > lineStart && text[lineEnd - 1] == L'\r') ? lineEnd - 1 : lineEnd;
+        std::vector<std::wstring> fields = splitFields(text, lineStart, contentEnd);
+        lineStart = lineEnd + 1;
+        if (fields.size() == 1 && fields[0].empty()) {
+            continue;
+        }
+
+        if (!sawHeader) {
+            // A newer major version may have changed the meaning of known records
+            DWORD version = 0;
+            if (fields.size() < 2 || fields[0] != kMagic || !parseNumber(fields[1], version)
+                || version != kVersion) {
+                return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+            }
+            sawHeader = true;
+            continue;
+        }
+        if (!applyRecord(fields, collection)) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+    }
+    return sawHeader ? S_OK : HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+}
+
+HRESULT HostCollectionFile::load(const std::string& fileName, HostCollection& collection) {
+    MappedFile file;
+    HRESULT hr = file.open(fileName);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    return parse(file.data(), file.size(), collection);
+}
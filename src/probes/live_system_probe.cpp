@@ -0,0 +1,672 @@
+#include "include/probes/live_system_probe.h"
+#include "include/probes/auditpol_csv.h"
+#include "include/probes/regf_hive_source.h"
+#include "include/probes/secedit_inf.h"
+#include "include/check_context.h"
+#include "include/string_utils.h"
+#include "include/text_decode.h"
+#include <windows.h>
+#include <lm.h>
+#include <ntsecapi.h>
+#include <sddl.h>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#pragma comment(lib, "netapi32.lib")
+#pragma comment(lib, "advapi32.lib")
+
+#ifndef STATUS_NO_MORE_ENTRIES
+#define STATUS_NO_MORE_ENTRIES ((NTSTATUS)0x8000001AL)
+#endif
+
+LONG LiveSystemProbe::ReadValue(HKEY hKey, const std::wstring& valueName, RegistryValue& value)
+{
+    DWORD dataSize = 0;
+    value.data.clear();
+    LONG result = RegQueryValueExW(hKey, valueName.c_str(), nullptr, &value.type, nullptr, &dataSize);
+    if (result == ERROR_SUCCESS && dataSize > 0) {
+        value.data.resize(dataSize);
+        result = RegQueryValueExW(hKey, valueName.c_str(), nullptr, &value.type, value.data.data(), &dataSize);
+        value.data.resize(dataSize);
+    }
+    return result;
+}
+
+HRESULT LiveSystemProbe::queryRegistryValue(const std::wstring& path, const std::wstring& valueName,
+                                            RegistryValue& value)
+{
+    HKEY hKey;
+    CheckContext::recordProbeCall(CheckContext::ProbeCall::RegistryOpen);
+    LONG result = RegOpenKeyExW(HKEY_LOCAL_MACHINE, path.c_str(), 0, KEY_READ, &hKey);
+    if (result != ERROR_SUCCESS) {
+        return HRESULT_FROM_WIN32(result);
+    }
+
+    result = ReadValue(hKey, valueName, value);
+    RegCloseKey(hKey);
+    return HRESULT_FROM_WIN32(result);
+}
+
+HRESULT LiveSystemProbe::queryRegistryValues(const std::wstring& path, std::vector<RegistryLookup>& lookups)
+{
+    HKEY hKey;
+    CheckContext::recordProbeCall(CheckContext::ProbeCall::RegistryOpen);
+    LONG result = RegOpenKeyExW(HKEY_LOCAL_MACHINE, path.c_str(), 0, KEY_READ, &hKey);
+    if (result != ERROR_SUCCESS) {
+        for (auto& lookup : lookups) {
+            lookup.status = HRESULT_FROM_WIN32(result);
+        }
+        return HRESULT_FROM_WIN32(result);
+    }
+
+    std::vector<VALENTW> entries(lookups.size());
+    for (size_t i = 0; i < lookups.size(); i++) {
+        entries[i].ve_valuename = const_cast<LPWSTR>(lookups[i].valueName.c_str());
+    }
+
+    // First call sizes the buffer, second one fills it
+    DWORD bufferSize = 0;
+    std::vector<BYTE> buffer;
+    result = RegQueryMultipleValuesW(hKey, entries.data(), (DWORD)entries.size(), nullptr, &bufferSize);
+    if (result == ERROR_SUCCESS || result == ERROR_MORE_DATA) {
+        buffer.resize(bufferSize > 0 ? bufferSize : 1);
+        result = RegQueryMultipleValuesW(hKey, entries.data(), (DWORD)entries.size(),
+                                         (LPWSTR)buffer.data(), &bufferSize);
+    }
+
+    if (result == ERROR_SUCCESS) {
+        for (size_t i = 0; i < lookups.size(); i++) {
+            const BYTE* data = (const BYTE*)entries[i].ve_valueptr;
+            lookups[i].status = S_OK;
+            lookups[i].value.type = entries[i].ve_type;
+            lookups[i].value.data.assign(data, data + entries[i].ve_valuelen);
+        }
+    } else {
+        // RegQueryMultipleValues fails as a whole when any one value is
+        // missing; read them one at a time on the key we already hold
+        for (auto& lookup : lookups) {
+            lookup.status = HRESULT_FROM_WIN32(ReadValue(hKey, lookup.valueName, lookup.value));
+        }
+    }
+
+    RegCloseKey(hKey);
+    return S_OK;
+}
+
+/**
+ * LoadedUserHive:
+ *   A user hive that is mounted under HKEY_USERS\<sid>; its NTUSER.DAT is
+ *   locked by the system, so values are read through the registry API.
+ */
+class LoadedUserHive : public RegistrySource {
+public:
+    explicit LoadedUserHive(const std::wstring& sid) : root(sid + L"\\") {}
+
+    HRESULT queryValue(const std::wstring& path, const std::wstring& valueName,
+                       RegistryValue& value) const override
+    {
+        HKEY hKey;
+        CheckContext::recordProbeCall(CheckContext::ProbeCall::RegistryOpen);
+        LONG result = RegOpenKeyExW(HKEY_USERS, (root + path).c_str(), 0, KEY_READ, &hKey);
+        if (result != ERROR_SUCCESS) {
+            return HRESULT_FROM_WIN32(result);
+        }
+        result = LiveSystemProbe::ReadValue(hKey, valueName, value);
+        RegCloseKey(hKey);
+        return HRESULT_FROM_WIN32(result);
+    }
+
+private:
+    std::wstring root;
+};
+
+HRESULT LiveSystemProbe::queryPasswordModals(PasswordModals& modals)
+{
+    USER_MODALS_INFO_0* pBuf = nullptr;
+    CheckContext::recordProbeCall(CheckContext::ProbeCall::NetApi);
+    NET_API_STATUS nStatus = NetUserModalsGet(nullptr, 0, (LPBYTE*)&pBuf);
+    if (nStatus != NERR_Success) {
+        return HRESULT_FROM_WIN32(nStatus);
+    }
+
+    modals.minPasswdLen    = pBuf->usrmod0_min_passwd_len;
+    modals.maxPasswdAge    = pBuf->usrmod0_max_passwd_age;
+    modals.minPasswdAge    = pBuf->usrmod0_min_passwd_age;
+    modals.forceLogoff     = pBuf->usrmod0_force_logoff;
+    modals.passwordHistLen = pBuf->usrmod0_password_hist_len;
+    NetApiBufferFree(pBuf);
+    return S_OK;
+}
+
+HRESULT LiveSystemProbe::queryLockoutModals(LockoutModals& modals)
+{
+    USER_MODALS_INFO_3* pBuf = nullptr;
+    CheckContext::recordProbeCall(CheckContext::ProbeCall::NetApi);
+    NET_API_STATUS nStatus = NetUserModalsGet(nullptr, 3, (LPBYTE*)&pBuf);
+    if (nStatus != NERR_Success) {
+        return HRESULT_FROM_WIN32(nStatus);
+    }
+
+    modals.lockoutDuration          = pBuf->usrmod3_lockout_duration;
+    modals.lockoutObservationWindow = pBuf->usrmod3_lockout_observation_window;
+    modals.lockoutThreshold         = pBuf->usrmod3_lockout_threshold;
+    NetApiBufferFree(pBuf);
+    return S_OK;
+}
+
+// The SAM's own record is readable only as SYSTEM; an elevated administrator
+// gets the same values from the [System Access] keys of `secedit /export`
+HRESULT LiveSystemProbe::queryPasswordProperties(PasswordProperties& properties)
+{
+    HRESULT hr = SystemProbe::queryPasswordProperties(properties);
+    if (SUCCEEDED(hr)) {
+        return hr;
+    }
+
+    // ANSI names, since the template is mapped through MappedFile
+    char tempDir[MAX_PATH];
+    char tempFile[MAX_PATH];
+    wchar_t wideFile[MAX_PATH];
+    if (!GetTempPathA(MAX_PATH, tempDir) || !GetTempFileNameA(tempDir, "cis", 0, tempFile)
+        || !MultiByteToWideChar(CP_ACP, 0, tempFile, -1, wideFile, MAX_PATH))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    SeceditPolicy policy;
+    hr = RunSecedit(L"/export /cfg \"" + std::wstring(wideFile) + L"\" /areas SECURITYPOLICY /quiet");
+    if (SUCCEEDED(hr)) {
+        hr = SeceditInf::load(tempFile, policy);
+    }
+    DeleteFileA(tempFile);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    if (!policy.passwordComplexity || !policy.clearTextPassword) {
+        return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
+    }
+
+    properties.passwordComplexity = *policy.passwordComplexity;
+    properties.clearTextPassword  = *policy.clearTextPassword;
+    return S_OK;
+}
+
+HRESULT LiveSystemProbe::queryUserInfo(const std::wstring& userName, UserAccountInfo& info)
+{
+    USER_INFO_1* userInfo = nullptr;
+    CheckContext::recordProbeCall(CheckContext::ProbeCall::NetApi);
+    NET_API_STATUS status = NetUserGetInfo(nullptr, userName.c_str(), 1, (LPBYTE*)&userInfo);
+    if (status != NERR_Success || !userInfo) {
+        return HRESULT_FROM_WIN32(status);
+    }
+
+    info.name  = userInfo->usri1_name ? userInfo->usri1_name : L"";
+    info.flags = userInfo->usri1_flags;
+    NetApiBufferFree(userInfo);
+    return S_OK;
+}
+
+HRESULT LiveSystemProbe::queryLocalGroupMembers(const std::wstring& groupName,
+                                                std::vector<std::wstring>& members)
+{
+    LOCALGROUP_MEMBERS_INFO_2* memberInfo = nullptr;
+    DWORD entriesRead = 0;
+    DWORD totalEntries = 0;
+
+    CheckContext::recordProbeCall(CheckContext::ProbeCall::NetApi);
+    NET_API_STATUS status = NetLocalGroupGetMembers(
+        nullptr,                   // local server
+        groupName.c_str(),         // group name
+        2,                         // level (LOCALGROUP_MEMBERS_INFO_2)
+        (LPBYTE*)&memberInfo,
+        MAX_PREFERRED_LENGTH,
+        &entriesRead,
+        &totalEntries,
+        nullptr
+    );
+    if (status != NERR_Success) {
+        return HRESULT_FROM_WIN32(status);
+    }
+
+    members.clear();
+    for (DWORD i = 0; i < entriesRead; i++) {
+        // lgrmi2_domainandname contains "domain\username" or similar
+        if (memberInfo[i].lgrmi2_domainandname) {
+            members.push_back(memberInfo[i].lgrmi2_domainandname);
+        }
+    }
+    if (memberInfo) {
+        NetApiBufferFree(memberInfo);
+    }
+    return S_OK;
+}
+
+HRESULT LiveSystemProbe::queryServices(std::vector<ServiceEntry>& services)
+{
+    SC_HANDLE hSCM = OpenSCManager(nullptr, nullptr, SC_MANAGER_CONNECT | SC_MANAGER_ENUMERATE_SERVICE);
+    if (!hSCM) {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    services.clear();
+    std::vector<BYTE> buffer(64 * 1024);
+    std::vector<BYTE> configBuffer(8192);
+    DWORD resumeHandle = 0;
+    for (;;) {
+        DWORD bytesNeeded = 0;
+        DWORD count = 0;
+        BOOL success = EnumServicesStatusExW(hSCM, SC_ENUM_PROCESS_INFO, SERVICE_WIN32, SERVICE_STATE_ALL,
+                                             buffer.data(), (DWORD)buffer.size(), &bytesNeeded,
+                                             &count, &resumeHandle, nullptr);
+        DWORD err = success ? ERROR_SUCCESS : GetLastError();
+        if (!success && err != ERROR_MORE_DATA) {
+            CloseServiceHandle(hSCM);
+            return HRESULT_FROM_WIN32(err);
+        }
+
+        const ENUM_SERVICE_STATUS_PROCESSW* status =
+            reinterpret_cast<const ENUM_SERVICE_STATUS_PROCESSW*>(buffer.data());
+        for (DWORD i = 0; i < count; i++) {
+            ServiceEntry entry;
+            entry.name = status[i].lpServiceName;
+            entry.config.currentState = status[i].ServiceStatusProcess.dwCurrentState;
+            entry.status = QueryStartType(hSCM, entry.name, configBuffer, entry.config.startType);
+            services.push_back(std::move(entry));
+        }
+
+        if (success) {
+            break;
+        }
+        // ERROR_MORE_DATA: resumeHandle points at the rest
+        if (bytesNeeded > buffer.size()) {
+            buffer.resize(bytesNeeded);
+        }
+    }
+
+    CloseServiceHandle(hSCM);
+    return S_OK;
+}
+
+HRESULT LiveSystemProbe::QueryStartType(SC_HANDLE hSCM, const std::wstring& serviceName,
+                                        std::vector<BYTE>& buffer, DWORD& startType)
+{
+    SC_HANDLE hService = OpenServiceW(hSCM, serviceName.c_str(), SERVICE_QUERY_CONFIG);
+    if (!hService) {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    DWORD bytesNeeded = 0;
+    BOOL success = QueryServiceConfigW(hService, reinterpret_cast<LPQUERY_SERVICE_CONFIGW>(buffer.data()),
+                                       (DWORD)buffer.size(), &bytesNeeded);
+    if (!success && GetLastError() == ERROR_INSUFFICIENT_BUFFER) {
+        buffer.resize(bytesNeeded);
+        success = QueryServiceConfigW(hService, reinterpret_cast<LPQUERY_SERVICE_CONFIGW>(buffer.data()),
+                                      (DWORD)buffer.size(), &bytesNeeded);
+    }
+    DWORD err = success ? ERROR_SUCCESS : GetLastError();
+    CloseServiceHandle(hService);
+
+    if (!success) {
+        return HRESULT_FROM_WIN32(err);
+    }
+    startType = reinterpret_cast<LPQUERY_SERVICE_CONFIGW>(buffer.data())->dwStartType;
+    return S_OK;
+}
+
+HRESULT LiveSystemProbe::lookupAccountSid(const std::wstring& accountName, std::wstring& sid)
+{
+    // Process-wide memo: name -> (result, SID). Transient failures are not kept.
+    static std::mutex cacheMutex;
+    static std::unordered_map<std::wstring, std::pair<HRESULT, std::wstring>> cache;
+
+    std::wstring key = toLowerCopy(accountName);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            sid = it->second.second;
+            return it->second.first;
+        }
+    }
+
+    HRESULT hr = LookupAccountSidUncached(accountName, sid);
+    if (SUCCEEDED(hr) || hr == HRESULT_FROM_WIN32(ERROR_NONE_MAPPED)) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        cache.emplace(std::move(key), std::make_pair(hr, SUCCEEDED(hr) ? sid : std::wstring()));
+    }
+    return hr;
+}
+
+HRESULT LiveSystemProbe::LookupAccountSidUncached(const std::wstring& accountName, std::wstring& sid)
+{
+    DWORD sidSize = 0;
+    DWORD domainSize = 0;
+    SID_NAME_USE sidType;
+
+    LookupAccountNameW(nullptr, accountName.c_str(), nullptr, &sidSize, nullptr, &domainSize, &sidType);
+    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    std::vector<BYTE> sidBuffer(sidSize);
+    std::vector<WCHAR> domainName(domainSize);
+    if (!LookupAccountNameW(nullptr, accountName.c_str(), sidBuffer.data(), &sidSize,
+                            domainName.data(), &domainSize, &sidType))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    LPWSTR sidString = nullptr;
+    if (!ConvertSidToStringSidW(sidBuffer.data(), &sidString)) {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+    sid = sidString;
+    LocalFree(sidString);
+    return S_OK;
+}
+
+HRESULT LiveSystemProbe::queryAccountsWithRight(const std::wstring& rightName,
+                                                std::vector<std::wstring>& sids)
+{
+    LSA_OBJECT_ATTRIBUTES attributes;
+    ZeroMemory(&attributes, sizeof(attributes));
+    LSA_HANDLE policy = nullptr;
+
+    NTSTATUS status = LsaOpenPolicy(nullptr, &attributes, POLICY_LOOKUP_NAMES | POLICY_VIEW_LOCAL_INFORMATION, &policy);
+    if (status != 0) {
+        return HRESULT_FROM_WIN32(LsaNtStatusToWinError(status));
+    }
+
+    LSA_UNICODE_STRING right;
+    right.Buffer        = const_cast<PWSTR>(rightName.c_str());
+    right.Length        = static_cast<USHORT>(rightName.size() * sizeof(WCHAR));
+    right.MaximumLength = right.Length;
+
+    LSA_ENUMERATION_INFORMATION* accounts = nullptr;
+    ULONG count = 0;
+    status = LsaEnumerateAccountsWithUserRight(policy, &right, reinterpret_cast<PVOID*>(&accounts), &count);
+    LsaClose(policy);
+
+    sids.clear();
+    if (status == STATUS_NO_MORE_ENTRIES) {
+        return S_OK; // Nobody holds the right
+    }
+    if (status != 0) {
+        return HRESULT_FROM_WIN32(LsaNtStatusToWinError(status));
+    }
+
+    for (ULONG i = 0; i < count; i++) {
+        LPWSTR sidString = nullptr;
+        if (ConvertSidToStringSidW(accounts[i].Sid, &sidString)) {
+            sids.push_back(sidString);
+            LocalFree(sidString);
+        }
+    }
+    LsaFreeMemory(accounts);
+    return S_OK;
+}
+
+/**
+ * queryAuditPolicy:
+ *  1. Runs: auditpol.exe /get /category:* /r   (one process for every subcategory)
+ *  2. Parses the CSV with AuditpolCsv, the same parser used for offline
+ *     auditpol snapshots, and returns subcategory, GUID and "Inclusion
+ *     Setting" of every row.
+ */
+HRESULT LiveSystemProbe::queryAuditPolicy(std::vector<AuditSubcategorySetting>& settings)
+{
+    std::wstring output = RunAuditpol(L"/get /category:* /r");
+
+    if (output.empty()) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+
+    return AuditpolCsv::parseText(output, settings);
+}
+
+// Profiles of local (S-1-5-21-) and Entra ID (S-1-12-1-) accounts; the
+// SYSTEM, LocalService and NetworkService profiles hold no user policy
+HRESULT LiveSystemProbe::queryUserProfiles(std::vector<UserProfile>& profiles)
+{
+    HKEY hProfiles;
+    CheckContext::recordProbeCall(CheckContext::ProbeCall::RegistryOpen);
+    LONG result = RegOpenKeyExW(HKEY_LOCAL_MACHINE,
+                                L"SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion\\ProfileList",
+                                0, KEY_READ, &hProfiles);
+    if (result != ERROR_SUCCESS) {
+        return HRESULT_FROM_WIN32(result);
+    }
+
+    profiles.clear();
+    wchar_t name[256];
+    for (DWORD index = 0;; index++) {
+        DWORD nameLength = sizeof(name) / sizeof(name[0]);
+        result = RegEnumKeyExW(hProfiles, index, name, &nameLength, nullptr, nullptr, nullptr, nullptr);
+        if (result != ERROR_SUCCESS) {
+            break;
+        }
+        std::wstring sid(name, nameLength);
+        if (sid.compare(0, 9, L"S-1-5-21-") != 0 && sid.compare(0, 9, L"S-1-12-1-") != 0) {
+            continue;
+        }
+
+        // RegGetValue expands the REG_EXPAND_SZ path
+        wchar_t path[MAX_PATH];
+        DWORD pathSize = sizeof(path);
+        if (RegGetValueW(hProfiles, sid.c_str(), L"ProfileImagePath", RRF_RT_REG_SZ | RRF_RT_REG_EXPAND_SZ,
+                         nullptr, path, &pathSize) != ERROR_SUCCESS) {
+            continue;
+        }
+        std::wstring hivePath = std::wstring(path) + L"\\NTUSER.DAT";
+
+        UserProfile profile;
+        profile.sid = sid;
+        int bytes = WideCharToMultiByte(CP_ACP, 0, hivePath.c_str(), -1, nullptr, 0, nullptr, nullptr);
+        if (bytes > 0) {
+            profile.hiveFile.resize(bytes - 1);
+            WideCharToMultiByte(CP_ACP, 0, hivePath.c_str(), -1, &profile.hiveFile[0], bytes, nullptr, nullptr);
+        }
+
+        HKEY hUser;
+        if (RegOpenKeyExW(HKEY_USERS, sid.c_str(), 0, KEY_READ, &hUser) == ERROR_SUCCESS) {
+            profile.loaded = true;
+            RegCloseKey(hUser);
+        }
+        profiles.push_back(std::move(profile));
+    }
+
+    RegCloseKey(hProfiles);
+    return result == ERROR_NO_MORE_ITEMS ? S_OK : HRESULT_FROM_WIN32(result);
+}
+
+// A hive nobody has loaded is read from its file rather than mounted with
+// RegLoadKey, which would need SeRestorePrivilege and write to HKEY_USERS
+HRESULT LiveSystemProbe::openUserHive(const UserProfile& profile, std::shared_ptr<const RegistrySource>& hive)
+{
+    if (profile.loaded) {
+        hive = std::make_shared<LoadedUserHive>(profile.sid);
+        return S_OK;
+    }
+
+    std::shared_ptr<RegfHiveSource> source;
+    HRESULT hr = RegfHiveSource::load(profile.hiveFile, std::wstring(), source);
+    if (SUCCEEDED(hr)) {
+        hive = std::move(source);
+    }
+    return hr;
+}
+
+/**
+ * RunAuditpol:
+ *  - Creates child process "auditpol.exe <arguments>",
+ *  - Captures stdout,
+ *  - Returns entire output as wstring, decoded once, whole, from the
+ *    console output code page (or by its byte order mark, if any).
+ *  - Kills the process and returns an empty string if the running
+ *    check's CheckContext is cancelled before auditpol.exe finishes.
+ */
+std::wstring LiveSystemProbe::RunAuditpol(const std::wstring& arguments)
+{
+    std::wstringstream cmd;
+    cmd << L"auditpol.exe " << arguments;
+
+    // Create pipe
+    SECURITY_ATTRIBUTES sa;
+    ZeroMemory(&sa, sizeof(sa));
+    sa.nLength              = sizeof(sa);
+    sa.bInheritHandle       = TRUE;
+    sa.lpSecurityDescriptor = NULL;
+
+    HANDLE hReadPipe  = nullptr;
+    HANDLE hWritePipe = nullptr;
+    if (!CreatePipe(&hReadPipe, &hWritePipe, &sa, 0)) {
+        return L"";
+    }
+    if (!SetHandleInformation(hReadPipe, HANDLE_FLAG_INHERIT, 0)) {
+        CloseHandle(hReadPipe);
+        CloseHandle(hWritePipe);
+        return L"";
+    }
+
+    // Setup STARTUPINFO
+    STARTUPINFOW si;
+    ZeroMemory(&si, sizeof(si));
+    si.cb         = sizeof(si);
+    si.hStdOutput = hWritePipe;
+    si.hStdError  = hWritePipe;
+    si.dwFlags    = STARTF_USESTDHANDLES;
+
+    PROCESS_INFORMATION pi;
+    ZeroMemory(&pi, sizeof(pi));
+
+    std::wstring cmdLine = cmd.str();
+    CheckContext::recordProbeCall(CheckContext::ProbeCall::ProcessSpawn);
+    if (!CreateProcessW(
+        nullptr,
+        &cmdLine[0],
+        nullptr,
+        nullptr,
+        TRUE,
+        0,
+        nullptr,
+        nullptr,
+        &si,
+        &pi))
+    {
+        CloseHandle(hReadPipe);
+        CloseHandle(hWritePipe);
+        return L"";
+    }
+
+    // Close our write handle so we can read from the read end
+    CloseHandle(hWritePipe);
+
+    // Read the output. The pipe is polled rather than read blindly so that a
+    // wedged auditpol.exe can be killed once the running check's deadline
+    // passes, instead of blocking this thread forever.
+    CheckContext* context = CheckContext::current();
+    std::vector<BYTE> output;
+    const DWORD BUFSIZE = 4096;
+    BYTE buffer[BUFSIZE];
+    DWORD bytesRead = 0;
+    bool exited = false;
+    bool killed = false;
+
+    while (true) {
+        DWORD available = 0;
+        if (!PeekNamedPipe(hReadPipe, nullptr, 0, nullptr, &available, nullptr)) {
+            break; // Broken pipe: the process has closed its end
+        }
+
+        if (available == 0) {
+            if (exited) {
+                break;
+            }
+            if (context && context->isCancelled()) {
+                TerminateProcess(pi.hProcess, 1);
+                context->markAborted();
+                killed = true;
+                break;
+            }
+            exited = (WaitForSingleObject(pi.hProcess, 50) == WAIT_OBJECT_0);
+            continue;
+        }
+
+        if (!ReadFile(hReadPipe, buffer, BUFSIZE, &bytesRead, nullptr) || bytesRead == 0) {
+            break;
+        }
+        output.insert(output.end(), buffer, buffer + bytesRead);
+    }
+
+    CloseHandle(hReadPipe);
+
+    // Reap the process; it has either exited or been terminated above
+    WaitForSingleObject(pi.hProcess, INFINITE);
+    CloseHandle(pi.hProcess);
+    CloseHandle(pi.hThread);
+
+    if (killed || output.empty()) {
+        return L"";
+    }
+
+    // Decoded whole, so no character is split across two reads. Without a
+    // byte order mark auditpol writes the console's (OEM) code page.
+    if ((output.size() >= 2 && output[0] == 0xFF && output[1] == 0xFE) ||
+        (output.size() >= 3 && output[0] == 0xEF && output[1] == 0xBB && output[2] == 0xBF))
+    {
+        return decodeText(output.data(), output.size());
+    }
+    UINT codePage = GetConsoleOutputCP();
+    if (codePage == 0) {
+        codePage = CP_OEMCP;
+    }
+    const char* bytes = reinterpret_cast<const char*>(output.data());
+    int wchars = MultiByteToWideChar(codePage, 0, bytes, (int)output.size(), nullptr, 0);
+    if (wchars <= 0) {
+        return L"";
+    }
+    std::wstring result(wchars, L'\0');
+    MultiByteToWideChar(codePage, 0, bytes, (int)output.size(), &result[0], wchars);
+    return result;
+}
+
+HRESULT LiveSystemProbe::RunSecedit(const std::wstring& arguments)
+{
+    std::wstring cmdLine = L"secedit.exe " + arguments;
+
+    STARTUPINFOW si;
+    ZeroMemory(&si, sizeof(si));
+    si.cb = sizeof(si);
+
+    PROCESS_INFORMATION pi;
+    ZeroMemory(&pi, sizeof(pi));
+
+    CheckContext::recordProbeCall(CheckContext::ProbeCall::ProcessSpawn);
+    if (!CreateProcessW(nullptr, &cmdLine[0], nullptr, nullptr, FALSE, CREATE_NO_WINDOW,
+                        nullptr, nullptr, &si, &pi))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    // Polled like auditpol.exe, so the check's deadline still applies
+    CheckContext* context = CheckContext::current();
+    HRESULT hr = S_OK;
+    while (WaitForSingleObject(pi.hProcess, 50) == WAIT_TIMEOUT) {
+        if (context && context->isCancelled()) {
+            TerminateProcess(pi.hProcess, 1);
+            WaitForSingleObject(pi.hProcess, INFINITE);
+            context->markAborted();
+            hr = HRESULT_FROM_WIN32(ERROR_CANCELLED);
+            break;
+        }
+    }
+
+    DWORD exitCode = 0;
+    if (SUCCEEDED(hr) && (!GetExitCodeProcess(pi.hProcess, &exitCode) || exitCode != 0)) {
+        hr = E_FAIL;
+    }
+    CloseHandle(pi.hProcess);
+    CloseHandle(pi.hThread);
+    return hr;
+}
\ No newline at end of file
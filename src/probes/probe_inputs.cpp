@@ -0,0 +1,31 @@
+#include "include/probes/probe_inputs.h"
+#include "include/string_utils.h"
+
+void ProbeInputs::addRegistryValue(const std::wstring& path, const std::wstring& valueName) {
+    RegistryKey& key = registryKeys[toLowerCopy(path)];
+    if (key.path.empty()) {
+        key.path = path;
+    }
+    addName(key.valueNames, valueName);
+}
+
+void ProbeInputs::addUser(const std::wstring& userName) {
+    addName(users, userName);
+}
+
+void ProbeInputs::addLocalGroup(const std::wstring& groupName) {
+    addName(localGroups, groupName);
+}
+
+void ProbeInputs::addAccountRight(const std::wstring& rightName) {
+    addName(accountRights, rightName);
+}
+
+void ProbeInputs::addName(std::vector<std::wstring>& names, const std::wstring& name) {
+    for (const auto& existing : names) {
+        if (equalsIgnoreCase(existing, name)) {
+            return;
+        }
+    }
+    names.push_back(name);
+}
\ No newline at end of file
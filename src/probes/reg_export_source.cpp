@@ -0,0 +1,311 @@
+#include "include/probes/reg_export_source.h"
+#include <cwctype>
+
+namespace {
+const std::u16string_view kHeader = u"Windows Registry Editor Version 5.00";
+const std::u16string_view kLocalMachine = u"HKEY_LOCAL_MACHINE";
+
+inline char16_t foldCase(char16_t c) {
+    if (c < 0x80) {
+        return (c >= u'A' && c <= u'Z') ? static_cast<char16_t>(c + (u'a' - u'A')) : c;
+    }
+    return static_cast<char16_t>(towlower(c));
+}
+
+inline bool startsWithIgnoreCase(std::u16string_view s, std::u16string_view prefix) {
+    if (s.size() < prefix.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < prefix.size(); i++) {
+        if (foldCase(s[i]) != foldCase(prefix[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline const char16_t* findLineEnd(const char16_t* p, const char16_t* end) {
+    while (p < end && *p != u'\n') {
+        p++;
+    }
+    return p;
+}
+
+inline int hexDigit(char16_t c) {
+    if (c >= u'0' && c <= u'9') return c - u'0';
+    if (c >= u'a' && c <= u'f') return c - u'a' + 10;
+    if (c >= u'A' && c <= u'F') return c - u'A' + 10;
+    return -1;
+}
+
+void appendUtf16(std::vector<BYTE>& out, char16_t c) {
+    out.push_back(static_cast<BYTE>(c & 0xFF));
+    out.push_back(static_cast<BYTE>(c >> 8));
+}
+}
+
+size_t RegExportSource::FoldHash::operator()(std::u16string_view s) const {
+    // FNV-1a over case-folded UTF-16 units
+    size_t hash = 14695981039346656037ull;
+    for (char16_t c : s) {
+        hash = (hash ^ foldCase(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+bool RegExportSource::FoldEqual::operator()(std::u16string_view a, std::u16string_view b) const {
+    return a.size() == b.size() && startsWithIgnoreCase(a, b);
+}
+
+HRESULT RegExportSource::load(const std::string& fileName, std::shared_ptr<RegExportSource>& source) {
+    auto loaded = std::make_shared<RegExportSource>();
+    HRESULT hr = loaded->file.open(fileName);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    hr = loaded->parse();
+    if (FAILED(hr)) {
+        return hr;
+    }
+    source = std::move(loaded);
+    return S_OK;
+}
+
+// One pass over the mapping. Each line is a [key] header, a "name"=data
+// (or @=data) value, a comment, or blank. Binary data may continue over
+// several lines ending in a backslash; only its extent is recorded here.
+HRESULT RegExportSource::parse() {
+    const BYTE* bytes = file.data();
+    size_t size = file.size();
+    if (size < 2 || bytes[0] != 0xFF || bytes[1] != 0xFE) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);     // not UTF-16LE
+    }
+
+    // Mappings are page-aligned, so the text after the BOM is 2-byte aligned
+    const char16_t* p = reinterpret_cast<const char16_t*>(bytes + 2);
+    const char16_t* end = p + (size - 2) / 2;
+
+    const char16_t* lineEnd = findLineEnd(p, end);
+    if (!startsWithIgnoreCase(std::u16string_view(p, lineEnd - p), kHeader)) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+    p = lineEnd;
+
+    // Rough guess from typical exports: about 100 bytes per value
+    values.reserve(size / 100);
+    keys.reserve(size / 400);
+
+    uint32_t* currentKey = nullptr;     // newest value of the key being read; null inside [-key] blocks
+    while (p < end) {
+        char16_t c = *p;
+        if (c == u'\r' || c == u'\n' || c == u' ' || c == u'\t') {
+            p++;
+            continue;
+        }
+
+        if (c == u'[') {
+            lineEnd = findLineEnd(p, end);
+            const char16_t* close = lineEnd;
+            while (close > p && *close != u']') {
+                close--;
+            }
+            std::u16string_view path(p + 1, close > p ? close - p - 1 : 0);
+            p = lineEnd;
+
+            if (!path.empty() && path[0] == u'-') {
+                currentKey = nullptr;   // key deletion
+                continue;
+            }
+            if (startsWithIgnoreCase(path, kLocalMachine)) {
+                if (path.size() == kLocalMachine.size()) {
+                    path = std::u16string_view();
+                } else if (path[kLocalMachine.size()] == u'\\') {
+                    path.remove_prefix(kLocalMachine.size() + 1);
+                }
+            }
+            currentKey = &keys.emplace(path, kNoValue).first->second;
+            continue;
+        }
+
+        if (c != u'"' && c != u'@') {
+            p = findLineEnd(p, end);    // comment or something we do not use
+            continue;
+        }
+
+        // Value name
+        std::u16string_view name;
+        if (c == u'@') {
+            p++;
+        } else {
+            const char16_t* q = p + 1;
+            while (q < end && *q != u'"') {
+                q += (*q == u'\\') ? 2 : 1;
+            }
+            if (q >= end) {
+                break;
+            }
+            name = std::u16string_view(p + 1, q - p - 1);
+            p = q + 1;
+        }
+
+        while (p < end && (*p == u' ' || *p == u'\t')) {
+            p++;
+        }
+        if (p >= end || *p != u'=') {
+            p = findLineEnd(p, end);
+            continue;
+        }
+        p++;
+
+        // Value data: a quoted string, or text up to a line that does not
+        // end in a continuation backslash
+        const char16_t* dataStart = p;
+        if (p < end && *p == u'"') {
+            p++;
+            while (p < end && *p != u'"') {
+                p += (*p == u'\\') ? 2 : 1;
+            }
+            p = (p < end) ? p + 1 : end;
+        } else {
+            for (;;) {
+                const char16_t* lineStart = p;
+                lineEnd = findLineEnd(p, end);
+                const char16_t* last = lineEnd;
+                while (last > lineStart && (last[-1] == u'\r' || last[-1] == u' ' || last[-1] == u'\t')) {
+                    last--;
+                }
+                p = lineEnd;
+                if (last == lineStart || last[-1] != u'\\' || p >= end) {
+                    break;
+                }
+                p++;
+            }
+        }
+        const char16_t* dataEnd = p;
+        while (dataEnd > dataStart && (dataEnd[-1] == u'\r' || dataEnd[-1] == u' ' || dataEnd[-1] == u'\t')) {
+            dataEnd--;
+        }
+
+        if (currentKey) {
+            values.push_back(ValueRecord{ name, std::u16string_view(dataStart, dataEnd - dataStart), *currentKey });
+            *currentKey = static_cast<uint32_t>(values.size() - 1);
+        }
+    }
+    return S_OK;
+}
+
+bool RegExportSource::nameEquals(std::u16string_view escapedName, const std::wstring& name) {
+    size_t j = 0;
+    for (size_t i = 0; i < escapedName.size(); i++, j++) {
+        char16_t c = escapedName[i];
+        if (c == u'\\' && i + 1 < escapedName.size()) {
+            c = escapedName[++i];
+        }
+        if (j >= name.size() || foldCase(c) != foldCase(static_cast<char16_t>(name[j]))) {
+            return false;
+        }
+    }
+    return j == name.size();
+}
+
+HRESULT RegExportSource::decodeData(std::u16string_view data, RegistryValue& value) {
+    value.data.clear();
+
+    if (data == u"-") {
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);    // value deletion
+    }
+
+    // "text" => REG_SZ, stored NUL-terminated as RegQueryValueEx returns it
+    if (!data.empty() && data[0] == u'"') {
+        value.type = REG_SZ;
+        for (size_t i = 1; i < data.size() && data[i] != u'"'; i++) {
+            char16_t c = data[i];
+            if (c == u'\\' && i + 1 < data.size()) {
+                c = data[++i];
+            }
+            appendUtf16(value.data, c);
+        }
+        appendUtf16(value.data, 0);
+        return S_OK;
+    }
+
+    std::u16string_view hexDigits;
+    if (startsWithIgnoreCase(data, u"dword:")) {
+        DWORD dword = 0;
+        std::u16string_view digits = data.substr(6);
+        if (digits.empty() || digits.size() > 8) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+        for (char16_t c : digits) {
+            int digit = hexDigit(c);
+            if (digit < 0) {
+                return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+            }
+            dword = (dword << 4) | static_cast<DWORD>(digit);
+        }
+        value.type = REG_DWORD;
+        for (int i = 0; i < 4; i++) {
+            value.data.push_back(static_cast<BYTE>(dword >> (8 * i)));
+        }
+        return S_OK;
+    }
+    if (startsWithIgnoreCase(data, u"hex:")) {
+        value.type = REG_BINARY;
+        hexDigits = data.substr(4);
+    } else if (startsWithIgnoreCase(data, u"hex(")) {
+        // hex(N): with N the registry type in hex, e.g. hex(7) for REG_MULTI_SZ
+        size_t close = data.find(u"):");
+        if (close == std::u16string_view::npos || close == 4) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+        DWORD type = 0;
+        for (size_t i = 4; i < close; i++) {
+            int digit = hexDigit(data[i]);
+            if (digit < 0) {
+                return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+            }
+            type = (type << 4) | static_cast<DWORD>(digit);
+        }
+        value.type = type;
+        hexDigits = data.substr(close + 2);
+    } else {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+
+    // Comma-separated bytes, possibly continued over several lines
+    int high = -1;
+    for (char16_t c : hexDigits) {
+        int digit = hexDigit(c);
+        if (digit >= 0) {
+            if (high < 0) {
+                high = digit;
+            } else {
+                value.data.push_back(static_cast<BYTE>((high << 4) | digit));
+                high = -1;
+            }
+        } else if (c == u',') {
+            high = -1;
+        }
+    }
+    return S_OK;
+}
+
+HRESULT RegExportSource::queryValue(const std::wstring& path, const std::wstring& valueName,
+                                    RegistryValue& value) const
+{
+    std::u16string key(path.size(), u'\0');
+    for (size_t i = 0; i < path.size(); i++) {
+        key[i] = static_cast<char16_t>(path[i]);
+    }
+
+    auto it = keys.find(key);
+    if (it == keys.end()) {
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+    }
+    for (uint32_t i = it->second; i != kNoValue; i = values[i].next) {
+        if (nameEquals(values[i].name, valueName)) {
+            return decodeData(values[i].data, value);
+        }
+    }
+    return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+}
\ No newline at end of file
@@ -0,0 +1,333 @@
+#include "include/probes/regf_hive_source.h"
+#include <algorithm>
+#include <cstring>
+#include <cwchar>
+#include <cwctype>
+
+namespace {
+// Layout of the regf base block and of the cells in the hive bins
+const size_t kBaseBlockSize    = 4096;
+const uint16_t kKeyCompName    = 0x0020;     // nk: name stored as Latin-1
+const uint16_t kValueCompName  = 0x0001;     // vk: name stored as Latin-1
+const uint32_t kDataInline     = 0x80000000; // vk: data lives in the offset field
+const uint32_t kBigDataSegment = 16344;      // db: bytes per segment (hive 1.4+)
+const int kMaxListDepth        = 4;          // ri lists nest at most once in practice
+
+inline uint16_t readU16(const BYTE* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t readU32(const BYTE* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline wchar_t upcase(wchar_t c) {
+    if (c < 0x80) {
+        return (c >= L'a' && c <= L'z') ? static_cast<wchar_t>(c - (L'a' - L'A')) : c;
+    }
+    return static_cast<wchar_t>(towupper(c));
+}
+
+// Hash stored in lh lists: h = h * 37 + upcase(c) over the UTF-16 name
+uint32_t lhHash(std::wstring_view name) {
+    uint32_t hash = 0;
+    for (wchar_t c : name) {
+        hash = hash * 37 + static_cast<uint32_t>(upcase(c));
+    }
+    return hash;
+}
+
+// Compares a name stored in a cell (Latin-1 or UTF-16LE) with a query
+bool storedNameEquals(const BYTE* stored, size_t storedBytes, bool compressed, std::wstring_view name) {
+    size_t length = compressed ? storedBytes : storedBytes / 2;
+    if (length != name.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        wchar_t c = compressed ? static_cast<wchar_t>(stored[i]) : static_cast<wchar_t>(readU16(stored + 2 * i));
+        if (upcase(c) != upcase(name[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool startsWithComponent(std::wstring_view path, std::wstring_view prefix) {
+    if (path.size() < prefix.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < prefix.size(); i++) {
+        if (upcase(path[i]) != upcase(prefix[i])) {
+            return false;
+        }
+    }
+    return path.size() == prefix.size() || path[prefix.size()] == L'\\';
+}
+}
+
+HRESULT RegfHiveSource::load(const std::string& fileName, const std::wstring& mountPath,
+                             std::shared_ptr<RegfHiveSource>& source)
+{
+    auto loaded = std::make_shared<RegfHiveSource>();
+    HRESULT hr = loaded->file.open(fileName);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    loaded->mountPath = mountPath;
+    hr = loaded->parseHeader();
+    if (FAILED(hr)) {
+        return hr;
+    }
+    source = std::move(loaded);
+    return S_OK;
+}
+
+HRESULT RegfHiveSource::parseHeader() {
+    const BYTE* base = file.data();
+    if (file.size() < kBaseBlockSize || std::memcmp(base, "regf", 4) != 0) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+    minorVersion = readU32(base + 0x18);
+    rootCell = readU32(base + 0x24);
+    if (!cell(rootCell, 76) || std::memcmp(cell(rootCell, 76), "nk", 2) != 0) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+
+    // A SYSTEM hive has no CurrentControlSet key; the running system maps it
+    // to the control set that Select\Current names
+    RegistryValue current;
+    if (SUCCEEDED(queryHiveValue(L"Select", L"Current", current)) &&
+        current.type == REG_DWORD && current.data.size() == 4)
+    {
+        wchar_t name[32];
+        swprintf(name, 32, L"ControlSet%03u", readU32(current.data.data()));
+        currentControlSet = name;
+    }
+    return S_OK;
+}
+
+const BYTE* RegfHiveSource::cell(uint32_t offset, uint32_t minSize, uint32_t* payloadSize) const {
+    size_t position = kBaseBlockSize + static_cast<size_t>(offset);
+    if (offset == kNoCell || position + 4 > file.size()) {
+        return nullptr;
+    }
+    int32_t size = static_cast<int32_t>(readU32(file.data() + position));
+    if (size >= 0) {
+        return nullptr;     // free cell
+    }
+    size_t total = static_cast<size_t>(-static_cast<int64_t>(size));
+    if (total < 4 + static_cast<size_t>(minSize) || position + total > file.size()) {
+        return nullptr;
+    }
+    if (payloadSize) {
+        *payloadSize = static_cast<uint32_t>(total - 4);
+    }
+    return file.data() + position + 4;
+}
+
+bool RegfHiveSource::keyNameEquals(uint32_t keyCell, std::wstring_view name) const {
+    uint32_t size = 0;
+    const BYTE* nk = cell(keyCell, 76, &size);
+    if (!nk || std::memcmp(nk, "nk", 2) != 0) {
+        return false;
+    }
+    uint16_t nameBytes = readU16(nk + 72);
+    if (76u + nameBytes > size) {
+        return false;
+    }
+    return storedNameEquals(nk + 76, nameBytes, (readU16(nk + 2) & kKeyCompName) != 0, name);
+}
+
+// Subkey lists: lf (offset + 4-char hint), lh (offset + name hash),
+// li (offsets only) and ri (offsets of further lists)
+uint32_t RegfHiveSource::searchSubkeyList(uint32_t listCell, std::wstring_view name,
+                                          uint32_t nameHash, int depth) const
+{
+    uint32_t size = 0;
+    const BYTE* list = cell(listCell, 4, &size);
+    if (!list || depth > kMaxListDepth) {
+        return kNoCell;
+    }
+    uint16_t count = readU16(list + 2);
+
+    if (std::memcmp(list, "lh", 2) == 0 || std::memcmp(list, "lf", 2) == 0) {
+        bool hashed = list[1] == 'h';
+        if (4u + 8u * count > size) {
+            return kNoCell;
+        }
+        for (uint16_t i = 0; i < count; i++) {
+            const BYTE* entry = list + 4 + 8 * i;
+            if (hashed) {
+                if (readU32(entry + 4) != nameHash) {
+                    continue;
+                }
+            } else {
+                // The hint holds the first four characters (Latin-1, zero-padded)
+                bool hintMatches = true;
+                for (size_t c = 0; c < 4 && c < name.size(); c++) {
+                    if (upcase(static_cast<wchar_t>(entry[4 + c])) != upcase(name[c])) {
+                        hintMatches = false;
+                        break;
+                    }
+                }
+                if (!hintMatches) {
+                    continue;
+                }
+            }
+            uint32_t keyCell = readU32(entry);
+            if (keyNameEquals(keyCell, name)) {
+                return keyCell;
+            }
+        }
+        return kNoCell;
+    }
+
+    if (std::memcmp(list, "li", 2) == 0 || std::memcmp(list, "ri", 2) == 0) {
+        bool indirect = list[0] == 'r';
+        if (4u + 4u * count > size) {
+            return kNoCell;
+        }
+        for (uint16_t i = 0; i < count; i++) {
+            uint32_t target = readU32(list + 4 + 4 * i);
+            if (indirect) {
+                uint32_t found = searchSubkeyList(target, name, nameHash, depth + 1);
+                if (found != kNoCell) {
+                    return found;
+                }
+            } else if (keyNameEquals(target, name)) {
+                return target;
+            }
+        }
+    }
+    return kNoCell;
+}
+
+uint32_t RegfHiveSource::findSubkey(uint32_t keyCell, std::wstring_view name) const {
+    const BYTE* nk = cell(keyCell, 76);
+    if (!nk || readU32(nk + 20) == 0) {
+        return kNoCell;
+    }
+    return searchSubkeyList(readU32(nk + 28), name, lhHash(name), 0);
+}
+
+uint32_t RegfHiveSource::findKey(std::wstring_view hivePath) const {
+    uint32_t key = rootCell;
+    while (!hivePath.empty() && key != kNoCell) {
+        size_t separator = hivePath.find(L'\\');
+        std::wstring_view component = hivePath.substr(0, separator);
+        hivePath = (separator == std::wstring_view::npos) ? std::wstring_view() : hivePath.substr(separator + 1);
+        if (!component.empty()) {
+            key = findSubkey(key, component);
+        }
+    }
+    return key;
+}
+
+HRESULT RegfHiveSource::readValueData(const BYTE* vk, RegistryValue& value) const {
+    uint32_t dataSize = readU32(vk + 4);
+    uint32_t dataOffset = readU32(vk + 8);
+    value.type = readU32(vk + 12);
+    value.data.clear();
+
+    if (dataSize & kDataInline) {
+        dataSize &= ~kDataInline;
+        if (dataSize > 4) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+        value.data.assign(vk + 8, vk + 8 + dataSize);
+        return S_OK;
+    }
+    if (dataSize == 0) {
+        return S_OK;
+    }
+
+    uint32_t cellSize = 0;
+    const BYTE* data = cell(dataOffset, 2, &cellSize);
+    if (!data) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+
+    // Large values (hive 1.4+) are split into segments listed by a db cell
+    if (dataSize > kBigDataSegment && minorVersion >= 4 && std::memcmp(data, "db", 2) == 0) {
+        // Signature, segment count and the segment list's offset
+        if (!cell(dataOffset, 8)) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+        uint16_t segments = readU16(data + 2);
+        uint32_t listSize = 0;
+        const BYTE* list = cell(readU32(data + 4), 4u * segments, &listSize);
+        if (!list) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+        value.data.reserve(dataSize);
+        for (uint16_t i = 0; i < segments && value.data.size() < dataSize; i++) {
+            uint32_t segmentSize = 0;
+            const BYTE* segment = cell(readU32(list + 4 * i), 0, &segmentSize);
+            if (!segment) {
+                return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+            }
+            size_t take = std::min<size_t>({ segmentSize, kBigDataSegment, dataSize - value.data.size() });
+            value.data.insert(value.data.end(), segment, segment + take);
+        }
+        return value.data.size() == dataSize ? S_OK : HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+
+    if (dataSize > cellSize) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+    value.data.assign(data, data + dataSize);
+    return S_OK;
+}
+
+HRESULT RegfHiveSource::queryHiveValue(std::wstring_view hivePath, const std::wstring& valueName,
+                                       RegistryValue& value) const
+{
+    uint32_t key = findKey(hivePath);
+    const BYTE* nk = cell(key, 76);
+    if (!nk) {
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+    }
+
+    uint32_t valueCount = readU32(nk + 36);
+    uint32_t listSize = 0;
+    const BYTE* list = (valueCount > 0) ? cell(readU32(nk + 40), 0, &listSize) : nullptr;
+    if (!list || static_cast<uint64_t>(valueCount) * 4 > listSize) {
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+    }
+
+    for (uint32_t i = 0; i < valueCount; i++) {
+        uint32_t vkSize = 0;
+        const BYTE* vk = cell(readU32(list + 4 * i), 20, &vkSize);
+        if (!vk || std::memcmp(vk, "vk", 2) != 0) {
+            continue;
+        }
+        uint16_t nameBytes = readU16(vk + 2);
+        if (20u + nameBytes > vkSize) {
+            continue;
+        }
+        if (storedNameEquals(vk + 20, nameBytes, (readU16(vk + 16) & kValueCompName) != 0, valueName)) {
+            return readValueData(vk, value);
+        }
+    }
+    return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+}
+
+HRESULT RegfHiveSource::queryValue(const std::wstring& path, const std::wstring& valueName,
+                                   RegistryValue& value) const
+{
+    std::wstring_view hivePath(path);
+    if (!mountPath.empty()) {
+        if (!startsWithComponent(hivePath, mountPath)) {
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+        }
+        hivePath.remove_prefix(std::min(hivePath.size(), mountPath.size() + 1));
+    }
+
+    if (!currentControlSet.empty() && startsWithComponent(hivePath, L"CurrentControlSet")) {
+        std::wstring resolved = currentControlSet;
+        resolved.append(hivePath.substr(std::wstring_view(L"CurrentControlSet").size()));
+        return queryHiveValue(resolved, valueName, value);
+    }
+    return queryHiveValue(hivePath, valueName, value);
+}
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "include/probes/secedit_inf.h"
+#include "include/mapped_file.h"
+#include "include/string_utils.h"
+#include "include/text_decode.h"
+#include "include/well_known_sids.h"
+#include <cwchar>
+
+namespace {
+constexpr DWORD kSecondsPerMinute = 60;
+constexpr DWORD kSecondsPerDay = 24 * 60 * 60;
+
+std::wstring trim(const std::wstring& s, size_t begin, size_t end) {
+    while (begin < end && (s[begin] == L' ' || s[begin] == L'\t')) {
+        begin++;
+    }
+    while (end > begin && (s[end - 1] == L' ' || s[end - 1] == L'\t' || s[end - 1] == L'\r')) {
+        end--;
+    }
+    return s.substr(begin, end - begin);
+}
+
+bool parseNumber(const std::wstring& text, long& number) {
+    if (text.empty()) {
+        return false;
+    }
+    wchar_t* end = nullptr;
+    number = std::wcstol(text.c_str(), &end, 10);
+    return *end == L'\0';
+}
+
+// Days or minutes to seconds; negative means never
+DWORD toSeconds(long value, DWORD unit) {
+    return (value < 0) ? TIMEQ_FOREVER : static_cast<DWORD>(value) * unit;
+}
+
+void applySystemAccess(const std::wstring& key, long value, SeceditPolicy& policy) {
+    PasswordModals& password = policy.password;
+    LockoutModals& lockout = policy.lockout;
+    if (equalsIgnoreCase(key, L"MinimumPasswordAge")) {
+        password.minPasswdAge = toSeconds(value, kSecondsPerDay);
+    } else if (equalsIgnoreCase(key, L"MaximumPasswordAge")) {
+        password.maxPasswdAge = toSeconds(value, kSecondsPerDay);
+    } else if (equalsIgnoreCase(key, L"MinimumPasswordLength")) {
+        password.minPasswdLen = static_cast<DWORD>(value);
+    } else if (equalsIgnoreCase(key, L"PasswordHistorySize")) {
+        password.passwordHistLen = static_cast<DWORD>(value);
+    } else if (equalsIgnoreCase(key, L"ForceLogoffWhenHourExpire")) {
+        password.forceLogoff = (value != 0) ? 0 : TIMEQ_FOREVER;
+    } else if (equalsIgnoreCase(key, L"PasswordComplexity")) {
+        policy.passwordComplexity = (value != 0) ? 1 : 0;
+        return;
+    } else if (equalsIgnoreCase(key, L"ClearTextPassword")) {
+        policy.clearTextPassword = (value != 0) ? 1 : 0;
+        return;
+    } else if (equalsIgnoreCase(key, L"LockoutBadCount")) {
+        lockout.lockoutThreshold = static_cast<DWORD>(value);
+        policy.hasLockoutModals = true;
+        return;
+    } else if (equalsIgnoreCase(key, L"LockoutDuration")) {
+        lockout.lockoutDuration = toSeconds(value, kSecondsPerMinute);
+        policy.hasLockoutModals = true;
+        return;
+    } else if (equalsIgnoreCase(key, L"ResetLockoutCount")) {
+        lockout.lockoutObservationWindow = toSeconds(value, kSecondsPerMinute);
+        policy.hasLockoutModals = true;
+        return;
+    } else {
+        return;
+    }
+    policy.hasPasswordModals = true;
+}
+
+std::vector<std::wstring> parseAccounts(const std::wstring& list) {
+    std::vector<std::wstring> sids;
+    size_t begin = 0;
+    while (begin <= list.size()) {
+        size_t comma = list.find(L',', begin);
+        size_t end = (comma == std::wstring::npos) ? list.size() : comma;
+        std::wstring account = trim(list, begin, end);
+        begin = end + 1;
+        if (account.empty()) {
+            continue;
+        }
+        if (account[0] == L'*') {
+            sids.push_back(account.substr(1));
+        } else {
+            std::wstring_view sid = findWellKnownSid(account);
+            sids.push_back(sid.empty() ? account : std::wstring(sid));
+        }
+    }
+    return sids;
+}
+}
+
+HRESULT SeceditInf::parse(const BYTE* data, size_t size, SeceditPolicy& policy) {
+    policy = SeceditPolicy();
+    if (!data || size == 0) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+
+    enum class Section { Other, SystemAccess, PrivilegeRights };
+    std::wstring text = decodeText(data, size);
+    Section section = Section::Other;
+    bool sawSection = false;
+
+    size_t lineStart = 0;
+    while (lineStart < text.size()) {
+        size_t lineEnd = text.find(L'\n', lineStart);
+        if (lineEnd == std::wstring::npos) {
+            lineEnd = text.size();
+        }
+        std::wstring line = trim(text, lineStart, lineEnd);
+        lineStart = lineEnd + 1;
+        if (line.empty() || line[0] == L';') {
+            continue;
+        }
+
+        if (line[0] == L'[') {
+            size_t close = line.find(L']');
+            std::wstring name = line.substr(1, (close == std::wstring::npos ? line.size() : close) - 1);
+            if (equalsIgnoreCase(name, L"System Access")) {
+                section = Section::SystemAccess;
+            } else if (equalsIgnoreCase(name, L"Privilege Rights")) {
+                section = Section::PrivilegeRights;
+                policy.hasPrivilegeRights = true;
+            } else {
+                section = Section::Other;
+            }
+            sawSection = true;
+            continue;
+        }
+        if (section == Section::Other) {
+            continue;
+        }
+
+        size_t equals = line.find(L'=');
+        if (equals == std::wstring::npos) {
+            continue;
+        }
+        std::wstring key = trim(line, 0, equals);
+        std::wstring value = trim(line, equals + 1, line.size());
+
+        if (section == Section::SystemAccess) {
+            long number = 0;
+            if (parseNumber(value, number)) {
+                applySystemAccess(key, number, policy);
+            }
+        } else {
+            policy.rights[key] = parseAccounts(value);
+        }
+    }
+    return sawSection ? S_OK : HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+}
+
+HRESULT SeceditInf::load(const std::string& fileName, SeceditPolicy& policy) {
+    MappedFile file;
+    HRESULT hr = file.open(fileName);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    return parse(file.data(), file.size(), policy);
+}
\ No newline at end of file
@@ -0,0 +1,427 @@
+#include "include/probes/snapshot_bundle.h"
+#include "include/probes/auditpol_csv.h"
+#include "include/probes/reg_export_source.h"
+#include "include/probes/regf_hive_source.h"
+#include "include/probes/secedit_inf.h"
+#include "include/string_utils.h"
+#include <algorithm>
+#include <filesystem>
+#include <ostream>
+
+namespace {
+const wchar_t* const kHiveNames[] = { L"SYSTEM", L"SOFTWARE", L"SECURITY", L"SAM" };
+const char kRegExportName[] = "registry.reg";
+const char kAuditpolCsvName[] = "auditpol.csv";
+const char kSeceditInfName[] = "secedit.inf";
+const char kCollectionName[] = "collection.txt";
+const char kImageName[] = "snapshot.img";
+
+// An audit policy file is the whole policy, even with no subcategories in it
+void applyAuditSettings(SnapshotProbe& snapshot, const std::vector<AuditSubcategorySetting>& settings) {
+    snapshot.markLoaded(SnapshotProbe::ListData::AuditPolicy);
+    for (const AuditSubcategorySetting& setting : settings) {
+        snapshot.setAuditSubcategory(setting.subcategory, setting.inclusionSetting, setting.guid);
+    }
+}
+
+void applySeceditPolicy(SnapshotProbe& snapshot, const SeceditPolicy& policy) {
+    if (policy.hasPasswordModals) {
+        snapshot.setPasswordModals(policy.password);
+    }
+    if (policy.hasLockoutModals) {
+        snapshot.setLockoutModals(policy.lockout);
+    }
+    if (policy.passwordComplexity && policy.clearTextPassword) {
+        snapshot.setPasswordProperties(PasswordProperties{ *policy.passwordComplexity, *policy.clearTextPassword });
+    }
+    if (policy.hasPrivilegeRights) {
+        snapshot.markLoaded(SnapshotProbe::ListData::Rights);
+    }
+    for (const auto& right : policy.rights) {
+        snapshot.setAccountsWithRight(right.first, right.second);
+    }
+}
+
+void applyCollection(SnapshotProbe& snapshot, const HostCollection& collection) {
+    if (collection.password) {
+        snapshot.setPasswordModals(*collection.password);
+    }
+    if (collection.lockout) {
+        snapshot.setLockoutModals(*collection.lockout);
+    }
+    if (collection.passwordProperties) {
+        snapshot.setPasswordProperties(*collection.passwordProperties);
+    }
+    for (const auto& user : collection.users) {
+        snapshot.setUserInfo(user.first, user.second);
+    }
+    for (const auto& group : collection.groups) {
+        snapshot.setLocalGroupMembers(group.first, group.second);
+    }
+    for (const auto& service : collection.services) {
+        snapshot.setServiceConfig(service.name, service.config);
+    }
+    for (const auto& right : collection.rights) {
+        snapshot.setAccountsWithRight(right.first, right.second);
+    }
+    for (const auto& setting : collection.auditPolicy) {
+        snapshot.setAuditSubcategory(setting.subcategory, setting.inclusionSetting, setting.guid);
+    }
+
+    // Failed reads fail again here; registry failures go with the values
+    using Query = HostCollection::Query;
+    using ListData = SnapshotProbe::ListData;
+    for (const auto& status : collection.statuses) {
+        if (status.query == Query::Services || status.query == Query::AuditPolicy) {
+            ListData kind = (status.query == Query::Services) ? ListData::Services : ListData::AuditPolicy;
+            if (SUCCEEDED(status.status)) {
+                snapshot.markLoaded(kind);
+            } else {
+                snapshot.setListFailure(kind, status.status);
+            }
+        } else if (status.query == Query::Service) {
+            snapshot.setServiceFailure(status.name, status.status);
+        } else if (status.query == Query::Right) {
+            snapshot.setRightFailure(status.name, status.status);
+        }
+    }
+}
+
+// Policy records of an image; a delta's are laid over its baseline's
+HRESULT readImagePolicy(const SnapshotImage& image, HostCollection& policy) {
+    if (!image.isDelta()) {
+        return SnapshotImage::parsePolicy(image.policyData(), image.policySize(), policy);
+    }
+    const SnapshotImage& base = *image.getBaseline();
+    HRESULT hr = SnapshotImage::parsePolicy(base.policyData(), base.policySize(), policy);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    PolicyDelta delta;
+    hr = SnapshotImage::parsePolicyDelta(image.policyData(), image.policySize(), delta);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    delta.applyTo(policy);
+    return S_OK;
+}
+
+void applyCollectedRegistry(SnapshotProbe& snapshot, const HostCollection& collection) {
+    for (const auto& entry : collection.registry) {
+        snapshot.setRegistryValue(entry.path, entry.valueName, entry.value);
+    }
+    for (const auto& status : collection.statuses) {
+        if (status.query == HostCollection::Query::Registry) {
+            snapshot.setRegistryFailure(status.name, status.valueName, status.status);
+        }
+    }
+}
+}
+
+SnapshotBundle SnapshotBundle::fromDirectory(const std::string& directory) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    auto present = [&](const std::string& name) {
+        return fs::is_regular_file(fs::path(directory) / name, ec);
+    };
+
+    SnapshotBundle bundle;
+    if (present(kRegExportName)) {
+        bundle.regExport = (fs::path(directory) / kRegExportName).string();
+    }
+    for (const wchar_t* hiveName : kHiveNames) {
+        if (present(narrow(hiveName))) {
+            bundle.hiveDir = directory;
+            break;
+        }
+    }
+    if (present(kAuditpolCsvName)) {
+        bundle.auditpolCsv = (fs::path(directory) / kAuditpolCsvName).string();
+    }
+    if (present(kSeceditInfName)) {
+        bundle.seceditInf = (fs::path(directory) / kSeceditInfName).string();
+    }
+    if (present(kCollectionName)) {
+        bundle.collection = (fs::path(directory) / kCollectionName).string();
+    }
+    if (present(kImageName)) {
+        bundle.image = (fs::path(directory) / kImageName).string();
+    }
+    return bundle;
+}
+
+bool SnapshotBundle::empty() const {
+    return regExport.empty() && hiveDir.empty() && auditpolCsv.empty() && seceditInf.empty()
+        && collection.empty() && image.empty() && userHiveDir.empty();
+}
+
+HRESULT SnapshotBundle::load(std::shared_ptr<SnapshotProbe>& probe, std::string& failedFile,
+                             std::ostream* log) const
+{
+    auto snapshot = std::make_shared<SnapshotProbe>();
+
+    HRESULT hr = loadRegistry(*snapshot, failedFile, log);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    if (!auditpolCsv.empty()) {
+        std::vector<AuditSubcategorySetting> settings;
+        hr = AuditpolCsv::load(auditpolCsv, settings);
+        if (FAILED(hr)) {
+            failedFile = auditpolCsv;
+            return hr;
+        }
+        if (log) {
+            *log << "Loaded " << settings.size() << " audit subcategories from " << auditpolCsv << "\n";
+        }
+        applyAuditSettings(*snapshot, settings);
+    }
+
+    if (!seceditInf.empty()) {
+        SeceditPolicy policy;
+        hr = SeceditInf::load(seceditInf, policy);
+        if (FAILED(hr)) {
+            failedFile = seceditInf;
+            return hr;
+        }
+        if (log) {
+            *log << "Loaded " << policy.rights.size() << " user rights from " << seceditInf << "\n";
+        }
+        applySeceditPolicy(*snapshot, policy);
+    }
+
+    if (!collection.empty()) {
+        HostCollection collected;
+        hr = HostCollectionFile::load(collection, collected);
+        if (FAILED(hr)) {
+            failedFile = collection;
+            return hr;
+        }
+        if (log) {
+            *log << "Loaded " << collected.registry.size() << " registry values, "
+                 << collected.services.size() << " services from " << collection << "\n";
+        }
+        applyCollectedRegistry(*snapshot, collected);
+        applyCollection(*snapshot, collected);
+    }
+
+    if (!image.empty()) {
+        // Registry lookups are answered from the mapping itself
+        std::shared_ptr<SnapshotImage> opened;
+        HostCollection policy;
+        hr = SnapshotImage::open(image, opened, baseline);
+        if (SUCCEEDED(hr)) {
+            hr = readImagePolicy(*opened, policy);
+        }
+        if (FAILED(hr)) {
+            failedFile = image;
+            return hr;
+        }
+        if (log) {
+            *log << "Mapped " << opened->getValueCount() << " registry values, "
+                 << policy.services.size() << " services from " << image
+                 << (opened->isDelta() ? " over its baseline" : "") << "\n";
+        }
+        snapshot->addRegistrySource(opened);
+        applyCollectedRegistry(*snapshot, policy);
+        applyCollection(*snapshot, policy);
+    }
+
+    hr = loadUserProfiles(*snapshot, failedFile, log);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    probe = std::move(snapshot);
+    return S_OK;
+}
+
+HRESULT SnapshotBundle::loadShared(SubtreeStore& store, std::shared_ptr<SnapshotProbe>& probe,
+                                   SnapshotContent& content, std::string& failedFile) const
+{
+    // A collection is parsed once per distinct content; its registry values
+    // are interned per key like those of the registry files
+    content = SnapshotContent();
+    std::shared_ptr<const HostCollection> collected;
+    if (!collection.empty()) {
+        HRESULT hr = store.internFile(collection, &HostCollectionFile::parse, collected, content.collectionId);
+        if (FAILED(hr)) {
+            failedFile = collection;
+            return hr;
+        }
+    }
+
+    // The registry files and the image are only open while the declared
+    // values are read out of them
+    std::shared_ptr<const HostCollection> imagePolicy;
+    std::vector<std::shared_ptr<const RegistrySubtree>> subtrees;
+    {
+        SnapshotProbe files;
+        HRESULT hr = loadRegistry(files, failedFile, nullptr);
+        if (FAILED(hr)) {
+            return hr;
+        }
+        if (collected) {
+            applyCollectedRegistry(files, *collected);
+        }
+        if (!image.empty()) {
+            std::shared_ptr<SnapshotImage> opened;
+            hr = SnapshotImage::open(image, opened, baseline);
+            if (SUCCEEDED(hr)) {
+                // The baseline's policy is parsed once for the fleet, each
+                // distinct delta once, and each distinct overlay once
+                const SnapshotImage& policySource = opened->isDelta() ? *baseline : *opened;
+                hr = store.internData(policySource.policyData(), policySource.policySize(),
+                                      &SnapshotImage::parsePolicy, imagePolicy, content.imagePolicyId);
+            }
+            if (SUCCEEDED(hr) && opened->isDelta()) {
+                std::shared_ptr<const PolicyDelta> delta;
+                hr = store.internData(opened->policyData(), opened->policySize(), &SnapshotImage::parsePolicyDelta,
+                                      delta, content.imageDeltaId);
+                if (SUCCEEDED(hr)) {
+                    imagePolicy = store.internMerged<HostCollection>(content.imagePolicyId, content.imageDeltaId, [&] {
+                        HostCollection merged = *imagePolicy;
+                        delta->applyTo(merged);
+                        return merged;
+                    });
+                }
+            }
+            if (FAILED(hr)) {
+                failedFile = image;
+                return hr;
+            }
+            files.addRegistrySource(opened);
+            applyCollectedRegistry(files, *imagePolicy);
+        }
+        subtrees = store.ingest(files);
+    }
+
+    auto snapshot = std::make_shared<SnapshotProbe>();
+    content.subtreeIds.reserve(subtrees.size());
+    for (const auto& subtree : subtrees) {
+        content.subtreeIds.push_back(subtree->id);
+    }
+    snapshot->addRegistrySource(std::make_shared<SubtreeSource>(store, std::move(subtrees)));
+
+    if (!auditpolCsv.empty()) {
+        std::shared_ptr<const std::vector<AuditSubcategorySetting>> settings;
+        HRESULT hr = store.internFile(auditpolCsv, &AuditpolCsv::parse, settings, content.auditpolId);
+        if (FAILED(hr)) {
+            failedFile = auditpolCsv;
+            return hr;
+        }
+        applyAuditSettings(*snapshot, *settings);
+    }
+
+    if (!seceditInf.empty()) {
+        std::shared_ptr<const SeceditPolicy> policy;
+        HRESULT hr = store.internFile(seceditInf, &SeceditInf::parse, policy, content.seceditId);
+        if (FAILED(hr)) {
+            failedFile = seceditInf;
+            return hr;
+        }
+        applySeceditPolicy(*snapshot, *policy);
+    }
+
+    if (collected) {
+        applyCollection(*snapshot, *collected);
+    }
+    if (imagePolicy) {
+        applyCollection(*snapshot, *imagePolicy);
+    }
+
+    probe = std::move(snapshot);
+    return S_OK;
+}
+
+HRESULT SnapshotBundle::loadRegistry(SnapshotProbe& snapshot, std::string& failedFile,
+                                     std::ostream* log) const
+{
+    if (!regExport.empty()) {
+        std::shared_ptr<RegExportSource> source;
+        HRESULT hr = RegExportSource::load(regExport, source);
+        if (FAILED(hr)) {
+            failedFile = regExport;
+            return hr;
+        }
+        if (log) {
+            *log << "Loaded " << source->getKeyCount() << " keys, "
+                 << source->getValueCount() << " values from " << regExport << "\n";
+        }
+        snapshot.addRegistrySource(source);
+    }
+
+    if (!hiveDir.empty()) {
+        // Each hive file is mounted where Windows loads it under HKLM
+        int mounted = 0;
+        for (const wchar_t* hiveName : kHiveNames) {
+            std::string fileName = (std::filesystem::path(hiveDir) / narrow(hiveName)).string();
+            std::shared_ptr<RegfHiveSource> hive;
+            HRESULT hr = RegfHiveSource::load(fileName, hiveName, hive);
+            if (hr == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)) {
+                continue;
+            }
+            if (FAILED(hr)) {
+                failedFile = fileName;
+                return hr;
+            }
+            snapshot.addRegistrySource(hive);
+            mounted++;
+        }
+        if (mounted == 0) {
+            failedFile = hiveDir;
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+        }
+        if (log) {
+            *log << "Mounted " << mounted << " hive(s) from " << hiveDir << "\n";
+        }
+    }
+    return S_OK;
+}
+
+HRESULT SnapshotBundle::loadUserProfiles(SnapshotProbe& snapshot, std::string& failedFile,
+                                         std::ostream* log) const
+{
+    if (userHiveDir.empty()) {
+        return S_OK;
+    }
+    snapshot.markLoaded(SnapshotProbe::ListData::UserProfiles);
+
+    // Only the profiles are recorded here; a hive is opened when a per-user
+    // check first reads it
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    std::vector<UserProfile> profiles;
+    for (fs::directory_iterator it(userHiveDir, ec), end; !ec && it != end; it.increment(ec)) {
+        const fs::path& path = it->path();
+        UserProfile profile;
+        if (it->is_directory(ec) && fs::is_regular_file(path / "NTUSER.DAT", ec)) {
+            profile.sid = path.filename().wstring();
+            profile.hiveFile = (path / "NTUSER.DAT").string();
+        } else if (it->is_regular_file(ec) && equalsIgnoreCase(path.extension().wstring(), L".DAT")) {
+            profile.sid = path.stem().wstring();
+            profile.hiveFile = path.string();
+        } else {
+            continue;
+        }
+        if (profile.sid.compare(0, 4, L"S-1-") == 0) {
+            profiles.push_back(std::move(profile));
+        }
+    }
+    if (ec) {
+        failedFile = userHiveDir;
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+    }
+
+    std::sort(profiles.begin(), profiles.end(), [](const UserProfile& a, const UserProfile& b) {
+        return a.sid < b.sid;
+    });
+    if (log) {
+        *log << "Found " << profiles.size() << " user hive(s) in " << userHiveDir << "\n";
+    }
+    for (UserProfile& profile : profiles) {
+        snapshot.addUserProfile(std::move(profile));
+    }
+    return S_OK;
+}
\ No newline at end of file
@@ -0,0 +1,973 @@
+#include "include/probes/snapshot_image.h"
+#include "include/string_utils.h"
+#include <algorithm>
+#include <cstring>
+#include <cwctype>
+#include <map>
+#include <ostream>
+#include <set>
+
+namespace {
+const char kMagic[8] = { 'W', '1', '1', 'S', 'N', 'A', 'P', 'I' };
+constexpr uint32_t kVersion = 2;
+constexpr size_t kAlignment = 8;
+constexpr uint32_t kDeltaImage = 0x1;
+
+// Type of a delta's registry record for a value the baseline has and the
+// host does not
+constexpr DWORD kRemovedValue = 0xFFFFFFFF;
+
+struct BlockRef {
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    BlockRef registry;
+    BlockRef policy;
+    uint64_t contentHash;       // FNV-1a of both blocks
+    uint64_t baselineHash;      // of the baseline, for a delta
+};
+
+// A block starts with its table count and one TableRef per table. Newer
+// versions may append tables; readers ignore the ones they do not know.
+struct BlockHeader {
+    uint32_t tableCount;
+    uint32_t reserved;
+};
+
+struct TableRef {
+    uint32_t offset;    // from the start of the block
+    uint32_t count;     // elements
+};
+
+// Tables 0 and 1 of every block are its string table
+enum BlockTable : uint32_t { kStringOffsets = 0, kStringChars = 1 };
+enum RegistryTable : uint32_t { kRegIndex = 2, kRegValues, kRegData, kRegistryTableCount };
+// kPolProperties and the tables after it were appended after the first
+// version-2 images were written, so a policy block needs only the tables
+// before it
+enum PolicyTable : uint32_t {
+    kPolModals = 2, kPolUsers, kPolGroups, kPolServices, kPolRights, kPolAudit, kPolLists, kPolRemoved,
+    kPolProperties, kPolStatuses, kPolRemovedStatuses, kPolicyTableCount
+};
+
+struct IndexEntry {
+    uint64_t hash;
+    uint32_t record;
+    uint32_t reserved;
+};
+
+struct ValueRecord {
+    uint32_t path;
+    uint32_t name;
+    uint32_t type;
+    uint32_t dataOffset;
+    uint32_t dataSize;
+};
+
+constexpr uint32_t kHasPassword = 0x1;
+constexpr uint32_t kHasLockout = 0x2;
+
+struct ModalsRecord {
+    uint32_t present;
+    uint32_t minPasswdLen;
+    uint32_t maxPasswdAge;
+    uint32_t minPasswdAge;
+    uint32_t forceLogoff;
+    uint32_t passwordHistLen;
+    uint32_t lockoutDuration;
+    uint32_t lockoutObservationWindow;
+    uint32_t lockoutThreshold;
+};
+
+struct PropertiesRecord {
+    uint32_t passwordComplexity;
+    uint32_t clearTextPassword;
+};
+
+struct UserRecord {
+    uint32_t queriedName;
+    uint32_t name;
+    uint32_t flags;
+};
+
+// A group with its members, or a right with its SIDs, as a run of the list table
+struct ListRecord {
+    uint32_t name;
+    uint32_t first;
+    uint32_t count;
+};
+
+struct ServiceRecord {
+    uint32_t name;
+    uint32_t startType;
+    uint32_t currentState;
+};
+
+struct AuditRecord {
+    uint32_t subcategory;
+    uint32_t guid;
+    uint32_t setting;
+};
+
+struct StatusRecord {
+    uint32_t query;
+    uint32_t name;
+    uint32_t valueName;
+    uint32_t status;
+};
+
+// What a delta removes from its baseline, by name (audit settings by GUID)
+enum RemovedKind : uint32_t { kRemovedUser = 1, kRemovedGroup, kRemovedService, kRemovedRight, kRemovedAudit };
+
+struct RemovedRecord {
+    uint32_t kind;
+    uint32_t name;
+};
+
+static_assert(sizeof(FileHeader) == 48 && sizeof(IndexEntry) == 16 && sizeof(ValueRecord) == 20
+              && sizeof(ModalsRecord) == 36, "image records are fixed-width");
+
+inline char16_t foldCase(char16_t c) {
+    if (c < 0x80) {
+        return (c >= u'A' && c <= u'Z') ? static_cast<char16_t>(c + (u'a' - u'A')) : c;
+    }
+    return static_cast<char16_t>(towlower(c));
+}
+
+std::u16string toUtf16(const std::wstring& s) {
+    std::u16string out;
+    out.reserve(s.size());
+    for (wchar_t ch : s) {
+        uint32_t cp = static_cast<uint32_t>(ch);
+        if (cp >= 0x10000) {
+            cp -= 0x10000;
+            out.push_back(static_cast<char16_t>(0xD800 + (cp >> 10)));
+            out.push_back(static_cast<char16_t>(0xDC00 + (cp & 0x3FF)));
+        } else {
+            out.push_back(static_cast<char16_t>(cp));
+        }
+    }
+    return out;
+}
+
+std::wstring toWide(std::u16string_view s) {
+    std::wstring out;
+    out.reserve(s.size());
+    for (size_t i = 0; i < s.size(); i++) {
+        uint32_t unit = s[i];
+        if (sizeof(wchar_t) > 2 && unit >= 0xD800 && unit < 0xDC00 && i + 1 < s.size()
+            && s[i + 1] >= 0xDC00 && s[i + 1] < 0xE000) {
+            out.push_back(static_cast<wchar_t>(0x10000 + ((unit - 0xD800) << 10) + (s[i + 1] - 0xDC00)));
+            i++;
+            continue;
+        }
+        out.push_back(static_cast<wchar_t>(unit));
+    }
+    return out;
+}
+
+bool equalsFolded(std::u16string_view a, std::u16string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (foldCase(a[i]) != foldCase(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// FNV-1a over the case-folded path, a separator and the folded value name
+uint64_t hashValueKey(std::u16string_view path, std::u16string_view name) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](char16_t c) {
+        hash = (hash ^ c) * 1099511628211ull;
+    };
+    for (char16_t c : path) {
+        mix(foldCase(c));
+    }
+    mix(u'\n');
+    for (char16_t c : name) {
+        mix(foldCase(c));
+    }
+    return hash;
+}
+
+/**
+ * Bounds-checked view of one block in a mapping. Tables are used in place;
+ * a table that does not fit the block, or that the block does not have,
+ * reads as empty.
+ */
+class BlockView {
+public:
+    bool init(const BYTE* data, size_t size, uint32_t requiredTables) {
+        if (size < sizeof(BlockHeader)) {
+            return false;
+        }
+        const auto* header = reinterpret_cast<const BlockHeader*>(data);
+        if (header->tableCount < requiredTables
+            || (size - sizeof(BlockHeader)) / sizeof(TableRef) < header->tableCount) {
+            return false;
+        }
+        base = data;
+        length = size;
+        tableCount = header->tableCount;
+        tables = reinterpret_cast<const TableRef*>(data + sizeof(BlockHeader));
+        return true;
+    }
+
+    template <typename T>
+    const T* table(uint32_t index, uint32_t& count) const {
+        count = 0;
+        if (index >= tableCount) {
+            return nullptr;
+        }
+        const TableRef& ref = tables[index];
+        if (ref.offset % alignof(T) != 0 || ref.offset > length
+            || (length - ref.offset) / sizeof(T) < ref.count) {
+            return nullptr;
+        }
+        count = ref.count;
+        return reinterpret_cast<const T*>(base + ref.offset);
+    }
+
+    bool string(uint32_t id, std::u16string_view& s) const {
+        uint32_t offsetCount = 0;
+        uint32_t charCount = 0;
+        const uint32_t* offsets = table<uint32_t>(kStringOffsets, offsetCount);
+        const char16_t* chars = table<char16_t>(kStringChars, charCount);
+        if (offsetCount == 0 || id >= offsetCount - 1 || offsets[id] > offsets[id + 1]
+            || offsets[id + 1] > charCount) {
+            return false;
+        }
+        s = std::u16string_view(chars + offsets[id], offsets[id + 1] - offsets[id]);
+        return true;
+    }
+
+    bool string(uint32_t id, std::wstring& s) const {
+        std::u16string_view view;
+        if (!string(id, view)) {
+            return false;
+        }
+        s = toWide(view);
+        return true;
+    }
+
+private:
+    const BYTE* base = nullptr;
+    size_t length = 0;
+    uint32_t tableCount = 0;
+    const TableRef* tables = nullptr;
+};
+
+class StringTable {
+public:
+    uint32_t intern(const std::wstring& s) {
+        std::u16string units = toUtf16(s);
+        auto it = ids.find(units);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        uint32_t id = static_cast<uint32_t>(offsets.size() - 1);
+        chars += units;
+        offsets.push_back(static_cast<uint32_t>(chars.size()));
+        ids.emplace(std::move(units), id);
+        return id;
+    }
+
+    std::vector<uint32_t> offsets{ 0 };
+    std::u16string chars;
+
+private:
+    std::map<std::u16string, uint32_t> ids;
+};
+
+class BlockWriter {
+public:
+    explicit BlockWriter(uint32_t tableCount) : tables(tableCount) {}
+
+    template <typename T>
+    void set(uint32_t index, const T* items, size_t count) {
+        tables[index].bytes.assign(reinterpret_cast<const BYTE*>(items),
+                                   reinterpret_cast<const BYTE*>(items + count));
+        tables[index].count = static_cast<uint32_t>(count);
+    }
+
+    template <typename T>
+    void set(uint32_t index, const std::vector<T>& items) {
+        set(index, items.data(), items.size());
+    }
+
+    void setStrings(const StringTable& strings) {
+        set(kStringOffsets, strings.offsets);
+        set(kStringChars, strings.chars.data(), strings.chars.size());
+    }
+
+    std::vector<BYTE> finish() const {
+        size_t offset = sizeof(BlockHeader) + tables.size() * sizeof(TableRef);
+        std::vector<TableRef> refs;
+        for (const auto& table : tables) {
+            offset = align(offset);
+            refs.push_back(TableRef{ static_cast<uint32_t>(offset), table.count });
+            offset += table.bytes.size();
+        }
+
+        std::vector<BYTE> block(align(offset), 0);
+        BlockHeader header{ static_cast<uint32_t>(tables.size()), 0 };
+        std::memcpy(block.data(), &header, sizeof(header));
+        std::memcpy(block.data() + sizeof(header), refs.data(), refs.size() * sizeof(TableRef));
+        for (size_t i = 0; i < tables.size(); i++) {
+            if (!tables[i].bytes.empty()) {
+                std::memcpy(block.data() + refs[i].offset, tables[i].bytes.data(), tables[i].bytes.size());
+            }
+        }
+        return block;
+    }
+
+    static size_t align(size_t offset) {
+        return (offset + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+private:
+    struct Table {
+        std::vector<BYTE> bytes;
+        uint32_t count = 0;
+    };
+    std::vector<Table> tables;
+};
+
+std::vector<BYTE> writeRegistryBlock(const HostCollection& collection) {
+    // The last value of a case-insensitively repeated path and name wins
+    std::map<std::u16string, const HostCollection::RegistryEntry*> unique;
+    for (const auto& entry : collection.registry) {
+        std::u16string key = toUtf16(entry.path) + u'\n' + toUtf16(entry.valueName);
+        for (auto& c : key) {
+            c = foldCase(c);
+        }
+        unique[key] = &entry;
+    }
+
+    StringTable strings;
+    std::vector<ValueRecord> values;
+    std::vector<IndexEntry> index;
+    std::vector<BYTE> data;
+    for (const auto& item : unique) {
+        const HostCollection::RegistryEntry& entry = *item.second;
+        ValueRecord record{ strings.intern(entry.path), strings.intern(entry.valueName), entry.value.type,
+                            static_cast<uint32_t>(data.size()), static_cast<uint32_t>(entry.value.data.size()) };
+        data.insert(data.end(), entry.value.data.begin(), entry.value.data.end());
+        index.push_back(IndexEntry{ hashValueKey(toUtf16(entry.path), toUtf16(entry.valueName)),
+                                    static_cast<uint32_t>(values.size()), 0 });
+        values.push_back(record);
+    }
+    std::sort(index.begin(), index.end(), [](const IndexEntry& a, const IndexEntry& b) {
+        return a.hash < b.hash || (a.hash == b.hash && a.record < b.record);
+    });
+
+    BlockWriter block(kRegistryTableCount);
+    block.setStrings(strings);
+    block.set(kRegIndex, index);
+    block.set(kRegValues, values);
+    block.set(kRegData, data);
+    return block.finish();
+}
+
+// A full image's policy is a delta from nothing
+std::vector<BYTE> writePolicyBlock(const PolicyDelta& policy) {
+    const HostCollection& collection = policy.changed;
+    StringTable strings;
+    std::vector<uint32_t> lists;
+    auto appendList = [&](const std::pair<std::wstring, std::vector<std::wstring>>& entry) {
+        ListRecord record{ strings.intern(entry.first), static_cast<uint32_t>(lists.size()),
+                           static_cast<uint32_t>(entry.second.size()) };
+        for (const auto& item : entry.second) {
+            lists.push_back(strings.intern(item));
+        }
+        return record;
+    };
+
+    std::vector<ModalsRecord> modals;
+    if (policy.replacesModals) {
+        ModalsRecord record{};
+        if (const auto& p = collection.password) {
+            record.present |= kHasPassword;
+            record.minPasswdLen = p->minPasswdLen;
+            record.maxPasswdAge = p->maxPasswdAge;
+            record.minPasswdAge = p->minPasswdAge;
+            record.forceLogoff = p->forceLogoff;
+            record.passwordHistLen = p->passwordHistLen;
+        }
+        if (const auto& l = collection.lockout) {
+            record.present |= kHasLockout;
+            record.lockoutDuration = l->lockoutDuration;
+            record.lockoutObservationWindow = l->lockoutObservationWindow;
+            record.lockoutThreshold = l->lockoutThreshold;
+        }
+        modals.push_back(record);
+    }
+    std::vector<PropertiesRecord> properties;
+    if (const auto& p = collection.passwordProperties) {
+        properties.push_back(PropertiesRecord{ p->passwordComplexity, p->clearTextPassword });
+    }
+
+    std::vector<UserRecord> users;
+    for (const auto& user : collection.users) {
+        users.push_back(UserRecord{ strings.intern(user.first), strings.intern(user.second.name), user.second.flags });
+    }
+    std::vector<ListRecord> groups;
+    for (const auto& group : collection.groups) {
+        groups.push_back(appendList(group));
+    }
+    std::vector<ServiceRecord> services;
+    for (const auto& service : collection.services) {
+        services.push_back(ServiceRecord{ strings.intern(service.name), service.config.startType,
+                                          service.config.currentState });
+    }
+    std::vector<ListRecord> rights;
+    for (const auto& right : collection.rights) {
+        rights.push_back(appendList(right));
+    }
+    std::vector<AuditRecord> audit;
+    for (const auto& setting : collection.auditPolicy) {
+        audit.push_back(AuditRecord{ strings.intern(setting.subcategory), strings.intern(setting.guid),
+                                     strings.intern(setting.inclusionSetting) });
+    }
+    std::vector<RemovedRecord> removed;
+    auto appendRemoved = [&](RemovedKind kind, const std::vector<std::wstring>& names) {
+        for (const auto& name : names) {
+            removed.push_back(RemovedRecord{ kind, strings.intern(name) });
+        }
+    };
+    appendRemoved(kRemovedUser, policy.removedUsers);
+    appendRemoved(kRemovedGroup, policy.removedGroups);
+    appendRemoved(kRemovedService, policy.removedServices);
+    appendRemoved(kRemovedRight, policy.removedRights);
+    appendRemoved(kRemovedAudit, policy.removedAudit);
+
+    std::vector<StatusRecord> statuses;
+    for (const auto& status : collection.statuses) {
+        statuses.push_back(StatusRecord{ static_cast<uint32_t>(status.query), strings.intern(status.name),
+                                         strings.intern(status.valueName), static_cast<uint32_t>(status.status) });
+    }
+    // Kept apart from kPolRemoved, whose unknown kinds older readers reject
+    std::vector<uint32_t> removedStatuses;
+    for (const auto& key : policy.removedStatuses) {
+        removedStatuses.push_back(strings.intern(key));
+    }
+
+    BlockWriter block(kPolicyTableCount);
+    block.setStrings(strings);
+    block.set(kPolModals, modals);
+    block.set(kPolUsers, users);
+    block.set(kPolGroups, groups);
+    block.set(kPolServices, services);
+    block.set(kPolRights, rights);
+    block.set(kPolAudit, audit);
+    block.set(kPolLists, lists);
+    block.set(kPolRemoved, removed);
+    block.set(kPolProperties, properties);
+    block.set(kPolStatuses, statuses);
+    block.set(kPolRemovedStatuses, removedStatuses);
+    return block.finish();
+}
+
+void writeImage(const std::vector<BYTE>& registry, const std::vector<BYTE>& policy, uint32_t flags,
+                uint64_t baselineHash, std::ostream& out)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const std::vector<BYTE>* block : { &registry, &policy }) {
+        for (BYTE b : *block) {
+            hash = (hash ^ b) * 1099511628211ull;
+        }
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.flags = flags;
+    header.registry = BlockRef{ static_cast<uint32_t>(sizeof(FileHeader)), static_cast<uint32_t>(registry.size()) };
+    header.policy = BlockRef{ static_cast<uint32_t>(sizeof(FileHeader) + registry.size()),
+                              static_cast<uint32_t>(policy.size()) };
+    header.contentHash = hash;
+    header.baselineHash = baselineHash;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(registry.data()), registry.size());
+    out.write(reinterpret_cast<const char*>(policy.data()), policy.size());
+}
+
+// Audit settings are matched by GUID when they have one, as SnapshotProbe does
+std::wstring auditKey(const AuditSubcategorySetting& setting) {
+    return toLowerCopy(setting.guid.empty() ? setting.subcategory : setting.guid);
+}
+
+std::wstring statusKey(const HostCollection::QueryStatus& status) {
+    return std::to_wstring(static_cast<uint32_t>(status.query)) + L'\n' + toLowerCopy(status.name) + L'\n'
+        + toLowerCopy(status.valueName);
+}
+
+/**
+ * Replaces or appends the records of `changes` in `records` and drops
+ * those named in `removed`, matching names with `keyOf`.
+ */
+template <typename T, typename KeyOf>
+void overlay(std::vector<T>& records, const std::vector<T>& changes, const std::vector<std::wstring>& removed,
+             KeyOf keyOf)
+{
+    std::map<std::wstring, size_t> index;
+    for (size_t i = 0; i < records.size(); i++) {
+        index[keyOf(records[i])] = i;
+    }
+    std::vector<bool> dropped(records.size(), false);
+    for (const auto& name : removed) {
+        auto it = index.find(toLowerCopy(name));
+        if (it != index.end()) {
+            dropped[it->second] = true;
+        }
+    }
+    for (const auto& change : changes) {
+        auto it = index.find(keyOf(change));
+        if (it != index.end()) {
+            records[it->second] = change;
+            dropped[it->second] = false;
+        } else {
+            index[keyOf(change)] = records.size();
+            records.push_back(change);
+            dropped.push_back(false);
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < records.size(); i++) {
+        if (!dropped[i]) {
+            if (kept != i) {
+                records[kept] = std::move(records[i]);
+            }
+            kept++;
+        }
+    }
+    records.resize(kept);
+}
+
+/**
+ * What of `records` differs from `base`: records new or changed on the
+ * host go to `changes`, names only the baseline has to `removed`.
+ */
+template <typename T, typename KeyOf, typename Same>
+void diff(const std::vector<T>& base, const std::vector<T>& records, std::vector<T>& changes,
+          std::vector<std::wstring>& removed, KeyOf keyOf, Same same)
+{
+    std::map<std::wstring, const T*> baseIndex;
+    for (const auto& record : base) {
+        baseIndex[keyOf(record)] = &record;
+    }
+    std::map<std::wstring, const T*> hostIndex;
+    for (const auto& record : records) {
+        hostIndex[keyOf(record)] = &record;
+        auto it = baseIndex.find(keyOf(record));
+        if (it == baseIndex.end() || !same(*it->second, record)) {
+            changes.push_back(record);
+        }
+    }
+    for (const auto& record : base) {
+        if (hostIndex.find(keyOf(record)) == hostIndex.end()) {
+            removed.push_back(keyOf(record));
+        }
+    }
+}
+
+bool readList(const BlockView& block, const ListRecord& record,
+              std::pair<std::wstring, std::vector<std::wstring>>& entry)
+{
+    uint32_t listCount = 0;
+    const uint32_t* lists = block.table<uint32_t>(kPolLists, listCount);
+    if (!block.string(record.name, entry.first) || record.first > listCount
+        || listCount - record.first < record.count) {
+        return false;
+    }
+    entry.second.resize(record.count);
+    for (uint32_t i = 0; i < record.count; i++) {
+        if (!block.string(lists[record.first + i], entry.second[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+HRESULT SnapshotImage::open(const std::string& fileName, std::shared_ptr<SnapshotImage>& image,
+                            std::shared_ptr<const SnapshotImage> baseline)
+{
+    auto opened = std::make_shared<SnapshotImage>();
+    HRESULT hr = opened->file.open(fileName);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    const BYTE* data = opened->file.data();
+    size_t size = opened->file.size();
+    if (size < sizeof(FileHeader)) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+    const auto* header = reinterpret_cast<const FileHeader*>(data);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+
+    auto inBounds = [size](const BlockRef& block) {
+        return block.offset % kAlignment == 0 && block.offset <= size && size - block.offset >= block.size;
+    };
+    BlockView registry;
+    if (!inBounds(header->registry) || !inBounds(header->policy)
+        || !registry.init(data + header->registry.offset, header->registry.size, kRegistryTableCount)) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+
+    if (header->flags & kDeltaImage) {
+        if (!baseline || baseline->isDelta() || baseline->getContentHash() != header->baselineHash) {
+            return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
+        }
+        opened->baseline = std::move(baseline);
+    }
+
+    opened->registryOffset = header->registry.offset;
+    opened->registryLength = header->registry.size;
+    opened->policyOffset = header->policy.offset;
+    opened->policyLength = header->policy.size;
+    image = std::move(opened);
+    return S_OK;
+}
+
+void SnapshotImage::write(const HostCollection& collection, std::ostream& out) {
+    PolicyDelta policy;
+    policy.changed = collection;
+    policy.changed.registry.clear();
+    policy.replacesModals = collection.password || collection.lockout || collection.passwordProperties;
+    writeImage(writeRegistryBlock(collection), writePolicyBlock(policy), 0, 0, out);
+}
+
+HRESULT SnapshotImage::writeDelta(const HostCollection& collection, const SnapshotImage& baseline,
+                                  std::ostream& out)
+{
+    HostCollection base;
+    HRESULT hr = baseline.readCollection(base);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    // Registry values, with a removal record for each the host lacks
+    HostCollection registry;
+    std::vector<std::wstring> removedValues;
+    auto valueKey = [](const HostCollection::RegistryEntry& entry) {
+        return toLowerCopy(entry.path) + L'\n' + toLowerCopy(entry.valueName);
+    };
+    auto sameValue = [](const HostCollection::RegistryEntry& a, const HostCollection::RegistryEntry& b) {
+        return a.value.type == b.value.type && a.value.data == b.value.data;
+    };
+    diff(base.registry, collection.registry, registry.registry, removedValues, valueKey, sameValue);
+    std::set<std::wstring> removedKeys(removedValues.begin(), removedValues.end());
+    for (const auto& entry : base.registry) {
+        if (removedKeys.count(valueKey(entry))) {
+            HostCollection::RegistryEntry removed{ entry.path, entry.valueName, RegistryValue() };
+            removed.value.type = kRemovedValue;
+            registry.registry.push_back(std::move(removed));
+        }
+    }
+
+    PolicyDelta policy;
+    auto samePassword = [](const std::optional<PasswordModals>& a, const std::optional<PasswordModals>& b) {
+        return a.has_value() == b.has_value()
+            && (!a || (a->minPasswdLen == b->minPasswdLen && a->maxPasswdAge == b->maxPasswdAge
+                       && a->minPasswdAge == b->minPasswdAge && a->forceLogoff == b->forceLogoff
+                       && a->passwordHistLen == b->passwordHistLen));
+    };
+    auto sameLockout = [](const std::optional<LockoutModals>& a, const std::optional<LockoutModals>& b) {
+        return a.has_value() == b.has_value()
+            && (!a || (a->lockoutDuration == b->lockoutDuration
+                       && a->lockoutObservationWindow == b->lockoutObservationWindow
+                       && a->lockoutThreshold == b->lockoutThreshold));
+    };
+    auto sameProperties = [](const std::optional<PasswordProperties>& a, const std::optional<PasswordProperties>& b) {
+        return a.has_value() == b.has_value()
+            && (!a || (a->passwordComplexity == b->passwordComplexity
+                       && a->clearTextPassword == b->clearTextPassword));
+    };
+    if (!samePassword(base.password, collection.password) || !sameLockout(base.lockout, collection.lockout)
+        || !sameProperties(base.passwordProperties, collection.passwordProperties)) {
+        policy.replacesModals = true;
+        policy.changed.password = collection.password;
+        policy.changed.lockout = collection.lockout;
+        policy.changed.passwordProperties = collection.passwordProperties;
+    }
+
+    auto namedKey = [](const auto& entry) { return toLowerCopy(entry.first); };
+    diff(base.users, collection.users, policy.changed.users, policy.removedUsers, namedKey,
+         [](const auto& a, const auto& b) { return a.second.name == b.second.name && a.second.flags == b.second.flags; });
+    diff(base.groups, collection.groups, policy.changed.groups, policy.removedGroups, namedKey,
+         [](const auto& a, const auto& b) { return a.second == b.second; });
+    diff(base.services, collection.services, policy.changed.services, policy.removedServices,
+         [](const ServiceEntry& entry) { return toLowerCopy(entry.name); },
+         [](const ServiceEntry& a, const ServiceEntry& b) {
+             return a.config.startType == b.config.startType && a.config.currentState == b.config.currentState;
+         });
+    diff(base.rights, collection.rights, policy.changed.rights, policy.removedRights, namedKey,
+         [](const auto& a, const auto& b) { return a.second == b.second; });
+    diff(base.auditPolicy, collection.auditPolicy, policy.changed.auditPolicy, policy.removedAudit, auditKey,
+         [](const AuditSubcategorySetting& a, const AuditSubcategorySetting& b) {
+             return a.subcategory == b.subcategory && a.inclusionSetting == b.inclusionSetting;
+         });
+    diff(base.statuses, collection.statuses, policy.changed.statuses, policy.removedStatuses, statusKey,
+         [](const HostCollection::QueryStatus& a, const HostCollection::QueryStatus& b) {
+             return a.status == b.status;
+         });
+
+    writeImage(writeRegistryBlock(registry), writePolicyBlock(policy), kDeltaImage, baseline.getContentHash(), out);
+    return S_OK;
+}
+
+bool SnapshotImage::isDelta() const {
+    return (reinterpret_cast<const FileHeader*>(file.data())->flags & kDeltaImage) != 0;
+}
+
+uint64_t SnapshotImage::getContentHash() const {
+    return reinterpret_cast<const FileHeader*>(file.data())->contentHash;
+}
+
+HRESULT SnapshotImage::readCollection(HostCollection& collection) const {
+    if (isDelta()) {
+        return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+    }
+    HRESULT hr = parsePolicy(policyData(), policySize(), collection);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    BlockView block;
+    block.init(file.data() + registryOffset, registryLength, kRegistryTableCount);
+    uint32_t valueCount = 0;
+    uint32_t dataSize = 0;
+    const ValueRecord* values = block.table<ValueRecord>(kRegValues, valueCount);
+    const BYTE* data = block.table<BYTE>(kRegData, dataSize);
+    collection.registry.resize(valueCount);
+    for (uint32_t i = 0; i < valueCount; i++) {
+        const ValueRecord& record = values[i];
+        HostCollection::RegistryEntry& entry = collection.registry[i];
+        if (!block.string(record.path, entry.path) || !block.string(record.name, entry.valueName)
+            || record.dataOffset > dataSize || dataSize - record.dataOffset < record.dataSize) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+        entry.value.type = record.type;
+        entry.value.data.assign(data + record.dataOffset, data + record.dataOffset + record.dataSize);
+    }
+    return S_OK;
+}
+
+HRESULT SnapshotImage::queryValue(const std::wstring& path, const std::wstring& valueName,
+                                  RegistryValue& value) const
+{
+    std::u16string path16 = toUtf16(path);
+    std::u16string name16 = toUtf16(valueName);
+    HRESULT hr = findValue(path16, name16, value);
+    if (hr == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) && baseline) {
+        return baseline->findValue(path16, name16, value);
+    }
+    if (SUCCEEDED(hr) && value.type == kRemovedValue) {
+        value = RegistryValue();
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+    }
+    return hr;
+}
+
+HRESULT SnapshotImage::findValue(const std::u16string& path16, const std::u16string& name16,
+                                 RegistryValue& value) const
+{
+    BlockView block;
+    block.init(file.data() + registryOffset, registryLength, kRegistryTableCount);
+
+    uint32_t indexCount = 0;
+    uint32_t valueCount = 0;
+    uint32_t dataSize = 0;
+    const IndexEntry* index = block.table<IndexEntry>(kRegIndex, indexCount);
+    const ValueRecord* values = block.table<ValueRecord>(kRegValues, valueCount);
+    const BYTE* data = block.table<BYTE>(kRegData, dataSize);
+
+    uint64_t hash = hashValueKey(path16, name16);
+    const IndexEntry* it = std::lower_bound(index, index + indexCount, hash,
+                                            [](const IndexEntry& entry, uint64_t h) { return entry.hash < h; });
+    for (; it != index + indexCount && it->hash == hash; ++it) {
+        if (it->record >= valueCount) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+        const ValueRecord& record = values[it->record];
+        std::u16string_view storedPath;
+        std::u16string_view storedName;
+        if (!block.string(record.path, storedPath) || !block.string(record.name, storedName)) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+        if (!equalsFolded(storedPath, path16) || !equalsFolded(storedName, name16)) {
+            continue;
+        }
+        if (record.dataOffset > dataSize || dataSize - record.dataOffset < record.dataSize) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+        value.type = record.type;
+        value.data.assign(data + record.dataOffset, data + record.dataOffset + record.dataSize);
+        return S_OK;
+    }
+    return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+}
+
+size_t SnapshotImage::getValueCount() const {
+    BlockView block;
+    block.init(file.data() + registryOffset, registryLength, kRegistryTableCount);
+    uint32_t count = 0;
+    block.table<ValueRecord>(kRegValues, count);
+    return count;
+}
+
+HRESULT SnapshotImage::parsePolicy(const BYTE* data, size_t size, HostCollection& collection) {
+    collection = HostCollection();
+    BlockView block;
+    if (!data || !block.init(data, size, kPolProperties)) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+    const HRESULT invalid = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+    uint32_t count = 0;
+    const ModalsRecord* modals = block.table<ModalsRecord>(kPolModals, count);
+    if (count > 0) {
+        if (modals->present & kHasPassword) {
+            collection.password = PasswordModals{ modals->minPasswdLen, modals->maxPasswdAge, modals->minPasswdAge,
+                                                  modals->forceLogoff, modals->passwordHistLen };
+        }
+        if (modals->present & kHasLockout) {
+            collection.lockout = LockoutModals{ modals->lockoutDuration, modals->lockoutObservationWindow,
+                                                modals->lockoutThreshold };
+        }
+    }
+    const PropertiesRecord* properties = block.table<PropertiesRecord>(kPolProperties, count);
+    if (count > 0) {
+        collection.passwordProperties = PasswordProperties{ properties->passwordComplexity,
+                                                            properties->clearTextPassword };
+    }
+
+    const UserRecord* users = block.table<UserRecord>(kPolUsers, count);
+    collection.users.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        auto& user = collection.users[i];
+        user.second.flags = users[i].flags;
+        if (!block.string(users[i].queriedName, user.first) || !block.string(users[i].name, user.second.name)) {
+            return invalid;
+        }
+    }
+
+    const ListRecord* groups = block.table<ListRecord>(kPolGroups, count);
+    collection.groups.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        if (!readList(block, groups[i], collection.groups[i])) {
+            return invalid;
+        }
+    }
+
+    const ServiceRecord* services = block.table<ServiceRecord>(kPolServices, count);
+    collection.services.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        ServiceEntry& service = collection.services[i];
+        service.config.startType = services[i].startType;
+        service.config.currentState = services[i].currentState;
+        if (!block.string(services[i].name, service.name)) {
+            return invalid;
+        }
+    }
+
+    const ListRecord* rights = block.table<ListRecord>(kPolRights, count);
+    collection.rights.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        if (!readList(block, rights[i], collection.rights[i])) {
+            return invalid;
+        }
+    }
+
+    const AuditRecord* audit = block.table<AuditRecord>(kPolAudit, count);
+    collection.auditPolicy.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        AuditSubcategorySetting& setting = collection.auditPolicy[i];
+        if (!block.string(audit[i].subcategory, setting.subcategory) || !block.string(audit[i].guid, setting.guid)
+            || !block.string(audit[i].setting, setting.inclusionSetting)) {
+            return invalid;
+        }
+    }
+
+    const StatusRecord* statuses = block.table<StatusRecord>(kPolStatuses, count);
+    collection.statuses.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        HostCollection::QueryStatus& status = collection.statuses[i];
+        status.query = static_cast<HostCollection::Query>(statuses[i].query);
+        status.status = static_cast<HRESULT>(statuses[i].status);
+        if (!block.string(statuses[i].name, status.name) || !block.string(statuses[i].valueName, status.valueName)) {
+            return invalid;
+        }
+    }
+    return S_OK;
+}
+
+HRESULT SnapshotImage::parsePolicyDelta(const BYTE* data, size_t size, PolicyDelta& delta) {
+    delta = PolicyDelta();
+    HRESULT hr = parsePolicy(data, size, delta.changed);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    BlockView block;
+    block.init(data, size, kPolProperties);
+    uint32_t count = 0;
+    block.table<ModalsRecord>(kPolModals, count);
+    delta.replacesModals = count > 0;
+
+    const RemovedRecord* removed = block.table<RemovedRecord>(kPolRemoved, count);
+    for (uint32_t i = 0; i < count; i++) {
+        std::wstring name;
+        if (!block.string(removed[i].name, name)) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+        switch (removed[i].kind) {
+            case kRemovedUser:    delta.removedUsers.push_back(std::move(name));    break;
+            case kRemovedGroup:   delta.removedGroups.push_back(std::move(name));   break;
+            case kRemovedService: delta.removedServices.push_back(std::move(name)); break;
+            case kRemovedRight:   delta.removedRights.push_back(std::move(name));   break;
+            case kRemovedAudit:   delta.removedAudit.push_back(std::move(name));    break;
+            default:              return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+    }
+
+    const uint32_t* removedStatuses = block.table<uint32_t>(kPolRemovedStatuses, count);
+    delta.removedStatuses.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        if (!block.string(removedStatuses[i], delta.removedStatuses[i])) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+    }
+    return S_OK;
+}
+
+void PolicyDelta::applyTo(HostCollection& collection) const {
+    if (replacesModals) {
+        collection.password = changed.password;
+        collection.lockout = changed.lockout;
+        collection.passwordProperties = changed.passwordProperties;
+    }
+    auto namedKey = [](const auto& entry) { return toLowerCopy(entry.first); };
+    overlay(collection.users, changed.users, removedUsers, namedKey);
+    overlay(collection.groups, changed.groups, removedGroups, namedKey);
+    overlay(collection.services, changed.services, removedServices,
+            [](const ServiceEntry& entry) { return toLowerCopy(entry.name); });
+    overlay(collection.rights, changed.rights, removedRights, namedKey);
+    overlay(collection.auditPolicy, changed.auditPolicy, removedAudit, auditKey);
+    overlay(collection.statuses, changed.statuses, removedStatuses, statusKey);
+}
@@ -0,0 +1,234 @@
+#include "include/probes/snapshot_probe.h"
+#include "include/probes/regf_hive_source.h"
+#include "include/string_utils.h"
+
+std::wstring SnapshotProbe::registryKey(const std::wstring& path, const std::wstring& valueName) {
+    return toLowerCopy(path) + L'\n' + toLowerCopy(valueName);
+}
+
+void SnapshotProbe::setRegistryValue(const std::wstring& path, const std::wstring& valueName, RegistryValue value) {
+    registryValues[registryKey(path, valueName)] = std::move(value);
+}
+
+void SnapshotProbe::setRegistryDword(const std::wstring& path, const std::wstring& valueName, DWORD data) {
+    RegistryValue value;
+    value.type = REG_DWORD;
+    value.data.resize(sizeof(DWORD));
+    for (size_t i = 0; i < sizeof(DWORD); i++) {
+        value.data[i] = static_cast<BYTE>((data >> (8 * i)) & 0xFF);
+    }
+    setRegistryValue(path, valueName, std::move(value));
+}
+
+void SnapshotProbe::addRegistrySource(std::shared_ptr<const RegistrySource> source) {
+    registrySources.push_back(std::move(source));
+}
+
+void SnapshotProbe::setPasswordModals(const PasswordModals& modals) {
+    passwordModals = modals;
+}
+
+void SnapshotProbe::setLockoutModals(const LockoutModals& modals) {
+    lockoutModals = modals;
+}
+
+void SnapshotProbe::setPasswordProperties(const PasswordProperties& properties) {
+    passwordProperties = properties;
+}
+
+void SnapshotProbe::setUserInfo(const std::wstring& userName, const UserAccountInfo& info) {
+    users[toLowerCopy(userName)] = info;
+}
+
+void SnapshotProbe::setLocalGroupMembers(const std::wstring& groupName, std::vector<std::wstring> members) {
+    groupMembers[toLowerCopy(groupName)] = std::move(members);
+}
+
+void SnapshotProbe::setServiceConfig(const std::wstring& serviceName, const ServiceConfig& config) {
+    services[toLowerCopy(serviceName)] = ServiceEntry{serviceName, S_OK, config};
+    markLoaded(ListData::Services);
+}
+
+void SnapshotProbe::setAccountSid(const std::wstring& accountName, const std::wstring& sid) {
+    accountSids[toLowerCopy(accountName)] = sid;
+}
+
+void SnapshotProbe::setAccountsWithRight(const std::wstring& rightName, std::vector<std::wstring> sids) {
+    rights[toLowerCopy(rightName)] = std::move(sids);
+    markLoaded(ListData::Rights);
+}
+
+void SnapshotProbe::setAuditSubcategory(const std::wstring& subcategory, const std::wstring& setting,
+                                        const std::wstring& guid)
+{
+    // Keyed by GUID when known: localized names from different files can collide
+    auditSettings[toLowerCopy(guid.empty() ? subcategory : guid)] = AuditSubcategorySetting{subcategory, guid, setting};
+    markLoaded(ListData::AuditPolicy);
+}
+
+void SnapshotProbe::addUserProfile(UserProfile profile) {
+    userProfiles.push_back(std::move(profile));
+    markLoaded(ListData::UserProfiles);
+}
+
+// Supplying entries does not clear a failure replayed for the list
+void SnapshotProbe::markLoaded(ListData kind) {
+    std::optional<HRESULT>& status = listStatuses[static_cast<size_t>(kind)];
+    if (!status) {
+        status = S_OK;
+    }
+}
+
+void SnapshotProbe::setListFailure(ListData kind, HRESULT status) {
+    listStatuses[static_cast<size_t>(kind)] = status;
+}
+
+void SnapshotProbe::setRegistryFailure(const std::wstring& path, const std::wstring& valueName, HRESULT status) {
+    registryFailures[registryKey(path, valueName)] = status;
+}
+
+void SnapshotProbe::setServiceFailure(const std::wstring& serviceName, HRESULT status) {
+    services[toLowerCopy(serviceName)] = ServiceEntry{serviceName, status, ServiceConfig()};
+}
+
+void SnapshotProbe::setRightFailure(const std::wstring& rightName, HRESULT status) {
+    rightFailures[toLowerCopy(rightName)] = status;
+}
+
+HRESULT SnapshotProbe::listStatus(ListData kind) const {
+    return listStatuses[static_cast<size_t>(kind)].value_or(HRESULT_FROM_WIN32(ERROR_NOT_FOUND));
+}
+
+HRESULT SnapshotProbe::queryRegistryValue(const std::wstring& path, const std::wstring& valueName,
+                                          RegistryValue& value)
+{
+    std::wstring key = registryKey(path, valueName);
+    auto it = registryValues.find(key);
+    if (it != registryValues.end()) {
+        value = it->second;
+        return S_OK;
+    }
+    auto failure = registryFailures.find(key);
+    if (failure != registryFailures.end()) {
+        return failure->second;
+    }
+
+    for (const auto& source : registrySources) {
+        HRESULT hr = source->queryValue(path, valueName, value);
+        if (hr != HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)) {
+            return hr;
+        }
+    }
+    return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+}
+
+HRESULT SnapshotProbe::queryPasswordModals(PasswordModals& modals) {
+    if (!passwordModals) {
+        return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
+    }
+    modals = *passwordModals;
+    return S_OK;
+}
+
+// Given by a template or collection, else from a SAM hive among the sources
+HRESULT SnapshotProbe::queryPasswordProperties(PasswordProperties& properties) {
+    if (!passwordProperties) {
+        return SystemProbe::queryPasswordProperties(properties);
+    }
+    properties = *passwordProperties;
+    return S_OK;
+}
+
+HRESULT SnapshotProbe::queryLockoutModals(LockoutModals& modals) {
+    if (!lockoutModals) {
+        return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
+    }
+    modals = *lockoutModals;
+    return S_OK;
+}
+
+HRESULT SnapshotProbe::queryUserInfo(const std::wstring& userName, UserAccountInfo& info) {
+    auto it = users.find(toLowerCopy(userName));
+    if (it == users.end()) {
+        return HRESULT_FROM_WIN32(NERR_UserNotFound);
+    }
+    info = it->second;
+    return S_OK;
+}
+
+HRESULT SnapshotProbe::queryLocalGroupMembers(const std::wstring& groupName,
+                                              std::vector<std::wstring>& members)
+{
+    auto it = groupMembers.find(toLowerCopy(groupName));
+    if (it == groupMembers.end()) {
+        return HRESULT_FROM_WIN32(ERROR_NO_SUCH_ALIAS);
+    }
+    members = it->second;
+    return S_OK;
+}
+
+HRESULT SnapshotProbe::queryServices(std::vector<ServiceEntry>& services) {
+    services.clear();
+    HRESULT hr = listStatus(ListData::Services);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    for (const auto& entry : this->services) {
+        services.push_back(entry.second);
+    }
+    return S_OK;
+}
+
+HRESULT SnapshotProbe::lookupAccountSid(const std::wstring& accountName, std::wstring& sid) {
+    auto it = accountSids.find(toLowerCopy(accountName));
+    if (it == accountSids.end()) {
+        return HRESULT_FROM_WIN32(ERROR_NONE_MAPPED);
+    }
+    sid = it->second;
+    return S_OK;
+}
+
+HRESULT SnapshotProbe::queryAccountsWithRight(const std::wstring& rightName,
+                                              std::vector<std::wstring>& sids)
+{
+    auto failure = rightFailures.find(toLowerCopy(rightName));
+    if (failure != rightFailures.end()) {
+        return failure->second;
+    }
+    HRESULT hr = listStatus(ListData::Rights);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    // A right nobody holds is simply absent from the snapshot
+    auto it = rights.find(toLowerCopy(rightName));
+    sids = (it != rights.end()) ? it->second : std::vector<std::wstring>();
+    return S_OK;
+}
+
+HRESULT SnapshotProbe::queryAuditPolicy(std::vector<AuditSubcategorySetting>& settings) {
+    settings.clear();
+    HRESULT hr = listStatus(ListData::AuditPolicy);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    for (const auto& entry : auditSettings) {
+        settings.push_back(entry.second);
+    }
+    return S_OK;
+}
+
+HRESULT SnapshotProbe::queryUserProfiles(std::vector<UserProfile>& profiles) {
+    profiles = userProfiles;
+    return listStatus(ListData::UserProfiles);
+}
+
+// Hives are only mapped here, by whichever worker evaluates the user
+HRESULT SnapshotProbe::openUserHive(const UserProfile& profile, std::shared_ptr<const RegistrySource>& hive) {
+    std::shared_ptr<RegfHiveSource> source;
+    HRESULT hr = RegfHiveSource::load(profile.hiveFile, std::wstring(), source);
+    if (SUCCEEDED(hr)) {
+        hive = std::move(source);
+    }
+    return hr;
+}
\ No newline at end of file
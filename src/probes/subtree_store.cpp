@@ -0,0 +1,180 @@
+#include "include/probes/subtree_store.h"
+#include "include/string_utils.h"
+#include <cstring>
+
+namespace {
+constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+inline uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const BYTE* bytes = static_cast<const BYTE*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * kFnvPrime;
+    }
+    return hash;
+}
+
+inline uint64_t fnv1a(uint64_t hash, uint64_t value) {
+    return fnv1a(hash, &value, sizeof(value));
+}
+
+uint64_t hashLookups(const std::vector<RegistryLookup>& values) {
+    uint64_t hash = kFnvOffset;
+    for (const RegistryLookup& lookup : values) {
+        hash = fnv1a(hash, lookup.valueName.data(), lookup.valueName.size() * sizeof(wchar_t));
+        hash = fnv1a(hash, static_cast<uint64_t>(static_cast<DWORD>(lookup.status)));
+        if (SUCCEEDED(lookup.status)) {
+            hash = fnv1a(hash, lookup.value.type);
+            hash = fnv1a(hash, lookup.value.data.size());
+            hash = fnv1a(hash, lookup.value.data.data(), lookup.value.data.size());
+        }
+    }
+    return hash;
+}
+
+bool sameLookups(const std::vector<RegistryLookup>& a, const std::vector<RegistryLookup>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].status != b[i].status || a[i].valueName != b[i].valueName) {
+            return false;
+        }
+        if (SUCCEEDED(a[i].status)
+            && (a[i].value.type != b[i].value.type || a[i].value.data != b[i].value.data)) {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+SubtreeStore::SubtreeStore(const ProbeInputs& inputs) {
+    for (const auto& entry : inputs.getRegistryKeys()) {
+        keyIndex[entry.first] = keys.size();
+        keys.push_back(entry.second);
+    }
+}
+
+int SubtreeStore::findKey(const std::wstring& path) const {
+    auto it = keyIndex.find(toLowerCopy(path));
+    return it == keyIndex.end() ? -1 : static_cast<int>(it->second);
+}
+
+std::vector<std::shared_ptr<const RegistrySubtree>> SubtreeStore::ingest(SystemProbe& probe) {
+    std::vector<std::shared_ptr<const RegistrySubtree>> hostSubtrees;
+    hostSubtrees.reserve(keys.size());
+    for (const auto& key : keys) {
+        std::vector<RegistryLookup> lookups(key.valueNames.size());
+        for (size_t i = 0; i < lookups.size(); i++) {
+            lookups[i].valueName = key.valueNames[i];
+        }
+        // A key that cannot be opened leaves its failure on every value
+        HRESULT hr = probe.queryRegistryValues(key.path, lookups);
+        if (FAILED(hr)) {
+            for (auto& lookup : lookups) {
+                lookup.status = hr;
+                lookup.value = RegistryValue();
+            }
+        }
+        hostSubtrees.push_back(intern(std::move(lookups)));
+    }
+    return hostSubtrees;
+}
+
+std::shared_ptr<const RegistrySubtree> SubtreeStore::intern(std::vector<RegistryLookup> values) {
+    uint64_t hash = hashLookups(values);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto range = subtrees.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (sameLookups(it->second->values, values)) {
+            return it->second;
+        }
+    }
+
+    auto subtree = std::make_shared<RegistrySubtree>();
+    subtree->id = static_cast<uint32_t>(subtrees.size() + 1);
+    subtree->hash = hash;
+    subtree->values = std::move(values);
+    subtrees.emplace(hash, subtree);
+    return subtree;
+}
+
+uint64_t SubtreeStore::hashBytes(const BYTE* data, size_t size) {
+    return fnv1a(fnv1a(kFnvOffset, size), data, size);
+}
+
+// Caller holds the mutex
+const SubtreeStore::FileEntry* SubtreeStore::matchFile(std::type_index type, uint64_t hash,
+                                                       const BYTE* data, size_t size) const
+{
+    auto range = files.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const FileEntry& entry = *it->second;
+        if (entry.type == type && entry.bytes.size() == size
+            && (size == 0 || std::memcmp(entry.bytes.data(), data, size) == 0)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const SubtreeStore::FileEntry* SubtreeStore::findFile(std::type_index type, uint64_t hash,
+                                                      const BYTE* data, size_t size) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return matchFile(type, hash, data, size);
+}
+
+const SubtreeStore::FileEntry* SubtreeStore::addFile(std::type_index type, uint64_t hash,
+                                                     const BYTE* data, size_t size,
+                                                     std::shared_ptr<const void> parsed)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (const FileEntry* existing = matchFile(type, hash, data, size)) {
+        return existing;
+    }
+
+    uint32_t id = ++fileCounts[type];
+    auto entry = std::make_unique<FileEntry>(FileEntry{ type, id, std::vector<BYTE>(data, data + size),
+                                                        std::move(parsed) });
+    const FileEntry* added = entry.get();
+    files.emplace(hash, std::move(entry));
+    return added;
+}
+
+size_t SubtreeStore::getSubtreeCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return subtrees.size();
+}
+
+size_t SubtreeStore::getFileCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return files.size();
+}
+
+SubtreeSource::SubtreeSource(const SubtreeStore& store,
+                             std::vector<std::shared_ptr<const RegistrySubtree>> subtrees)
+    : store(store), subtrees(std::move(subtrees))
+{
+}
+
+HRESULT SubtreeSource::queryValue(const std::wstring& path, const std::wstring& valueName,
+                                  RegistryValue& value) const
+{
+    int key = store.findKey(path);
+    if (key < 0 || static_cast<size_t>(key) >= subtrees.size()) {
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+    }
+    for (const RegistryLookup& lookup : subtrees[key]->values) {
+        if (equalsIgnoreCase(lookup.valueName, valueName)) {
+            if (FAILED(lookup.status)) {
+                return lookup.status;
+            }
+            value = lookup.value;
+            return S_OK;
+        }
+    }
+    return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "include/probes/system_probe.h"
+#include "include/run_context.h"
+#include "include/probes/snapshot_probe.h"
+#ifdef _WIN32
+#include "include/probes/live_system_probe.h"
+#endif
+#include <cstring>
+
+namespace {
+// PasswordProperties of the "F" record and its bits (DOMAIN_PASSWORD_INFORMATION)
+constexpr size_t kPasswordPropertiesOffset = 0x4C;
+constexpr DWORD kDomainPasswordComplex = 0x1;
+constexpr DWORD kDomainPasswordStoreCleartext = 0x10;
+}
+
+SystemProbe& SystemProbe::current() {
+    return RunContext::current().getProbe();
+}
+
+HRESULT SystemProbe::queryRegistryValues(const std::wstring& path, std::vector<RegistryLookup>& lookups) {
+    for (auto& lookup : lookups) {
+        lookup.status = queryRegistryValue(path, lookup.valueName, lookup.value);
+    }
+    return S_OK;
+}
+
+HRESULT SystemProbe::queryPasswordProperties(PasswordProperties& properties) {
+    RegistryValue value;
+    HRESULT hr = queryRegistryValue(kSamAccountDomainKey, L"F", value);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    if (value.type != REG_BINARY || value.data.size() < kPasswordPropertiesOffset + sizeof(DWORD)) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+
+    DWORD flags = 0;
+    std::memcpy(&flags, value.data.data() + kPasswordPropertiesOffset, sizeof(DWORD));
+    properties.passwordComplexity = (flags & kDomainPasswordComplex) ? 1 : 0;
+    properties.clearTextPassword = (flags & kDomainPasswordStoreCleartext) ? 1 : 0;
+    return S_OK;
+}
+
+std::shared_ptr<SystemProbe> SystemProbe::createDefault() {
+#ifdef _WIN32
+    return std::make_shared<LiveSystemProbe>();
+#else
+    return std::make_shared<SnapshotProbe>();
+#endif
+}
\ No newline at end of file
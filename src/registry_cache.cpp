@@ -0,0 +1,101 @@
+#include "include/registry_cache.h"
+#include "include/string_utils.h"
+#include <cstring>
+
+RegistryCache::RegistryCache(SystemProbe& probe)
+    : probe(probe) {}
+
+std::wstring RegistryCache::cacheKey(const std::wstring& path, const std::wstring& valueName) {
+    return toLowerCopy(path) + L'\n' + toLowerCopy(valueName);
+}
+
+void RegistryCache::prefetch(const ProbeInputs& inputs) {
+    for (const auto& entry : inputs.getRegistryKeys()) {
+        const ProbeInputs::RegistryKey& key = entry.second;
+
+        std::vector<RegistryLookup> lookups(key.valueNames.size());
+        for (size_t i = 0; i < lookups.size(); i++) {
+            lookups[i].valueName = key.valueNames[i];
+        }
+        HRESULT hr = probe.queryRegistryValues(key.path, lookups);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& lookup : lookups) {
+            Entry& cached = entries[cacheKey(key.path, lookup.valueName)];
+            cached.status = FAILED(hr) ? hr : lookup.status;
+            cached.value = std::move(lookup.value);
+        }
+    }
+}
+
+HRESULT RegistryCache::getValue(const std::wstring& path, const std::wstring& valueName, RegistryValue& value) {
+    std::wstring key = cacheKey(path, valueName);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            value = it->second.value;
+            return it->second.status;
+        }
+    }
+
+    // Not declared by any check: read it now and keep it for the rest of the run
+    Entry entry;
+    entry.status = probe.queryRegistryValue(path, valueName, entry.value);
+    value = entry.value;
+    HRESULT hr = entry.status;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.emplace(std::move(key), std::move(entry));
+    return hr;
+}
+
+void RegistryCache::getValues(const std::wstring& path, std::vector<RegistryLookup>& lookups) {
+    std::vector<RegistryLookup> unread;
+    std::vector<size_t> unreadIndex;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < lookups.size(); i++) {
+            auto it = entries.find(cacheKey(path, lookups[i].valueName));
+            if (it != entries.end()) {
+                lookups[i].status = it->second.status;
+                lookups[i].value = it->second.value;
+            } else {
+                RegistryLookup lookup;
+                lookup.valueName = lookups[i].valueName;
+                unread.push_back(std::move(lookup));
+                unreadIndex.push_back(i);
+            }
+        }
+    }
+    if (unread.empty()) {
+        return;
+    }
+
+    HRESULT hr = probe.queryRegistryValues(path, unread);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < unread.size(); i++) {
+        RegistryLookup& lookup = lookups[unreadIndex[i]];
+        lookup.status = FAILED(hr) ? hr : unread[i].status;
+        lookup.value = unread[i].value;
+
+        Entry& cached = entries[cacheKey(path, lookup.valueName)];
+        cached.status = lookup.status;
+        cached.value = std::move(unread[i].value);
+    }
+}
+
+HRESULT RegistryCache::getDword(const std::wstring& path, const std::wstring& valueName, DWORD& data) {
+    RegistryValue value;
+    HRESULT hr = getValue(path, valueName, value);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    if (value.data.size() != sizeof(DWORD)) {
+        return HRESULT_FROM_WIN32(ERROR_MORE_DATA);
+    }
+
+    std::memcpy(&data, value.data.data(), sizeof(DWORD));
+    return S_OK;
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "include/registry_rule_table.h"
+#include "include/run_context.h"
+#include "include/string_utils.h"
+#include <algorithm>
+#include <cstring>
+#include <cwctype>
+
+namespace {
+// ScalarRule reader for a row: the REG_DWORD rule.valueName under rule.path
+HRESULT readRuleDword(const ScalarRule& rule, DWORD& value) {
+    RegistryValue regValue;
+    HRESULT hr = RunContext::current().getRegistry().getValue(rule.path, rule.valueName, regValue);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    if (regValue.type != REG_DWORD || regValue.data.size() != sizeof(DWORD)) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+    std::memcpy(&value, regValue.data.data(), sizeof(DWORD));
+    return S_OK;
+}
+
+// The strings of a REG_MULTI_SZ value, up to the empty one ending the list
+std::vector<std::wstring> decodeMultiSz(const std::vector<BYTE>& data) {
+    std::vector<std::wstring> strings;
+    std::wstring current;
+    for (size_t i = 0; i + 1 < data.size(); i += 2) {
+        wchar_t ch = static_cast<wchar_t>(data[i] | (data[i + 1] << 8));
+        if (ch != L'\0') {
+            current.push_back(ch);
+        } else if (current.empty()) {
+            break;
+        } else {
+            strings.push_back(std::move(current));
+            current.clear();
+        }
+    }
+    if (!current.empty()) {
+        strings.push_back(std::move(current));
+    }
+    return strings;
+}
+
+// The number a REG_SZ value holds as decimal text, if it holds one
+bool decodeDecimalText(const std::vector<BYTE>& data, DWORD& value) {
+    uint64_t number = 0;
+    size_t digits = 0;
+    for (size_t i = 0; i + 1 < data.size(); i += 2) {
+        wchar_t ch = static_cast<wchar_t>(data[i] | (data[i + 1] << 8));
+        if (ch == L'\0') {
+            break;
+        }
+        if (ch < L'0' || ch > L'9' || ++digits > 10) {
+            return false;
+        }
+        number = number * 10 + static_cast<uint64_t>(ch - L'0');
+    }
+    if (digits == 0 || number > 0xFFFFFFFF) {
+        return false;
+    }
+    value = static_cast<DWORD>(number);
+    return true;
+}
+
+int compareIgnoreCase(const wchar_t* a, const wchar_t* b) {
+    for (;; a++, b++) {
+        wint_t ca = towlower(*a);
+        wint_t cb = towlower(*b);
+        if (ca != cb || ca == L'\0') {
+            return ca < cb ? -1 : (ca > cb ? 1 : 0);
+        }
+    }
+}
+}
+
+RegistryRuleTable::RegistryRuleTable(const RegistryRule* rules, size_t count)
+    : rules(rules), count(count), programs(count), keyOrder(count), keyGroup(count) {
+    for (size_t row = 0; row < count; row++) {
+        RuleProgram::compile(rules[row].expression, programs[row]);
+        keyOrder[row] = row;
+    }
+    std::stable_sort(keyOrder.begin(), keyOrder.end(), [rules](size_t a, size_t b) {
+        int byPath = compareIgnoreCase(rules[a].path, rules[b].path);
+        return byPath != 0 ? byPath < 0 : compareIgnoreCase(rules[a].valueName, rules[b].valueName) < 0;
+    });
+    for (size_t i = 0; i < count; i++) {
+        bool sameKey = i > 0 && equalsIgnoreCase(rules[keyOrder[i]].path, rules[keyOrder[i - 1]].path);
+        keyGroup[keyOrder[i]] = sameKey ? keyGroup[keyOrder[i - 1]] : i;
+    }
+}
+
+void RegistryRuleTable::declareInputs(ProbeInputs& inputs) const {
+    for (size_t row = 0; row < count; row++) {
+        inputs.addRegistryValue(rules[row].path, rules[row].valueName);
+    }
+}
+
+std::vector<BenchmarkResult> RegistryRuleTable::evaluate(RegistryCache& registry) const {
+    std::vector<BenchmarkResult> results(count, BenchmarkResult(std::string(), std::string(), CheckStatus::Error,
+                                                                std::string()));
+    std::vector<RegistryLookup> lookups;
+    size_t begin = 0;
+    while (begin < count) {
+        // Rows [begin, end) of keyOrder read the same key
+        const wchar_t* path = rules[keyOrder[begin]].path;
+        size_t end = begin + 1;
+        while (end < count && equalsIgnoreCase(rules[keyOrder[end]].path, path)) {
+            end++;
+        }
+
+        lookups.assign(end - begin, RegistryLookup());
+        for (size_t i = begin; i < end; i++) {
+            lookups[i - begin].valueName = rules[keyOrder[i]].valueName;
+        }
+        registry.getValues(path, lookups);
+
+        for (size_t i = begin; i < end; i++) {
+            const RegistryLookup& lookup = lookups[i - begin];
+            results[keyOrder[i]] = evaluate(keyOrder[i], lookup.status, lookup.value);
+        }
+        begin = end;
+    }
+    return results;
+}
+
+std::vector<BenchmarkResult> RegistryRuleTable::evaluate(const RegistrySource& source) const {
+    std::vector<BenchmarkResult> results(count, BenchmarkResult(std::string(), std::string(), CheckStatus::Error,
+                                                                std::string()));
+    // Rows of a key are adjacent in keyOrder, so a hive's pages along each
+    // key path are visited once, one key after the other
+    RegistryValue value;
+    for (size_t row : keyOrder) {
+        HRESULT hr = source.queryValue(rules[row].path, rules[row].valueName, value);
+        results[row] = evaluate(row, hr, value);
+    }
+    return results;
+}
+
+BenchmarkResult RegistryRuleTable::evaluate(size_t row, HRESULT status, const RegistryValue& value) const {
+    const RegistryRule& rule = rules[row];
+    const RuleProgram& program = programs[row];
+    if (FAILED(program.getStatus())) {
+        return BenchmarkResult(rule.id, rule.title, CheckStatus::Error,
+                               "Invalid rule expression: " + program.getExpression());
+    }
+
+    CheckStatus verdict = rule.missingStatus;
+    DWORD data = 0;
+    if (SUCCEEDED(status) && value.type == rule.type) {
+        if (rule.type == REG_MULTI_SZ) {
+            std::vector<std::wstring> strings = decodeMultiSz(value.data);
+            verdict = program.test(RuleInput{ 0, &strings }) ? CheckStatus::Pass : CheckStatus::Fail;
+        } else if (rule.type == REG_SZ) {
+            if (decodeDecimalText(value.data, data)) {
+                verdict = program.test(data) ? CheckStatus::Pass : CheckStatus::Fail;
+            }
+        } else if (value.data.size() == sizeof(DWORD)) {
+            std::memcpy(&data, value.data.data(), sizeof(DWORD));
+            verdict = program.test(data) ? CheckStatus::Pass : CheckStatus::Fail;
+        }
+    }
+    return BenchmarkResult(rule.id, rule.title, verdict, describe(rule, verdict, data));
+}
+
+HRESULT RegistryRuleTable::read(RegistryCache& registry, size_t row, RegistryValue& value) const {
+    const wchar_t* path = rules[row].path;
+    size_t begin = keyGroup[row];
+    size_t end = begin + 1;
+    while (end < count && equalsIgnoreCase(rules[keyOrder[end]].path, path)) {
+        end++;
+    }
+
+    std::vector<RegistryLookup> lookups(end - begin);
+    size_t self = 0;
+    for (size_t i = begin; i < end; i++) {
+        lookups[i - begin].valueName = rules[keyOrder[i]].valueName;
+        if (keyOrder[i] == row) {
+            self = i - begin;
+        }
+    }
+    registry.getValues(path, lookups);
+    value = std::move(lookups[self].value);
+    return lookups[self].status;
+}
+
+std::string RegistryRuleTable::describe(const RegistryRule& rule, CheckStatus status, DWORD value) {
+    const char* text = rule.errorDetails;
+    if (status == CheckStatus::Pass) {
+        text = rule.passDetails;
+    } else if (status == CheckStatus::Fail) {
+        text = rule.failDetails;
+    }
+
+    std::string details(text);
+    size_t hole = details.find("{}");
+    if (hole != std::string::npos) {
+        details.replace(hole, 2, std::to_string(value));
+    }
+    return details;
+}
+
+RegistryRuleCheck::RegistryRuleCheck(const RegistryRuleTable& table, size_t row)
+    : table(table), row(row),
+      scalar{ &readRuleDword, table[row].path, table[row].valueName, 0, 0, table[row].missingStatus } {
+    const RuleProgram& program = table.getProgram(row);
+    if (table[row].type == REG_DWORD && SUCCEEDED(program.getStatus()) && program.isNumeric()) {
+        scalar.program = &program;
+    }
+}
+
+// Reading the row fills the cache for its key's other rows; a scalar row then
+// finds its own value there too
+BenchmarkResult RegistryRuleCheck::check() {
+    RegistryValue value;
+    HRESULT hr = table.read(RunContext::current().getRegistry(), row, value);
+    return scalar.program ? checkScalar() : table.evaluate(row, hr, value);
+}
+
+void RegistryRuleCheck::declareInputs(ProbeInputs& inputs) const {
+    inputs.addRegistryValue(table[row].path, table[row].valueName);
+}
+
+std::string RegistryRuleCheck::describeScalar(CheckStatus status, DWORD value) const {
+    return RegistryRuleTable::describe(table[row], status, value);
+}
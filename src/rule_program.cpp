@@ -0,0 +1,468 @@
+#include "include/rule_program.h"
+#include "include/scalar_kernels.h"
+#include "include/string_utils.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+// Every comparison is lowered to these
+enum Op : uint32_t {
+    kOpRange,       // low, high:   push low <= value <= high
+    kOpMaskEq,      // mask, bits:  push (value & mask) == bits
+    kOpInSet,       // n, k1..kn:   push value is one of k1..kn
+    kOpContains,    // string:      push a string of the input equals strings[string]
+    kOpConst,       // bit:         push bit
+    kOpNot,
+    kOpAnd,
+    kOpOr
+};
+
+// Bits of the stack one push can hold
+constexpr size_t kMaxDepth = 64;
+
+constexpr uint32_t kMax = 0xFFFFFFFF;
+
+struct Token {
+    enum Kind { End, Word, Number, String, Symbol } kind = End;
+    std::string text;       // word, string contents or symbol
+    uint32_t number = 0;
+};
+
+class Lexer {
+public:
+    explicit Lexer(std::string_view text) : text(text) {}
+
+    // False on a character no token starts with, or an unterminated string
+    bool next(Token& token) {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+        token = Token();
+        if (pos == text.size()) {
+            return true;
+        }
+
+        char ch = text[pos];
+        if (std::isalpha(static_cast<unsigned char>(ch)) || ch == '_') {
+            size_t start = pos;
+            while (pos < text.size() && (std::isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '_')) {
+                pos++;
+            }
+            token.kind = Token::Word;
+            token.text = std::string(text.substr(start, pos - start));
+            return true;
+        }
+        if (std::isdigit(static_cast<unsigned char>(ch))) {
+            return number(token);
+        }
+        if (ch == '"') {
+            size_t close = text.find('"', pos + 1);
+            if (close == std::string_view::npos) {
+                return false;
+            }
+            token.kind = Token::String;
+            token.text = std::string(text.substr(pos + 1, close - pos - 1));
+            pos = close + 1;
+            return true;
+        }
+
+        static const char* const kTwoChar[] = { "==", "!=", "<=", ">=", "&&", "||" };
+        for (const char* symbol : kTwoChar) {
+            if (text.substr(pos, 2) == symbol) {
+                token.kind = Token::Symbol;
+                token.text = symbol;
+                pos += 2;
+                return true;
+            }
+        }
+        if (std::string_view("<>!&|()[]{},").find(ch) != std::string_view::npos) {
+            token.kind = Token::Symbol;
+            token.text = std::string(1, ch);
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    bool number(Token& token) {
+        int base = 10;
+        if (text.substr(pos, 2) == "0x" || text.substr(pos, 2) == "0X") {
+            base = 16;
+            pos += 2;
+        }
+        uint64_t value = 0;
+        size_t digits = 0;
+        for (; pos < text.size(); pos++, digits++) {
+            char ch = static_cast<char>(std::tolower(static_cast<unsigned char>(text[pos])));
+            int digit = (ch >= '0' && ch <= '9') ? ch - '0' : (base == 16 && ch >= 'a' && ch <= 'f') ? ch - 'a' + 10 : -1;
+            if (digit < 0) {
+                break;
+            }
+            value = value * base + digit;
+            if (value > kMax) {
+                return false;
+            }
+        }
+        token.kind = Token::Number;
+        token.number = static_cast<uint32_t>(value);
+        return digits > 0;
+    }
+
+    std::string_view text;
+    size_t pos = 0;
+};
+}
+
+/**
+ * RuleCompiler:
+ *   Recursive descent over the expression, emitting postfix code as it
+ *   goes and tracking the stack depth the program reaches.
+ *     expr  := and ('||' and)*
+ *     and   := unary ('&&' unary)*
+ *     unary := '!' unary | '(' expr ')' | 'value' test
+ */
+class RuleCompiler {
+public:
+    RuleCompiler(std::string_view text, RuleProgram& program) : lexer(text), program(program) {}
+
+    bool run() {
+        return advance() && expr() && token.kind == Token::End && depth == 1;
+    }
+
+private:
+    bool advance() { return lexer.next(token); }
+
+    bool accept(const char* text) {
+        if ((token.kind == Token::Symbol || token.kind == Token::Word) && token.text == text) {
+            return advance();
+        }
+        return false;
+    }
+
+    bool is(const char* text) const {
+        return (token.kind == Token::Symbol || token.kind == Token::Word) && token.text == text;
+    }
+
+    void emit(std::initializer_list<uint32_t> words, int pushes) {
+        program.code.insert(program.code.end(), words);
+        depth += pushes;
+        program.maxDepth = std::max(program.maxDepth, static_cast<size_t>(depth));
+    }
+
+    bool expr() {
+        if (!conjunction()) {
+            return false;
+        }
+        while (is("||")) {
+            if (!advance() || !conjunction()) {
+                return false;
+            }
+            emit({ kOpOr }, -1);
+        }
+        return true;
+    }
+
+    bool conjunction() {
+        if (!unary()) {
+            return false;
+        }
+        while (is("&&")) {
+            if (!advance() || !unary()) {
+                return false;
+            }
+            emit({ kOpAnd }, -1);
+        }
+        return true;
+    }
+
+    bool unary() {
+        if (is("!")) {
+            if (!advance() || !unary()) {
+                return false;
+            }
+            emit({ kOpNot }, 0);
+            return true;
+        }
+        if (is("(")) {
+            return advance() && expr() && accept(")");
+        }
+        return accept("value") && test();
+    }
+
+    // A number, a flag name, or several ORed together
+    bool constant(uint32_t& value) {
+        value = 0;
+        do {
+            if (token.kind == Token::Number) {
+                value |= token.number;
+            } else if (is("success")) {
+                value |= kAuditSuccess;
+            } else if (is("failure")) {
+                value |= kAuditFailure;
+            } else if (!is("none")) {
+                return false;
+            }
+            if (!advance()) {
+                return false;
+            }
+        } while (accept("|"));
+        return true;
+    }
+
+    bool test() {
+        if (depth >= static_cast<int>(kMaxDepth)) {
+            return false;
+        }
+        uint32_t k = 0;
+        if (is("==") || is("!=") || is("<") || is("<=") || is(">") || is(">=")) {
+            std::string op = token.text;
+            if (!advance() || !constant(k)) {
+                return false;
+            }
+            if (op == "==") {
+                emit({ kOpRange, k, k }, 1);
+            } else if (op == "!=") {
+                emit({ kOpRange, k, k }, 1);
+                emit({ kOpNot }, 0);
+            } else if (op == "<=") {
+                emit({ kOpRange, 0, k }, 1);
+            } else if (op == ">=") {
+                emit({ kOpRange, k, kMax }, 1);
+            } else if (op == "<") {
+                emit(k == 0 ? std::initializer_list<uint32_t>{ kOpConst, 0 } : std::initializer_list<uint32_t>{ kOpRange, 0, k - 1 }, 1);
+            } else {
+                emit(k == kMax ? std::initializer_list<uint32_t>{ kOpConst, 0 } : std::initializer_list<uint32_t>{ kOpRange, k + 1, kMax }, 1);
+            }
+            return true;
+        }
+        if (accept("&")) {
+            uint32_t mask = 0;
+            if (!constant(mask)) {
+                return false;
+            }
+            bool negate = is("!=");
+            if (!(accept("==") || accept("!=")) || !constant(k)) {
+                return false;
+            }
+            emit({ kOpMaskEq, mask, k }, 1);
+            if (negate) {
+                emit({ kOpNot }, 0);
+            }
+            return true;
+        }
+        if (accept("has")) {
+            if (!constant(k)) {
+                return false;
+            }
+            emit({ kOpMaskEq, k, k }, 1);
+            return true;
+        }
+        if (accept("contains")) {
+            if (token.kind != Token::String) {
+                return false;
+            }
+            std::wstring needle(token.text.begin(), token.text.end());
+            program.strings.push_back(toLowerCopy(needle));
+            emit({ kOpContains, static_cast<uint32_t>(program.strings.size() - 1) }, 1);
+            return advance();
+        }
+        if (accept("in")) {
+            if (accept("[")) {
+                uint32_t high = 0;
+                if (!constant(k) || !accept(",") || !constant(high) || !accept("]")) {
+                    return false;
+                }
+                emit({ kOpRange, k, high }, 1);
+                return true;
+            }
+            if (accept("{")) {
+                std::vector<uint32_t> members;
+                do {
+                    if (!constant(k)) {
+                        return false;
+                    }
+                    members.push_back(k);
+                } while (accept(","));
+                if (!accept("}")) {
+                    return false;
+                }
+                emit({ kOpInSet, static_cast<uint32_t>(members.size()) }, 1);
+                program.code.insert(program.code.end(), members.begin(), members.end());
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Lexer lexer;
+    Token token;
+    RuleProgram& program;
+    int depth = 0;
+};
+
+DWORD parseAuditFlags(const std::wstring& inclusionSetting) {
+    DWORD flags = 0;
+    if (containsIgnoreCase(inclusionSetting, L"Success")) {
+        flags |= kAuditSuccess;
+    }
+    if (containsIgnoreCase(inclusionSetting, L"Failure")) {
+        flags |= kAuditFailure;
+    }
+    return flags;
+}
+
+RuleProgram::RuleProgram(std::string_view expression) {
+    compile(expression, *this);
+}
+
+HRESULT RuleProgram::compile(std::string_view expression, RuleProgram& program) {
+    program = RuleProgram();
+    program.expression = std::string(expression);
+    RuleCompiler compiler(expression, program);
+    if (!compiler.run()) {
+        program.code.clear();
+        program.strings.clear();
+        return program.status;
+    }
+    program.status = S_OK;
+    return S_OK;
+}
+
+bool RuleProgram::test(const RuleInput& input) const {
+    if (FAILED(status)) {
+        return false;
+    }
+
+    const uint32_t v = input.number;
+    const uint32_t* pc = code.data();
+    const uint32_t* end = pc + code.size();
+    uint64_t stack = 0;
+    while (pc < end) {
+        uint64_t bit = 0;
+        switch (pc[0]) {
+            case kOpRange:
+                bit = (v >= pc[1]) & (v <= pc[2]);
+                pc += 3;
+                break;
+            case kOpMaskEq:
+                bit = (v & pc[1]) == pc[2];
+                pc += 3;
+                break;
+            case kOpInSet:
+                for (uint32_t i = 0; i < pc[1]; i++) {
+                    bit |= (v == pc[2 + i]);
+                }
+                pc += 2 + pc[1];
+                break;
+            case kOpContains:
+                if (input.strings) {
+                    const std::wstring& needle = strings[pc[1]];
+                    for (const auto& s : *input.strings) {
+                        bit |= toLowerCopy(s) == needle;
+                    }
+                }
+                pc += 2;
+                break;
+            case kOpConst:
+                bit = pc[1] & 1;
+                pc += 2;
+                break;
+            case kOpNot:
+                stack ^= 1;
+                pc++;
+                continue;
+            case kOpAnd:
+                bit = stack & 1;
+                stack >>= 1;
+                stack &= ~uint64_t(1) | bit;
+                pc++;
+                continue;
+            case kOpOr:
+                bit = stack & 1;
+                stack >>= 1;
+                stack |= bit;
+                pc++;
+                continue;
+        }
+        stack = (stack << 1) | bit;
+    }
+    return (stack & 1) != 0;
+}
+
+void RuleProgram::evaluateBatch(const uint32_t* values, size_t count, uint64_t* bits) const {
+    const size_t words = ScalarKernels::bitmapWords(count);
+    const uint64_t tailMask = (count % 64) ? (uint64_t(1) << (count % 64)) - 1 : ~uint64_t(0);
+    if (FAILED(status) || words == 0) {
+        std::fill(bits, bits + words, 0);
+        return;
+    }
+
+    // One bitmap per stack slot, plus a scratch bitmap for set members
+    std::vector<uint64_t> slots((maxDepth + 1) * words);
+    uint64_t* scratch = &slots[maxDepth * words];
+    size_t depth = 0;
+    auto slot = [&](size_t d) { return &slots[d * words]; };
+
+    const uint32_t* pc = code.data();
+    const uint32_t* end = pc + code.size();
+    while (pc < end) {
+        switch (pc[0]) {
+            case kOpRange:
+                ScalarKernels::inRange(values, count, pc[1], pc[2], slot(depth++));
+                pc += 3;
+                break;
+            case kOpMaskEq: {
+                uint64_t* out = slot(depth++);
+                std::fill(out, out + words, 0);
+                for (size_t i = 0; i < count; i++) {
+                    out[i / 64] |= uint64_t((values[i] & pc[1]) == pc[2]) << (i % 64);
+                }
+                pc += 3;
+                break;
+            }
+            case kOpInSet: {
+                uint64_t* out = slot(depth++);
+                std::fill(out, out + words, 0);
+                for (uint32_t m = 0; m < pc[1]; m++) {
+                    ScalarKernels::inRange(values, count, pc[2 + m], pc[2 + m], scratch);
+                    for (size_t w = 0; w < words; w++) {
+                        out[w] |= scratch[w];
+                    }
+                }
+                pc += 2 + pc[1];
+                break;
+            }
+            case kOpContains:
+            case kOpConst: {
+                // A column holds numbers only, so `contains` never matches there
+                uint64_t fill = (pc[0] == kOpConst && (pc[1] & 1)) ? ~uint64_t(0) : 0;
+                uint64_t* out = slot(depth++);
+                std::fill(out, out + words, fill);
+                out[words - 1] &= tailMask;
+                pc += 2;
+                break;
+            }
+            case kOpNot: {
+                uint64_t* top = slot(depth - 1);
+                for (size_t w = 0; w < words; w++) {
+                    top[w] = ~top[w];
+                }
+                top[words - 1] &= tailMask;
+                pc++;
+                break;
+            }
+            case kOpAnd:
+            case kOpOr: {
+                uint64_t* top = slot(--depth);
+                uint64_t* below = slot(depth - 1);
+                for (size_t w = 0; w < words; w++) {
+                    below[w] = (pc[0] == kOpAnd) ? (below[w] & top[w]) : (below[w] | top[w]);
+                }
+                pc++;
+                break;
+            }
+        }
+    }
+    std::copy(slot(0), slot(0) + words, bits);
+}
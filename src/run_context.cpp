@@ -0,0 +1,23 @@
+#include "include/run_context.h"
+#include "include/check_context.h"
+
+RunContext::RunContext(std::shared_ptr<SystemProbe> probe)
+    : probe(std::move(probe)), registry(*this->probe) {}
+
+RunContext& RunContext::current() {
+    CheckContext* context = CheckContext::current();
+    if (context && context->getRun()) {
+        return *context->getRun();
+    }
+    static RunContext fallback(SystemProbe::createDefault());
+    return fallback;
+}
+
+std::shared_ptr<RunContext::Slot> RunContext::slotFor(std::type_index type) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = slots[type];
+    if (!slot) {
+        slot = std::make_shared<Slot>();
+    }
+    return slot;
+}
\ No newline at end of file
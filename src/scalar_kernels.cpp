@@ -0,0 +1,131 @@
+#include "include/scalar_kernels.h"
+
+// SSE2 is part of the x86-64 baseline, so only the AVX2 path needs a CPU check
+#if defined(__x86_64__) || defined(_M_X64)
+#define SCALAR_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX2 for functions that ask for it; MSVC always can
+#if defined(__GNUC__) || defined(__clang__)
+#define SCALAR_KERNELS_AVX2 __attribute__((target("avx2")))
+#else
+#define SCALAR_KERNELS_AVX2
+#endif
+
+namespace {
+using Kernel = void (*)(const uint32_t*, size_t, uint32_t, uint32_t, uint64_t*);
+
+// Scalar loop for values [begin, count); `begin` is a multiple of 64
+void inRangeTail(const uint32_t* values, size_t begin, size_t count, uint32_t low, uint32_t high, uint64_t* bits) {
+    for (size_t word = begin; word < count; word += 64) {
+        uint64_t mask = 0;
+        size_t end = (count - word < 64) ? count : word + 64;
+        for (size_t i = word; i < end; i++) {
+            uint64_t in = (values[i] >= low) & (values[i] <= high);
+            mask |= in << (i - word);
+        }
+        bits[word / 64] = mask;
+    }
+}
+
+#ifdef SCALAR_KERNELS_X86
+// SSE2 and AVX2 only compare signed lanes; flipping the sign bit of both
+// sides turns that into the unsigned comparison.
+void inRangeSse2(const uint32_t* values, size_t count, uint32_t low, uint32_t high, uint64_t* bits) {
+    const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i lo = _mm_set1_epi32(static_cast<int>(low ^ 0x80000000u));
+    const __m128i hi = _mm_set1_epi32(static_cast<int>(high ^ 0x80000000u));
+
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t word = 0;
+        for (int lane = 0; lane < 16; lane++) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i + lane * 4));
+            v = _mm_xor_si128(v, bias);
+            __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(lo, v), _mm_cmpgt_epi32(v, hi));
+            uint64_t out = static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(outside)));
+            word |= (~out & 0xF) << (lane * 4);
+        }
+        bits[i / 64] = word;
+    }
+    inRangeTail(values, i, count, low, high, bits);
+}
+
+SCALAR_KERNELS_AVX2
+void inRangeAvx2(const uint32_t* values, size_t count, uint32_t low, uint32_t high, uint64_t* bits) {
+    const __m256i bias = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+    const __m256i lo = _mm256_set1_epi32(static_cast<int>(low ^ 0x80000000u));
+    const __m256i hi = _mm256_set1_epi32(static_cast<int>(high ^ 0x80000000u));
+
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t word = 0;
+        for (int lane = 0; lane < 8; lane++) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + lane * 8));
+            v = _mm256_xor_si256(v, bias);
+            __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(lo, v), _mm256_cmpgt_epi32(v, hi));
+            uint64_t out = static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(outside)));
+            word |= (~out & 0xFF) << (lane * 8);
+        }
+        bits[i / 64] = word;
+    }
+    inRangeTail(values, i, count, low, high, bits);
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // AVX2 also needs the OS to save the YMM registers (OSXSAVE + XCR0)
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+struct Dispatch {
+    Kernel kernel;
+    const char* name;
+};
+
+const Dispatch& selectKernel() {
+    static const Dispatch dispatch = []() -> Dispatch {
+#ifdef SCALAR_KERNELS_X86
+        if (cpuHasAvx2()) {
+            return { &inRangeAvx2, "avx2" };
+        }
+        return { &inRangeSse2, "sse2" };
+#else
+        return { &ScalarKernels::inRangeScalar, "scalar" };
+#endif
+    }();
+    return dispatch;
+}
+}
+
+void ScalarKernels::inRange(const uint32_t* values, size_t count, uint32_t low, uint32_t high, uint64_t* bits) {
+    selectKernel().kernel(values, count, low, high, bits);
+}
+
+void ScalarKernels::inRangeScalar(const uint32_t* values, size_t count, uint32_t low, uint32_t high, uint64_t* bits) {
+    inRangeTail(values, 0, count, low, high, bits);
+}
+
+const char* ScalarKernels::getKernelName() {
+    return selectKernel().name;
+}
\ No newline at end of file
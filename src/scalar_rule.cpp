@@ -0,0 +1,6 @@
+#include "include/scalar_rule.h"
+#include "include/run_context.h"
+
+HRESULT readRegistryDword(const ScalarRule& rule, DWORD& value) {
+    return RunContext::current().getRegistry().getDword(rule.path, rule.valueName, value);
+}
\ No newline at end of file
@@ -1,75 +1,86 @@
 #include "include/sections/section1/account_policies.h"
-#include <windows.h>
-#include <ntsecapi.h>
-#include <lm.h>
+#include "include/run_context.h"
 #include <iomanip>
 #include <sstream>
 
-// Utility function implementations
-std::string BenchmarkCheck::getLastErrorAsString() {
-    DWORD errorMessageID = ::GetLastError();
-    if (errorMessageID == 0) {
-        return "No error message available";
+namespace {
+    const wchar_t kNetlogonParameters[] = L"SYSTEM\\CurrentControlSet\\Services\\Netlogon\\Parameters";
+    const wchar_t kSamKey[] = L"SYSTEM\\CurrentControlSet\\Control\\SAM";
+    const char kPolicyReadFailed[] = "Failed to retrieve policy";
+    constexpr DWORD kSecondsPerMinute = 60;
+    constexpr DWORD kSecondsPerDay = 24 * 60 * 60;
+
+    // Scalar rule readers for the fields of the run's policy snapshot
+    template <DWORD PasswordModals::*Field>
+    HRESULT ReadPasswordModal(const ScalarRule&, DWORD& value) {
+        auto policy = AccountPoliciesSection::getPolicySnapshot();
+        if (SUCCEEDED(policy->passwordStatus)) {
+            value = policy->password.*Field;
+        }
+        return policy->passwordStatus;
+    }
+
+    template <DWORD LockoutModals::*Field>
+    HRESULT ReadLockoutModal(const ScalarRule&, DWORD& value) {
+        auto policy = AccountPoliciesSection::getPolicySnapshot();
+        if (SUCCEEDED(policy->lockoutStatus)) {
+            value = policy->lockout.*Field;
+        }
+        return policy->lockoutStatus;
+    }
+
+    template <DWORD PasswordProperties::*Field>
+    HRESULT ReadPasswordProperty(const ScalarRule&, DWORD& value) {
+        auto policy = AccountPoliciesSection::getPolicySnapshot();
+        if (SUCCEEDED(policy->propertiesStatus)) {
+            value = policy->properties.*Field;
+        }
+        return policy->propertiesStatus;
+    }
+
+    // PasswordComplexity from the backend when it supplies it (a template,
+    // a collection, a SAM hive), else the rule's registry value
+    HRESULT ReadPasswordComplexity(const ScalarRule& rule, DWORD& value) {
+        HRESULT hr = ReadPasswordProperty<&PasswordProperties::passwordComplexity>(rule, value);
+        return SUCCEEDED(hr) ? hr : readRegistryDword(rule, value);
     }
-    
-    LPSTR messageBuffer = nullptr;
-    size_t size = FormatMessageA(
-        FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-        NULL,
-        errorMessageID,
-        MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-        (LPSTR)&messageBuffer,
-        0,
-        NULL
-    );
-    
-    std::string message(messageBuffer, size);
-    LocalFree(messageBuffer);
-    
-    std::ostringstream oss;
-    oss << "Error (0x" << std::hex << std::setw(8) << std::setfill('0') << errorMessageID << "): " << message;
-    return oss.str();
-}
-
-std::string BenchmarkCheck::getNetApiErrorAsString(NET_API_STATUS nStatus) {
-    HMODULE hModule = NULL;
-    LPSTR messageBuffer = nullptr;
-    
-    FormatMessageA(
-        FORMAT_MESSAGE_ALLOCATE_BUFFER | 
-        FORMAT_MESSAGE_FROM_SYSTEM |
-        FORMAT_MESSAGE_IGNORE_INSERTS,
-        NULL,
-        nStatus,
-        MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-        (LPSTR)&messageBuffer,
-        0,
-        NULL
-    );
-    
-    std::string message = messageBuffer ? messageBuffer : "Unknown error";
-    LocalFree(messageBuffer);
-    
-    std::ostringstream oss;
-    oss << "NetApi Error (0x" << std::hex << std::setw(8) << std::setfill('0') << nStatus << "): " << message;
-    return oss.str();
 }
 
 void AccountPoliciesSection::initialize() {
-    // Password Policy Checks (1.1.x)
-    checks.push_back(std::make_unique<PasswordHistoryCheck>());
-    checks.push_back(std::make_unique<MaxPasswordAgeCheck>());
-    checks.push_back(std::make_unique<MinPasswordAgeCheck>());
-    checks.push_back(std::make_unique<MinPasswordLengthCheck>());
-    checks.push_back(std::make_unique<PasswordComplexityCheck>());
-    checks.push_back(std::make_unique<RelaxMinPasswordLengthCheck>());
-    checks.push_back(std::make_unique<StorePwdReversibleCheck>());
-    
-    // Account Lockout Policy Checks (1.2.x)
-    checks.push_back(std::make_unique<AccountLockoutDurationCheck>());
-    checks.push_back(std::make_unique<AccountLockoutThresholdCheck>());
-    checks.push_back(std::make_unique<AllowAdminLockoutCheck>());
-    checks.push_back(std::make_unique<ResetLockoutCounterCheck>());
+    static const CheckArray<
+        // Password Policy Checks (1.1.x)
+        PasswordHistoryCheck,
+        MaxPasswordAgeCheck,
+        MinPasswordAgeCheck,
+        MinPasswordLengthCheck,
+        PasswordComplexityCheck,
+        RelaxMinPasswordLengthCheck,
+        StorePwdReversibleCheck,
+
+        // Account Lockout Policy Checks (1.2.x)
+        AccountLockoutDurationCheck,
+        AccountLockoutThresholdCheck,
+        AllowAdminLockoutCheck,
+        ResetLockoutCounterCheck
+    > sectionChecks;
+    checks = sectionChecks.list();
+}
+
+void AccountPoliciesSection::declareInputs(ProbeInputs& inputs) const {
+    inputs.addAccountModals();
+}
+
+// NetUserModalsGet levels 0 and 3 and the password properties are fetched once
+// per run, on first use, and shared by every 1.x check instead of each check
+// making its own SAM call.
+std::shared_ptr<const AccountPolicySnapshot> AccountPoliciesSection::getPolicySnapshot() {
+    return RunContext::current().getOrBuild<AccountPolicySnapshot>([](SystemProbe& probe) {
+        AccountPolicySnapshot snapshot;
+        snapshot.passwordStatus = probe.queryPasswordModals(snapshot.password);
+        snapshot.lockoutStatus  = probe.queryLockoutModals(snapshot.lockout);
+        snapshot.propertiesStatus = probe.queryPasswordProperties(snapshot.properties);
+        return snapshot;
+    });
 }
 
 std::vector<BenchmarkResult> AccountPoliciesSection::runChecks() {
@@ -80,264 +91,242 @@ std::vector<BenchmarkResult> AccountPoliciesSection::runChecks() {
     return results;
 }
 
+const ScalarRule* PasswordHistoryCheck::getScalarRule() const {
+    static const ScalarRule rule{ &ReadPasswordModal<&PasswordModals::passwordHistLen>, L"", L"",
+                                  24, kScalarNoMaximum, CheckStatus::Error };
+    return &rule;
+}
+
 BenchmarkResult PasswordHistoryCheck::check() {
-    USER_MODALS_INFO_0 *pBuf;
-    NET_API_STATUS nStatus;
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error, "Failed to retrieve policy");
-
-    nStatus = NetUserModalsGet(nullptr, 0, (LPBYTE *)&pBuf);
-    if (nStatus == NERR_Success) {
-        if (pBuf->usrmod0_password_hist_len >= 24) {
-            result.status = CheckStatus::Pass;
-            result.details = "Password history is set to " + 
-                           std::to_string(pBuf->usrmod0_password_hist_len) + " password(s)";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Password history is set to " + 
-                           std::to_string(pBuf->usrmod0_password_hist_len) + 
-                           " password(s). Should be 24 or more.";
-        }
-        NetApiBufferFree(pBuf);
+    return checkScalar();
+}
+
+std::string PasswordHistoryCheck::describeScalar(CheckStatus status, DWORD value) const {
+    if (status == CheckStatus::Pass) {
+        return "Password history is set to " + std::to_string(value) + " password(s)";
+    } else if (status == CheckStatus::Fail) {
+        return "Password history is set to " + std::to_string(value) + 
+               " password(s). Should be 24 or more.";
     }
+    return kPolicyReadFailed;
+}
 
-    return result;
+// 1 to 365 days, in the seconds NetUserModalsGet reports
+const ScalarRule* MaxPasswordAgeCheck::getScalarRule() const {
+    static const ScalarRule rule{ &ReadPasswordModal<&PasswordModals::maxPasswdAge>, L"", L"",
+                                  kSecondsPerDay, 366 * kSecondsPerDay - 1, CheckStatus::Error };
+    return &rule;
 }
 
 BenchmarkResult MaxPasswordAgeCheck::check() {
-    USER_MODALS_INFO_0 *pBuf;
-    NET_API_STATUS nStatus;
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error, "Failed to retrieve policy");
-
-    nStatus = NetUserModalsGet(nullptr, 0, (LPBYTE *)&pBuf);
-    if (nStatus == NERR_Success) {
-        // Convert from seconds to days
-        DWORD maxAgeDays = pBuf->usrmod0_max_passwd_age / (24 * 60 * 60);
-        
-        if (maxAgeDays > 0 && maxAgeDays <= 365) {
-            result.status = CheckStatus::Pass;
-            result.details = "Maximum password age is set to " + 
-                           std::to_string(maxAgeDays) + " day(s)";
-        } else if (maxAgeDays == 0) {
-            result.status = CheckStatus::Fail;
-            result.details = "Maximum password age is set to never expire (0). Should be 365 or fewer days, but not 0.";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Maximum password age is set to " + 
-                           std::to_string(maxAgeDays) + 
-                           " day(s). Should be 365 or fewer days.";
-        }
-        NetApiBufferFree(pBuf);
+    return checkScalar();
+}
+
+std::string MaxPasswordAgeCheck::describeScalar(CheckStatus status, DWORD value) const {
+    // Convert from seconds to days
+    DWORD maxAgeDays = value / kSecondsPerDay;
+
+    if (status == CheckStatus::Pass) {
+        return "Maximum password age is set to " + std::to_string(maxAgeDays) + " day(s)";
+    } else if (status == CheckStatus::Fail && maxAgeDays == 0) {
+        return "Maximum password age is set to never expire (0). Should be 365 or fewer days, but not 0.";
+    } else if (status == CheckStatus::Fail) {
+        return "Maximum password age is set to " + std::to_string(maxAgeDays) + 
+               " day(s). Should be 365 or fewer days.";
     }
+    return kPolicyReadFailed;
+}
 
-    return result;
+const ScalarRule* MinPasswordAgeCheck::getScalarRule() const {
+    static const ScalarRule rule{ &ReadPasswordModal<&PasswordModals::minPasswdAge>, L"", L"",
+                                  kSecondsPerDay, kScalarNoMaximum, CheckStatus::Error };
+    return &rule;
 }
 
 BenchmarkResult MinPasswordAgeCheck::check() {
-    USER_MODALS_INFO_0 *pBuf;
-    NET_API_STATUS nStatus;
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error, "Failed to retrieve policy");
-
-    nStatus = NetUserModalsGet(nullptr, 0, (LPBYTE *)&pBuf);
-    if (nStatus == NERR_Success) {
-        if (pBuf->usrmod0_min_passwd_age >= 1) {
-            result.status = CheckStatus::Pass;
-            result.details = "Minimum password age is set to " + 
-                           std::to_string(pBuf->usrmod0_min_passwd_age) + " day(s)";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Minimum password age is set to " + 
-                           std::to_string(pBuf->usrmod0_min_passwd_age) + " day(s). Should be 1 or more.";
-        }
-        NetApiBufferFree(pBuf);
+    return checkScalar();
+}
+
+std::string MinPasswordAgeCheck::describeScalar(CheckStatus status, DWORD value) const {
+    // Convert from seconds to days
+    DWORD minAgeDays = value / kSecondsPerDay;
+
+    if (status == CheckStatus::Pass) {
+        return "Minimum password age is set to " + std::to_string(minAgeDays) + " day(s)";
+    } else if (status == CheckStatus::Fail) {
+        return "Minimum password age is set to " + std::to_string(minAgeDays) + " day(s). Should be 1 or more.";
     }
+    return kPolicyReadFailed;
+}
 
-    return result;
+const ScalarRule* MinPasswordLengthCheck::getScalarRule() const {
+    static const ScalarRule rule{ &ReadPasswordModal<&PasswordModals::minPasswdLen>, L"", L"",
+                                  14, kScalarNoMaximum, CheckStatus::Error };
+    return &rule;
 }
 
 BenchmarkResult MinPasswordLengthCheck::check() {
-    USER_MODALS_INFO_0 *pBuf;
-    NET_API_STATUS nStatus;
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error, "Failed to retrieve policy");
-
-    nStatus = NetUserModalsGet(nullptr, 0, (LPBYTE *)&pBuf);
-    if (nStatus == NERR_Success) {
-        if (pBuf->usrmod0_min_passwd_len >= 14) {
-            result.status = CheckStatus::Pass;
-            result.details = "Minimum password length is set to " + 
-                           std::to_string(pBuf->usrmod0_min_passwd_len) + " character(s)";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Minimum password length is set to " + 
-                           std::to_string(pBuf->usrmod0_min_passwd_len) + 
-                           " character(s). Should be 14 or more.";
-        }
-        NetApiBufferFree(pBuf);
+    return checkScalar();
+}
+
+std::string MinPasswordLengthCheck::describeScalar(CheckStatus status, DWORD value) const {
+    if (status == CheckStatus::Pass) {
+        return "Minimum password length is set to " + std::to_string(value) + " character(s)";
+    } else if (status == CheckStatus::Fail) {
+        return "Minimum password length is set to " + std::to_string(value) + 
+               " character(s). Should be 14 or more.";
     }
+    return kPolicyReadFailed;
+}
+
+void PasswordComplexityCheck::declareInputs(ProbeInputs& inputs) const {
+    inputs.addRegistryValue(kNetlogonParameters, L"PasswordComplexity");
+}
 
-    return result;
+const ScalarRule* PasswordComplexityCheck::getScalarRule() const {
+    static const ScalarRule rule{ &ReadPasswordComplexity, kNetlogonParameters, L"PasswordComplexity", 1, 1, CheckStatus::Error };
+    return &rule;
 }
 
 BenchmarkResult PasswordComplexityCheck::check() {
-    DWORD complexity;
-    std::wstring path = L"SYSTEM\\CurrentControlSet\\Services\\Netlogon\\Parameters";
-    std::wstring value = L"PasswordComplexity";
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error, "Failed to retrieve policy");
-
-    if (SUCCEEDED(getRegistryDwordValue(path, value, complexity))) {
-        if (complexity == 1) {
-            result.status = CheckStatus::Pass;
-            result.details = "Password complexity requirements are enabled";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Password complexity requirements are disabled";
-        }
+    return checkScalar();
+}
+
+std::string PasswordComplexityCheck::describeScalar(CheckStatus status, DWORD /*value*/) const {
+    if (status == CheckStatus::Pass) {
+        return "Password complexity requirements are enabled";
+    } else if (status == CheckStatus::Fail) {
+        return "Password complexity requirements are disabled";
     }
+    return kPolicyReadFailed;
+}
 
-    return result;
+void RelaxMinPasswordLengthCheck::declareInputs(ProbeInputs& inputs) const {
+    inputs.addRegistryValue(kSamKey, L"RelaxMinimumPasswordLengthLimits");
+}
+
+const ScalarRule* RelaxMinPasswordLengthCheck::getScalarRule() const {
+    static const ScalarRule rule{ &readRegistryDword, kSamKey, L"RelaxMinimumPasswordLengthLimits", 1, 1, CheckStatus::Error };
+    return &rule;
 }
 
 BenchmarkResult RelaxMinPasswordLengthCheck::check() {
-    DWORD relaxMinLen;
-    std::wstring path = L"SYSTEM\\CurrentControlSet\\Control\\SAM";
-    std::wstring value = L"RelaxMinimumPasswordLengthLimits";
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error, "Failed to retrieve policy");
-
-    if (SUCCEEDED(getRegistryDwordValue(path, value, relaxMinLen))) {
-        if (relaxMinLen == 1) {
-            result.status = CheckStatus::Pass;
-            result.details = "Relax minimum password length limits is enabled";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Relax minimum password length limits is disabled";
-        }
+    return checkScalar();
+}
+
+std::string RelaxMinPasswordLengthCheck::describeScalar(CheckStatus status, DWORD /*value*/) const {
+    if (status == CheckStatus::Pass) {
+        return "Relax minimum password length limits is enabled";
+    } else if (status == CheckStatus::Fail) {
+        return "Relax minimum password length limits is disabled";
     }
+    return kPolicyReadFailed;
+}
 
-    return result;
+const ScalarRule* StorePwdReversibleCheck::getScalarRule() const {
+    static const RuleProgram program("value == 0");
+    static const ScalarRule rule{ &ReadPasswordProperty<&PasswordProperties::clearTextPassword>, L"", L"",
+                                  0, 0, CheckStatus::Error, &program };
+    return &rule;
 }
 
 BenchmarkResult StorePwdReversibleCheck::check() {
-    USER_MODALS_INFO_0 *pBuf;
-    NET_API_STATUS nStatus;
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error, "Failed to retrieve policy");
-
-    nStatus = NetUserModalsGet(nullptr, 0, (LPBYTE *)&pBuf);
-    if (nStatus == NERR_Success) {
-        if ((pBuf->usrmod0_password_hist_len & 0x10) == 0) {
-            result.status = CheckStatus::Pass;
-            result.details = "Store passwords using reversible encryption is disabled";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Store passwords using reversible encryption is enabled";
-        }
-        NetApiBufferFree(pBuf);
+    return checkScalar();
+}
+
+std::string StorePwdReversibleCheck::describeScalar(CheckStatus status, DWORD /*value*/) const {
+    if (status == CheckStatus::Pass) {
+        return "Store passwords using reversible encryption is disabled";
+    } else if (status == CheckStatus::Fail) {
+        return "Store passwords using reversible encryption is enabled";
     }
+    return kPolicyReadFailed;
+}
 
-    return result;
+const ScalarRule* AccountLockoutDurationCheck::getScalarRule() const {
+    static const ScalarRule rule{ &ReadLockoutModal<&LockoutModals::lockoutDuration>, L"", L"",
+                                  15 * kSecondsPerMinute, kScalarNoMaximum, CheckStatus::Error };
+    return &rule;
 }
 
 BenchmarkResult AccountLockoutDurationCheck::check() {
-    USER_MODALS_INFO_3 *pBuf;
-    NET_API_STATUS nStatus;
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error, "Failed to retrieve policy");
-
-    nStatus = NetUserModalsGet(nullptr, 3, (LPBYTE *)&pBuf);
-    if (nStatus == NERR_Success) {
-        if (pBuf->usrmod3_lockout_duration >= 15) {
-            result.status = CheckStatus::Pass;
-            result.details = "Account lockout duration is set to " + 
-                           std::to_string(pBuf->usrmod3_lockout_duration) + " minute(s)";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Account lockout duration is set to " + 
-                           std::to_string(pBuf->usrmod3_lockout_duration) + 
-                           " minute(s). Should be 15 or more.";
-        }
-        NetApiBufferFree(pBuf);
+    return checkScalar();
+}
+
+std::string AccountLockoutDurationCheck::describeScalar(CheckStatus status, DWORD value) const {
+    // Convert from seconds to minutes
+    DWORD minutes = value / kSecondsPerMinute;
+
+    if (status == CheckStatus::Pass) {
+        return "Account lockout duration is set to " + std::to_string(minutes) + " minute(s)";
+    } else if (status == CheckStatus::Fail) {
+        return "Account lockout duration is set to " + std::to_string(minutes) + 
+               " minute(s). Should be 15 or more.";
     }
+    return kPolicyReadFailed;
+}
 
-    return result;
+const ScalarRule* AccountLockoutThresholdCheck::getScalarRule() const {
+    static const ScalarRule rule{ &ReadLockoutModal<&LockoutModals::lockoutThreshold>, L"", L"",
+                                  1, 5, CheckStatus::Error };
+    return &rule;
 }
 
 BenchmarkResult AccountLockoutThresholdCheck::check() {
-    USER_MODALS_INFO_3 *pBuf;
-    NET_API_STATUS nStatus;
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error, "Failed to retrieve policy");
-
-    nStatus = NetUserModalsGet(nullptr, 3, (LPBYTE *)&pBuf);
-    if (nStatus == NERR_Success) {
-        if (pBuf->usrmod3_lockout_threshold > 0 && pBuf->usrmod3_lockout_threshold <= 5) {
-            result.status = CheckStatus::Pass;
-            result.details = "Account lockout threshold is set to " + 
-                           std::to_string(pBuf->usrmod3_lockout_threshold) + " attempt(s)";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Account lockout threshold is set to " + 
-                           std::to_string(pBuf->usrmod3_lockout_threshold) + 
-                           " attempt(s). Should be between 1 and 5.";
-        }
-        NetApiBufferFree(pBuf);
+    return checkScalar();
+}
+
+std::string AccountLockoutThresholdCheck::describeScalar(CheckStatus status, DWORD value) const {
+    if (status == CheckStatus::Pass) {
+        return "Account lockout threshold is set to " + std::to_string(value) + " attempt(s)";
+    } else if (status == CheckStatus::Fail) {
+        return "Account lockout threshold is set to " + std::to_string(value) + 
+               " attempt(s). Should be between 1 and 5.";
     }
+    return kPolicyReadFailed;
+}
+
+void AllowAdminLockoutCheck::declareInputs(ProbeInputs& inputs) const {
+    inputs.addRegistryValue(kNetlogonParameters, L"AdminLockout");
+}
 
-    return result;
+const ScalarRule* AllowAdminLockoutCheck::getScalarRule() const {
+    static const ScalarRule rule{ &readRegistryDword, kNetlogonParameters, L"AdminLockout", 1, 1, CheckStatus::Error };
+    return &rule;
 }
 
 BenchmarkResult AllowAdminLockoutCheck::check() {
-    DWORD adminLockout;
-    std::wstring path = L"SYSTEM\\CurrentControlSet\\Services\\Netlogon\\Parameters";
-    std::wstring value = L"AdminLockout";
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error, "Failed to retrieve policy");
-
-    if (SUCCEEDED(getRegistryDwordValue(path, value, adminLockout))) {
-        if (adminLockout == 1) {
-            result.status = CheckStatus::Pass;
-            result.details = "Administrator account lockout is enabled";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Administrator account lockout is disabled";
-        }
+    return checkScalar();
+}
+
+std::string AllowAdminLockoutCheck::describeScalar(CheckStatus status, DWORD /*value*/) const {
+    if (status == CheckStatus::Pass) {
+        return "Administrator account lockout is enabled";
+    } else if (status == CheckStatus::Fail) {
+        return "Administrator account lockout is disabled";
     }
+    return kPolicyReadFailed;
+}
 
-    return result;
+const ScalarRule* ResetLockoutCounterCheck::getScalarRule() const {
+    static const ScalarRule rule{ &ReadLockoutModal<&LockoutModals::lockoutObservationWindow>, L"", L"",
+                                  15 * kSecondsPerMinute, kScalarNoMaximum, CheckStatus::Error };
+    return &rule;
 }
 
 BenchmarkResult ResetLockoutCounterCheck::check() {
-    USER_MODALS_INFO_3 *pBuf;
-    NET_API_STATUS nStatus;
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error, "Failed to retrieve policy");
-
-    nStatus = NetUserModalsGet(nullptr, 3, (LPBYTE *)&pBuf);
-    if (nStatus == NERR_Success) {
-        if (pBuf->usrmod3_lockout_observation_window >= 15) {
-            result.status = CheckStatus::Pass;
-            result.details = "Reset account lockout counter is set to " + 
-                           std::to_string(pBuf->usrmod3_lockout_observation_window) + " minute(s)";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Reset account lockout counter is set to " + 
-                           std::to_string(pBuf->usrmod3_lockout_observation_window) + 
-                           " minute(s). Should be 15 or more.";
-        }
-        NetApiBufferFree(pBuf);
-    }
-
-    return result;
+    return checkScalar();
 }
 
-// Registry access implementation
-HRESULT BenchmarkCheck::getRegistryDwordValue(const std::wstring& path, const std::wstring& value, DWORD& data) {
-    HKEY hKey;
-    LONG result = RegOpenKeyExW(HKEY_LOCAL_MACHINE, path.c_str(), 0, KEY_READ, &hKey);
-    
-    if (result != ERROR_SUCCESS) {
-        return HRESULT_FROM_WIN32(result);
+std::string ResetLockoutCounterCheck::describeScalar(CheckStatus status, DWORD value) const {
+    // Convert from seconds to minutes
+    DWORD minutes = value / kSecondsPerMinute;
+
+    if (status == CheckStatus::Pass) {
+        return "Reset account lockout counter is set to " + std::to_string(minutes) + " minute(s)";
+    } else if (status == CheckStatus::Fail) {
+        return "Reset account lockout counter is set to " + std::to_string(minutes) + 
+               " minute(s). Should be 15 or more.";
     }
-    
-    DWORD dataSize = sizeof(DWORD);
-    DWORD type = REG_DWORD;
-    
-    result = RegQueryValueExW(hKey, value.c_str(), NULL, &type, reinterpret_cast<LPBYTE>(&data), &dataSize);
-    RegCloseKey(hKey);
-    
-    return HRESULT_FROM_WIN32(result);
+    return kPolicyReadFailed;
 }
-
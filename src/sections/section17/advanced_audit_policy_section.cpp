@@ -1,56 +1,142 @@
 #include "include/sections/section17/advanced_audit_policy_section.h"
-#include <windows.h>
+#include "include/rule_program.h"
+#include "include/run_context.h"
+#include "include/string_utils.h"
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <iostream>
 
+namespace {
+// What each 17.x check expects of a subcategory's inclusion flags
+const RuleProgram kSuccessAndFailure("value has success|failure");
+const RuleProgram kIncludesSuccess("value has success");
+const RuleProgram kIncludesFailure("value has failure");
+
+struct SubcategoryGuid {
+    std::wstring_view name;
+    std::wstring_view guid;
+};
+
+// Subcategory GUIDs are the same in every locale, unlike the names auditpol
+// prints, so checks match on these first.
+constexpr SubcategoryGuid kSubcategoryGuids[] = {
+    { L"Credential Validation",           L"{0CCE923F-69AE-11D9-BED3-505054503030}" },
+    { L"Application Group Management",    L"{0CCE9239-69AE-11D9-BED3-505054503030}" },
+    { L"Security Group Management",       L"{0CCE9237-69AE-11D9-BED3-505054503030}" },
+    { L"User Account Management",         L"{0CCE9235-69AE-11D9-BED3-505054503030}" },
+    { L"Plug and Play Events",            L"{0CCE9248-69AE-11D9-BED3-505054503030}" },
+    { L"Process Creation",                L"{0CCE922B-69AE-11D9-BED3-505054503030}" },
+    { L"Account Lockout",                 L"{0CCE9217-69AE-11D9-BED3-505054503030}" },
+    { L"Group Membership",                L"{0CCE9249-69AE-11D9-BED3-505054503030}" },
+    { L"Logoff",                          L"{0CCE9216-69AE-11D9-BED3-505054503030}" },
+    { L"Logon",                           L"{0CCE9215-69AE-11D9-BED3-505054503030}" },
+    { L"Other Logon/Logoff Events",       L"{0CCE921C-69AE-11D9-BED3-505054503030}" },
+    { L"Special Logon",                   L"{0CCE921B-69AE-11D9-BED3-505054503030}" },
+    { L"Detailed File Share",             L"{0CCE9244-69AE-11D9-BED3-505054503030}" },
+    { L"File Share",                      L"{0CCE9224-69AE-11D9-BED3-505054503030}" },
+    { L"Other Object Access Events",      L"{0CCE9227-69AE-11D9-BED3-505054503030}" },
+    { L"Removable Storage",               L"{0CCE9245-69AE-11D9-BED3-505054503030}" },
+    { L"Audit Policy Change",             L"{0CCE922F-69AE-11D9-BED3-505054503030}" },
+    { L"Authentication Policy Change",    L"{0CCE9230-69AE-11D9-BED3-505054503030}" },
+    { L"Authorization Policy Change",     L"{0CCE9231-69AE-11D9-BED3-505054503030}" },
+    { L"MPSSVC Rule-Level Policy Change", L"{0CCE9232-69AE-11D9-BED3-505054503030}" },
+    { L"Other Policy Change Events",      L"{0CCE9234-69AE-11D9-BED3-505054503030}" },
+    { L"Sensitive Privilege Use",         L"{0CCE9228-69AE-11D9-BED3-505054503030}" },
+    { L"IPsec Driver",                    L"{0CCE9213-69AE-11D9-BED3-505054503030}" },
+    { L"Other System Events",             L"{0CCE9214-69AE-11D9-BED3-505054503030}" },
+    { L"Security State Change",           L"{0CCE9210-69AE-11D9-BED3-505054503030}" },
+    { L"Security System Extension",       L"{0CCE9211-69AE-11D9-BED3-505054503030}" },
+    { L"System Integrity",                L"{0CCE9212-69AE-11D9-BED3-505054503030}" },
+};
+
+std::wstring_view findSubcategoryGuid(const std::wstring& subcategory)
+{
+    for (const SubcategoryGuid& entry : kSubcategoryGuids) {
+        if (equalsIgnoreCase(std::wstring(entry.name), subcategory)) {
+            return entry.guid;
+        }
+    }
+    return {};
+}
+}
+
+// -----------------------------------------------------
+// AuditPolicyTable Implementation
+// -----------------------------------------------------
+AuditPolicyTable::AuditPolicyTable(HRESULT status, std::vector<AuditSubcategorySetting> settings)
+    : status(status), settings(std::move(settings))
+{
+    for (size_t i = 0; i < this->settings.size(); i++) {
+        byName.emplace(toLowerCopy(this->settings[i].subcategory), i);
+        if (!this->settings[i].guid.empty()) {
+            byGuid.emplace(toLowerCopy(this->settings[i].guid), i);
+        }
+    }
+}
+
+const AuditSubcategorySetting* AuditPolicyTable::find(const std::wstring& subcategory) const
+{
+    auto it = byName.find(toLowerCopy(subcategory));
+    return (it != byName.end()) ? &settings[it->second] : nullptr;
+}
+
+const AuditSubcategorySetting* AuditPolicyTable::findByGuid(const std::wstring& guid) const
+{
+    auto it = byGuid.find(toLowerCopy(guid));
+    return (it != byGuid.end()) ? &settings[it->second] : nullptr;
+}
+
 // -----------------------------------------------------
 // AdvancedAuditPolicySection Implementation
 // -----------------------------------------------------
 void AdvancedAuditPolicySection::initialize()
 {
-    // 17.1.1
-    checks.push_back(std::make_unique<AuditCredentialValidationCheck>());
-    
-    // 17.2.x
-    checks.push_back(std::make_unique<AuditApplicationGroupManagementCheck>());
-    checks.push_back(std::make_unique<AuditSecurityGroupManagementCheck>());
-    checks.push_back(std::make_unique<AuditUserAccountManagementCheck>());
-
-    // 17.3.x
-    checks.push_back(std::make_unique<AuditPNPActivityCheck>());
-    checks.push_back(std::make_unique<AuditProcessCreationCheck>());
-
-    // 17.5.x
-    checks.push_back(std::make_unique<AuditAccountLockoutCheck>());
-    checks.push_back(std::make_unique<AuditGroupMembershipCheck>());
-    checks.push_back(std::make_unique<AuditLogoffCheck>());
-    checks.push_back(std::make_unique<AuditLogonCheck>());
-    checks.push_back(std::make_unique<AuditOtherLogonEventsCheck>());
-    checks.push_back(std::make_unique<AuditSpecialLogonCheck>());
-
-    // 17.6.x
-    checks.push_back(std::make_unique<AuditDetailedFileShareCheck>());
-    checks.push_back(std::make_unique<AuditFileShareCheck>());
-    checks.push_back(std::make_unique<AuditOtherObjectAccessEventsCheck>());
-    checks.push_back(std::make_unique<AuditRemovableStorageCheck>());
-
-    // 17.7.x
-    checks.push_back(std::make_unique<AuditPolicyChangeCheck>());
-    checks.push_back(std::make_unique<AuditAuthenticationPolicyChangeCheck>());
-    checks.push_back(std::make_unique<AuditAuthorizationPolicyChangeCheck>());
-    checks.push_back(std::make_unique<AuditMPSSVCRuleLevelPolicyCheck>());
-    checks.push_back(std::make_unique<AuditOtherPolicyChangeEventsCheck>());
-
-    // 17.8.x
-    checks.push_back(std::make_unique<AuditSensitivePrivilegeUseCheck>());
-
-    // 17.9.x
-    checks.push_back(std::make_unique<AuditIPsecDriverCheck>());
-    checks.push_back(std::make_unique<AuditOtherSystemEventsCheck>());
-    checks.push_back(std::make_unique<AuditSecurityStateChangeCheck>());
-    checks.push_back(std::make_unique<AuditSecuritySystemExtensionCheck>());
-    checks.push_back(std::make_unique<AuditSystemIntegrityCheck>());
+    static const CheckArray<
+        // 17.1.1
+        AuditCredentialValidationCheck,
+
+        // 17.2.x
+        AuditApplicationGroupManagementCheck,
+        AuditSecurityGroupManagementCheck,
+        AuditUserAccountManagementCheck,
+
+        // 17.3.x
+        AuditPNPActivityCheck,
+        AuditProcessCreationCheck,
+
+        // 17.5.x
+        AuditAccountLockoutCheck,
+        AuditGroupMembershipCheck,
+        AuditLogoffCheck,
+        AuditLogonCheck,
+        AuditOtherLogonEventsCheck,
+        AuditSpecialLogonCheck,
+
+        // 17.6.x
+        AuditDetailedFileShareCheck,
+        AuditFileShareCheck,
+        AuditOtherObjectAccessEventsCheck,
+        AuditRemovableStorageCheck,
+
+        // 17.7.x
+        AuditPolicyChangeCheck,
+        AuditAuthenticationPolicyChangeCheck,
+        AuditAuthorizationPolicyChangeCheck,
+        AuditMPSSVCRuleLevelPolicyCheck,
+        AuditOtherPolicyChangeEventsCheck,
+
+        // 17.8.x
+        AuditSensitivePrivilegeUseCheck,
+
+        // 17.9.x
+        AuditIPsecDriverCheck,
+        AuditOtherSystemEventsCheck,
+        AuditSecurityStateChangeCheck,
+        AuditSecuritySystemExtensionCheck,
+        AuditSystemIntegrityCheck
+    > sectionChecks;
+    checks = sectionChecks.list();
 }
 
 std::vector<BenchmarkResult> AdvancedAuditPolicySection::runChecks()
@@ -62,145 +148,58 @@ std::vector<BenchmarkResult> AdvancedAuditPolicySection::runChecks()
     return results;
 }
 
+void AdvancedAuditPolicySection::declareInputs(ProbeInputs& inputs) const
+{
+    inputs.addAuditPolicy();
+}
+
+// The whole audit policy is read once per run, on first use, instead of one
+// auditpol.exe process per check.
+std::shared_ptr<const AuditPolicyTable> AdvancedAuditPolicySection::getAuditPolicy()
+{
+    return RunContext::current().getOrBuild<AuditPolicyTable>([](SystemProbe& probe) {
+        std::vector<AuditSubcategorySetting> settings;
+        HRESULT hr = probe.queryAuditPolicy(settings);
+        return AuditPolicyTable(hr, std::move(settings));
+    });
+}
+
 /**
  * CheckAuditSetting:
- *  1. Runs: auditpol.exe /get /subcategory:"<subcategory>" /r
- *  2. Captures output as a single string
- *  3. Checks if the line corresponding to that subcategory includes the `expectedSetting`.
+ *  1. Looks the subcategory up in the run's audit policy table
+ *     (live: auditpol.exe /get /category:* /r, run once), by its GUID
+ *     first so localized names still match, then by name
+ *  2. Parses its inclusion setting into audit flags and tests them with
+ *     the `expected` rule program (e.g. "value has success"), setting
+ *     `pass` to the outcome.
+ *  Fails, leaving the check in error, when the audit policy could not be
+ *  read; a subcategory the policy does not list does not pass.
  * 
  * The subcategory strings below must match EXACTLY how Windows labels them.
  * e.g. "Credential Validation", "Logon", "File Share", etc.
  */
-bool AdvancedAuditPolicySection::CheckAuditSetting(const std::wstring& subcategory, const std::wstring& expectedSetting)
+HRESULT AdvancedAuditPolicySection::CheckAuditSetting(const std::wstring& subcategory, const RuleProgram& expected,
+                                                      bool& pass)
 {
-    // Build the arguments for auditpol
-    std::wstringstream ss;
-    ss << L"/get /subcategory:\"" << subcategory << L"\" /r";
-    std::wstring output = RunAuditpol(ss.str());
-
-    if (output.empty()) {
-        return false; // Could not read or parse
+    pass = false;
+    auto policy = getAuditPolicy();
+    if (FAILED(policy->getStatus())) {
+        return policy->getStatus(); // Could not read or parse
     }
 
-    // Convert to lowercase for case-insensitive matching
-    auto toLower = [](const std::wstring& s) {
-        std::wstring lower(s);
-        for (auto& ch : lower) {
-            ch = towlower(ch);
-        }
-        return lower;
-    };
-
-    std::wstring lowerOutput  = toLower(output);
-    std::wstring lowerSubcat  = toLower(subcategory);
-    std::wstring lowerExpect  = toLower(expectedSetting);
-
-    // Find line that contains subcategory
-    size_t subcatPos = lowerOutput.find(lowerSubcat);
-    if (subcatPos == std::wstring::npos) {
-        return false;
+    const AuditSubcategorySetting* entry = nullptr;
+    std::wstring_view guid = findSubcategoryGuid(subcategory);
+    if (!guid.empty()) {
+        entry = policy->findByGuid(std::wstring(guid));
     }
-    // Grab that entire line
-    size_t lineEnd = lowerOutput.find(L'\n', subcatPos);
-    if (lineEnd == std::wstring::npos) {
-        lineEnd = lowerOutput.size();
+    if (!entry) {
+        entry = policy->find(subcategory);
     }
-    std::wstring line = lowerOutput.substr(subcatPos, lineEnd - subcatPos);
-
-    // Check if line includes the expected setting text
-    return (line.find(lowerExpect) != std::wstring::npos);
-}
-
-/**
- * RunAuditpol:
- *  - Creates child process "auditpol.exe <arguments>",
- *  - Captures stdout,
- *  - Returns entire output as wstring.
- */
-std::wstring AdvancedAuditPolicySection::RunAuditpol(const std::wstring& arguments)
-{
-    std::wstringstream cmd;
-    cmd << L"auditpol.exe " << arguments;
-
-    // Create pipe
-    SECURITY_ATTRIBUTES sa;
-    ZeroMemory(&sa, sizeof(sa));
-    sa.nLength              = sizeof(sa);
-    sa.bInheritHandle       = TRUE;
-    sa.lpSecurityDescriptor = NULL;
-
-    HANDLE hReadPipe  = nullptr;
-    HANDLE hWritePipe = nullptr;
-    if (!CreatePipe(&hReadPipe, &hWritePipe, &sa, 0)) {
-        return L"";
-    }
-    if (!SetHandleInformation(hReadPipe, HANDLE_FLAG_INHERIT, 0)) {
-        CloseHandle(hReadPipe);
-        CloseHandle(hWritePipe);
-        return L"";
-    }
-
-    // Setup STARTUPINFO
-    STARTUPINFOW si;
-    ZeroMemory(&si, sizeof(si));
-    si.cb         = sizeof(si);
-    si.hStdOutput = hWritePipe;
-    si.hStdError  = hWritePipe;
-    si.dwFlags    = STARTF_USESTDHANDLES;
-
-    PROCESS_INFORMATION pi;
-    ZeroMemory(&pi, sizeof(pi));
-
-    std::wstring cmdLine = cmd.str();
-    if (!CreateProcessW(
-        nullptr,
-        &cmdLine[0],
-        nullptr,
-        nullptr,
-        TRUE,
-        0,
-        nullptr,
-        nullptr,
-        &si,
-        &pi))
-    {
-        CloseHandle(hReadPipe);
-        CloseHandle(hWritePipe);
-        return L"";
-    }
-
-    // Close our write handle so we can read from the read end
-    CloseHandle(hWritePipe);
-
-    // Read the output
-    std::wstring result;
-    const DWORD BUFSIZE = 4096;
-    char buffer[BUFSIZE];
-    DWORD bytesRead = 0;
-
-    while (true) {
-        if (!ReadFile(hReadPipe, buffer, BUFSIZE - 1, &bytesRead, nullptr) || bytesRead == 0) {
-            break;
-        }
-        buffer[bytesRead] = '\0';
-
-        // Convert to wide
-        int wchars = MultiByteToWideChar(CP_ACP, 0, buffer, -1, nullptr, 0);
-        if (wchars > 0) {
-            std::wstring wbuf(wchars - 1, L'\0');
-            MultiByteToWideChar(CP_ACP, 0, buffer, -1, &wbuf[0], wchars);
-            result.append(wbuf);
-        }
+    if (!entry) {
+        return S_OK;
     }
-
-    CloseHandle(hReadPipe);
-
-    // Wait for process to finish
-    WaitForSingleObject(pi.hProcess, INFINITE);
-    CloseHandle(pi.hProcess);
-    CloseHandle(pi.hThread);
-
-    return result;
+    pass = expected.test(parseAuditFlags(entry->inclusionSetting));
+    return S_OK;
 }
 
 // -----------------------------------------------------
@@ -212,9 +211,13 @@ BenchmarkResult AuditCredentialValidationCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Credential Validation'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Credential Validation", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Credential Validation", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Credential Validation' is set to 'Success and Failure'";
@@ -230,9 +233,13 @@ BenchmarkResult AuditApplicationGroupManagementCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Application Group Management'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Application Group Management", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Application Group Management", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Application Group Management' is set to 'Success and Failure'";
@@ -248,11 +255,15 @@ BenchmarkResult AuditSecurityGroupManagementCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Security Group Management'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Security Group Management", L"Success"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Security Group Management", kIncludesSuccess, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     // This control specifically wants "include 'Success'." If you require
-    // "Success and Failure," change to L"Success and Failure".
+    // "Success and Failure," change to kSuccessAndFailure.
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Security Group Management' includes 'Success'";
@@ -268,9 +279,13 @@ BenchmarkResult AuditUserAccountManagementCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit User Account Management'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"User Account Management", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"User Account Management", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit User Account Management' is set to 'Success and Failure'";
@@ -286,9 +301,13 @@ BenchmarkResult AuditPNPActivityCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit PNP Activity'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Plug and Play Events", L"Success"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Plug and Play Events", kIncludesSuccess, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit PNP Activity' includes 'Success'";
@@ -304,9 +323,13 @@ BenchmarkResult AuditProcessCreationCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Process Creation'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Process Creation", L"Success"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Process Creation", kIncludesSuccess, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Process Creation' includes 'Success'";
@@ -322,9 +345,13 @@ BenchmarkResult AuditAccountLockoutCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Account Lockout'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Account Lockout", L"Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Account Lockout", kIncludesFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Account Lockout' includes 'Failure'";
@@ -340,9 +367,13 @@ BenchmarkResult AuditGroupMembershipCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Group Membership'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Group Membership", L"Success"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Group Membership", kIncludesSuccess, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Group Membership' includes 'Success'";
@@ -358,9 +389,13 @@ BenchmarkResult AuditLogoffCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Logoff'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Logoff", L"Success"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Logoff", kIncludesSuccess, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Logoff' includes 'Success'";
@@ -376,9 +411,13 @@ BenchmarkResult AuditLogonCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Logon'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Logon", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Logon", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Logon' is set to 'Success and Failure'";
@@ -394,9 +433,13 @@ BenchmarkResult AuditOtherLogonEventsCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Other Logon/Logoff Events'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Other Logon/Logoff Events", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Other Logon/Logoff Events", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Other Logon/Logoff Events' is set to 'Success and Failure'";
@@ -412,9 +455,13 @@ BenchmarkResult AuditSpecialLogonCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Special Logon'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Special Logon", L"Success"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Special Logon", kIncludesSuccess, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Special Logon' includes 'Success'";
@@ -430,9 +477,13 @@ BenchmarkResult AuditDetailedFileShareCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Detailed File Share'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Detailed File Share", L"Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Detailed File Share", kIncludesFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Detailed File Share' includes 'Failure'";
@@ -448,9 +499,13 @@ BenchmarkResult AuditFileShareCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit File Share'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"File Share", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"File Share", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit File Share' is set to 'Success and Failure'";
@@ -466,9 +521,13 @@ BenchmarkResult AuditOtherObjectAccessEventsCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Other Object Access Events'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Other Object Access Events", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Other Object Access Events", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Other Object Access Events' is set to 'Success and Failure'";
@@ -484,9 +543,13 @@ BenchmarkResult AuditRemovableStorageCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Removable Storage'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Removable Storage", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Removable Storage", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Removable Storage' is set to 'Success and Failure'";
@@ -502,9 +565,13 @@ BenchmarkResult AuditPolicyChangeCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Audit Policy Change'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Audit Policy Change", L"Success"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Audit Policy Change", kIncludesSuccess, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Audit Policy Change' includes 'Success'";
@@ -520,9 +587,13 @@ BenchmarkResult AuditAuthenticationPolicyChangeCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Authentication Policy Change'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Authentication Policy Change", L"Success"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Authentication Policy Change", kIncludesSuccess, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Authentication Policy Change' includes 'Success'";
@@ -538,9 +609,13 @@ BenchmarkResult AuditAuthorizationPolicyChangeCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Authorization Policy Change'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Authorization Policy Change", L"Success"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Authorization Policy Change", kIncludesSuccess, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Authorization Policy Change' includes 'Success'";
@@ -556,9 +631,13 @@ BenchmarkResult AuditMPSSVCRuleLevelPolicyCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit MPSSVC Rule-Level Policy Change'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"MPSSVC Rule-Level Policy Change", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"MPSSVC Rule-Level Policy Change", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit MPSSVC Rule-Level Policy Change' is set to 'Success and Failure'";
@@ -574,9 +653,13 @@ BenchmarkResult AuditOtherPolicyChangeEventsCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Other Policy Change Events'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Other Policy Change Events", L"Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Other Policy Change Events", kIncludesFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Other Policy Change Events' includes 'Failure'";
@@ -592,9 +675,13 @@ BenchmarkResult AuditSensitivePrivilegeUseCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Sensitive Privilege Use'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Sensitive Privilege Use", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Sensitive Privilege Use", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Sensitive Privilege Use' is set to 'Success and Failure'";
@@ -610,9 +697,13 @@ BenchmarkResult AuditIPsecDriverCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit IPsec Driver'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"IPsec Driver", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"IPsec Driver", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit IPsec Driver' is set to 'Success and Failure'";
@@ -628,9 +719,13 @@ BenchmarkResult AuditOtherSystemEventsCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Other System Events'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Other System Events", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Other System Events", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Other System Events' is set to 'Success and Failure'";
@@ -646,9 +741,13 @@ BenchmarkResult AuditSecurityStateChangeCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Security State Change'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Security State Change", L"Success"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Security State Change", kIncludesSuccess, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Security State Change' includes 'Success'";
@@ -664,9 +763,13 @@ BenchmarkResult AuditSecuritySystemExtensionCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit Security System Extension'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"Security System Extension", L"Success"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"Security System Extension", kIncludesSuccess, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit Security System Extension' includes 'Success'";
@@ -682,9 +785,13 @@ BenchmarkResult AuditSystemIntegrityCheck::check()
 {
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,
                       "Failed to check 'Audit System Integrity'");
-    bool pass = AdvancedAuditPolicySection::CheckAuditSetting(
-        L"System Integrity", L"Success and Failure"
+    bool pass = false;
+    HRESULT hr = AdvancedAuditPolicySection::CheckAuditSetting(
+        L"System Integrity", kSuccessAndFailure, pass
     );
+    if (FAILED(hr)) {
+        return r;
+    }
     if (pass) {
         r.status  = CheckStatus::Pass;
         r.details = "'Audit System Integrity' is set to 'Success and Failure'";
@@ -0,0 +1,449 @@
+#include "include/sections/section18/administrative_templates_section.h"
+#include "include/admx_index.h"
+#include "include/run_context.h"
+#include <array>
+
+namespace {
+    const wchar_t kPersonalizationKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\Personalization";
+    const wchar_t kNetworkConnectionsKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\Network Connections";
+    const wchar_t kWcmGroupPolicyKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\WcmSvc\\GroupPolicy";
+    const wchar_t kPrintersKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows NT\\Printers";
+    const wchar_t kPointAndPrintKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows NT\\Printers\\PointAndPrint";
+    const wchar_t kDeviceGuardKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\DeviceGuard";
+    const wchar_t kSystemKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\System";
+    const wchar_t kSleepSettingsKey[] = L"SOFTWARE\\Policies\\Microsoft\\Power\\PowerSettings\\0e796bdb-100d-47d6-a2d5-f7d2daa51f51";
+    const wchar_t kTerminalServicesKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows NT\\Terminal Services";
+    const wchar_t kRpcKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows NT\\Rpc";
+    const wchar_t kExplorerKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\Explorer";
+    const wchar_t kCloudContentKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\CloudContent";
+    const wchar_t kDataCollectionKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\DataCollection";
+    const wchar_t kDefenderKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows Defender";
+    const wchar_t kDefenderRealTimeKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows Defender\\Real-Time Protection";
+    const wchar_t kDefenderScanKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows Defender\\Scan";
+    const wchar_t kWindowsSearchKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\Windows Search";
+    const wchar_t kInstallerKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\Installer";
+    const wchar_t kWinRmClientKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\WinRM\\Client";
+    const wchar_t kWinRmServiceKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\WinRM\\Service";
+    const wchar_t kWindowsUpdateKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\WindowsUpdate";
+    const wchar_t kAutoUpdateKey[] = L"SOFTWARE\\Policies\\Microsoft\\Windows\\WindowsUpdate\\AU";
+
+    constexpr AdmxElement Boolean = AdmxElement::Boolean;
+    constexpr AdmxElement Decimal = AdmxElement::Decimal;
+    constexpr AdmxElement Enum = AdmxElement::Enum;
+
+    /**
+     * Machine policy definitions the section reads, compiled from the ADMX
+     * files named in the comments: policy name, display name, key, value,
+     * element type, and the values Enabled and Disabled write. Several
+     * "Turn off" and "Prohibit" policies write 0 when enabled.
+     */
+    constexpr AdmxPolicy kAdmxPolicies[] = {
+        // ControlPanelDisplay.admx
+        { "CPL_Personalization_NoLockScreenCamera", "Prevent enabling lock screen camera",
+          kPersonalizationKey, L"NoLockScreenCamera", Boolean, 1, 0 },
+        { "CPL_Personalization_NoLockScreenSlideshow", "Prevent enabling lock screen slide show",
+          kPersonalizationKey, L"NoLockScreenSlideshow", Boolean, 1, 0 },
+        // Globalization.admx
+        { "AllowInputPersonalization", "Allow users to enable online speech recognition services",
+          L"SOFTWARE\\Policies\\Microsoft\\InputPersonalization", L"AllowInputPersonalization", Boolean, 1, 0 },
+        // DnsClient.admx
+        { "Turn_Off_Multicast", "Turn off multicast name resolution",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows NT\\DNSClient", L"EnableMulticast", Boolean, 0, 1 },
+        // LanmanWorkstation.admx
+        { "Pol_EnableInsecureGuestLogons", "Enable insecure guest logons",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\LanmanWorkstation", L"AllowInsecureGuestAuth", Boolean, 1, 0 },
+        // NetworkConnections.admx
+        { "NC_AllowNetBridge_NLA", "Prohibit installation and configuration of Network Bridge on your DNS domain network",
+          kNetworkConnectionsKey, L"NC_AllowNetBridge_NLA", Boolean, 0, 1 },
+        { "NC_ShowSharedAccessUI", "Prohibit use of Internet Connection Sharing on your DNS domain network",
+          kNetworkConnectionsKey, L"NC_ShowSharedAccessUI", Boolean, 0, 1 },
+        { "NC_StdDomainUserSetLocation", "Require domain users to elevate when setting a network's location",
+          kNetworkConnectionsKey, L"NC_StdDomainUserSetLocation", Boolean, 1, 0 },
+        // wcm.admx
+        { "WCM_MinimizeConnections", "Minimize the number of simultaneous connections to the Internet or a Windows Domain",
+          kWcmGroupPolicyKey, L"fMinimizeConnections", Enum, 0, 0 },
+        { "WCM_BlockNonDomain", "Prohibit connection to non-domain networks when connected to domain authenticated network",
+          kWcmGroupPolicyKey, L"fBlockNonDomain", Boolean, 1, 0 },
+        // Printing.admx
+        { "RedirectionGuardPolicy", "Configure Redirection Guard",
+          kPrintersKey, L"RedirectionguardPolicy", Enum, 0, 0 },
+        { "RestrictDriverInstallationToAdministrators", "Limits print driver installation to Administrators",
+          kPointAndPrintKey, L"RestrictDriverInstallationToAdministrators", Boolean, 1, 0 },
+        // DeviceGuard.admx
+        { "VirtualizationBasedSecurity", "Turn On Virtualization Based Security",
+          kDeviceGuardKey, L"EnableVirtualizationBasedSecurity", Boolean, 1, 0 },
+        { "RequirePlatformSecurityFeatures", "Turn On Virtualization Based Security: Select Platform Security Level",
+          kDeviceGuardKey, L"RequirePlatformSecurityFeatures", Enum, 0, 0 },
+        { "HypervisorEnforcedCodeIntegrity", "Turn On Virtualization Based Security: Virtualization Based Protection of Code Integrity",
+          kDeviceGuardKey, L"HypervisorEnforcedCodeIntegrity", Enum, 0, 0 },
+        { "LsaCfgFlags", "Turn On Virtualization Based Security: Credential Guard Configuration",
+          kDeviceGuardKey, L"LsaCfgFlags", Enum, 0, 0 },
+        { "ConfigureSystemGuardLaunch", "Turn On Virtualization Based Security: Secure Launch Configuration",
+          kDeviceGuardKey, L"ConfigureSystemGuardLaunch", Enum, 0, 0 },
+        // DeviceSetup.admx
+        { "DeviceMetadata_PreventDeviceMetadataFromNetwork", "Prevent device metadata retrieval from the Internet",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\Device Metadata", L"PreventDeviceMetadataFromNetwork", Boolean, 1, 0 },
+        // ICM.admx
+        { "DisableWebPnPDownload_2", "Turn off downloading of print drivers over HTTP",
+          kPrintersKey, L"DisableWebPnPDownload", Boolean, 1, 0 },
+        { "DisableHTTPPrinting_2", "Turn off printing over HTTP",
+          kPrintersKey, L"DisableHTTPPrinting", Boolean, 1, 0 },
+        { "CEIPEnable", "Turn off Windows Customer Experience Improvement Program",
+          L"SOFTWARE\\Policies\\Microsoft\\SQMClient\\Windows", L"CEIPEnable", Boolean, 0, 1 },
+        { "PCH_DoNotReport", "Turn off Windows Error Reporting",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\Windows Error Reporting", L"Disabled", Boolean, 1, 0 },
+        // Logon.admx, CredentialProviders.admx
+        { "BlockUserFromShowingAccountDetailsOnSignin", "Block user from showing account details on sign-in",
+          kSystemKey, L"BlockUserFromShowingAccountDetailsOnSignin", Boolean, 1, 0 },
+        { "NoNetworkSelectionUI", "Do not display network selection UI",
+          kSystemKey, L"DontDisplayNetworkSelectionUI", Boolean, 1, 0 },
+        { "NoEnumerateConnectedUsers", "Do not enumerate connected users on domain-joined computers",
+          kSystemKey, L"DontEnumerateConnectedUsers", Boolean, 1, 0 },
+        { "DisableLockScreenAppNotifications", "Turn off app notifications on the lock screen",
+          kSystemKey, L"DisableLockScreenAppNotifications", Boolean, 1, 0 },
+        { "BlockDomainPicturePassword", "Turn off picture password sign-in",
+          kSystemKey, L"BlockDomainPicturePassword", Boolean, 1, 0 },
+        { "AllowDomainPINLogon", "Turn on convenience PIN sign-in",
+          kSystemKey, L"AllowDomainPINLogon", Boolean, 1, 0 },
+        // Power.admx
+        { "DCPromptForPasswordOnResume", "Require a password when a computer wakes (on battery)",
+          kSleepSettingsKey, L"DCSettingIndex", Boolean, 1, 0 },
+        { "ACPromptForPasswordOnResume", "Require a password when a computer wakes (plugged in)",
+          kSleepSettingsKey, L"ACSettingIndex", Boolean, 1, 0 },
+        // RemoteAssistance.admx
+        { "RA_Unsolicit", "Configure Offer Remote Assistance",
+          kTerminalServicesKey, L"fAllowUnsolicited", Boolean, 1, 0 },
+        { "RA_Solicit", "Configure Solicited Remote Assistance",
+          kTerminalServicesKey, L"fAllowToGetHelp", Boolean, 1, 0 },
+        // RPC.admx
+        { "RpcEnableAuthEpResolution", "Enable RPC Endpoint Mapper Client Authentication",
+          kRpcKey, L"EnableAuthEpResolution", Boolean, 1, 0 },
+        { "RpcRestrictRemoteClients", "Restrict Unauthenticated RPC clients",
+          kRpcKey, L"RestrictRemoteClients", Enum, 0, 0 },
+        // AutoPlay.admx
+        { "NoAutoplayfornonVolume", "Disallow Autoplay for non-volume devices",
+          kExplorerKey, L"NoAutoplayfornonVolume", Boolean, 1, 0 },
+        // CloudContent.admx
+        { "DisableConsumerAccountStateContent", "Turn off cloud consumer account state content",
+          kCloudContentKey, L"DisableConsumerAccountStateContent", Boolean, 1, 0 },
+        { "DisableWindowsConsumerFeatures", "Turn off Microsoft consumer experiences",
+          kCloudContentKey, L"DisableWindowsConsumerFeatures", Boolean, 1, 0 },
+        // WirelessDisplay.admx
+        { "RequirePinForPairing", "Require pin for pairing",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\Connect", L"RequirePinForPairing", Enum, 0, 0 },
+        // CredUI.admx
+        { "DisablePasswordReveal", "Do not display the password reveal button",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\CredUI", L"DisablePasswordReveal", Boolean, 1, 0 },
+        // DataCollection.admx, FeedbackNotifications.admx
+        { "AllowTelemetry", "Allow Diagnostic Data",
+          kDataCollectionKey, L"AllowTelemetry", Enum, 0, 0 },
+        { "DisableOneSettingsDownloads", "Disable OneSettings Downloads",
+          kDataCollectionKey, L"DisableOneSettingsDownloads", Boolean, 1, 0 },
+        { "DoNotShowFeedbackNotifications", "Do not show feedback notifications",
+          kDataCollectionKey, L"DoNotShowFeedbackNotifications", Boolean, 1, 0 },
+        { "EnableOneSettingsAuditing", "Enable OneSettings Auditing",
+          kDataCollectionKey, L"EnableOneSettingsAuditing", Boolean, 1, 0 },
+        { "LimitDiagnosticLogCollection", "Limit Diagnostic Log Collection",
+          kDataCollectionKey, L"LimitDiagnosticLogCollection", Boolean, 1, 0 },
+        { "LimitDumpCollection", "Limit Dump Collection",
+          kDataCollectionKey, L"LimitDumpCollection", Boolean, 1, 0 },
+        // DeliveryOptimization.admx
+        { "DownloadMode", "Download Mode",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\DeliveryOptimization", L"DODownloadMode", Enum, 0, 0 },
+        // EventLog.admx
+        { "Channel_LogMaxSize_Application", "Application: Specify the maximum log file size (KB)",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\EventLog\\Application", L"MaxSize", Decimal, 0, 0 },
+        { "Channel_LogMaxSize_Security", "Security: Specify the maximum log file size (KB)",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\EventLog\\Security", L"MaxSize", Decimal, 0, 0 },
+        { "Channel_LogMaxSize_Setup", "Setup: Specify the maximum log file size (KB)",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\EventLog\\Setup", L"MaxSize", Decimal, 0, 0 },
+        { "Channel_LogMaxSize_System", "System: Specify the maximum log file size (KB)",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\EventLog\\System", L"MaxSize", Decimal, 0, 0 },
+        // Explorer.admx
+        { "NoDataExecutionPrevention", "Turn off Data Execution Prevention for Explorer",
+          kExplorerKey, L"NoDataExecutionPrevention", Boolean, 1, 0 },
+        { "NoHeapTerminationOnCorruption", "Turn off heap termination on corruption",
+          kExplorerKey, L"NoHeapTerminationOnCorruption", Boolean, 1, 0 },
+        // WindowsDefender.admx
+        { "Spynet_LocalSettingOverrideSpynetReporting", "Configure local setting override for reporting to Microsoft MAPS",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows Defender\\Spynet", L"LocalSettingOverrideSpynetReporting", Boolean, 1, 0 },
+        { "RealtimeProtection_DisableBehaviorMonitoring", "Turn on behavior monitoring",
+          kDefenderRealTimeKey, L"DisableBehaviorMonitoring", Boolean, 0, 1 },
+        { "RealtimeProtection_DisableScriptScanning", "Turn on script scanning",
+          kDefenderRealTimeKey, L"DisableScriptScanning", Boolean, 0, 1 },
+        { "Scan_DisableRemovableDriveScanning", "Scan removable drives",
+          kDefenderScanKey, L"DisableRemovableDriveScanning", Boolean, 0, 1 },
+        { "Scan_DisableEmailScanning", "Turn on e-mail scanning",
+          kDefenderScanKey, L"DisableEmailScanning", Boolean, 0, 1 },
+        { "Root_PUAProtection", "Configure detection for potentially unwanted applications",
+          kDefenderKey, L"PUAProtection", Enum, 0, 0 },
+        // TerminalServer.admx
+        { "TS_CLIENT_DISABLE_PASSWORD_SAVING_2", "Do not allow passwords to be saved",
+          kTerminalServicesKey, L"DisablePasswordSaving", Boolean, 1, 0 },
+        { "TS_CLIENT_DRIVE_M", "Do not allow drive redirection",
+          kTerminalServicesKey, L"fDisableCdm", Boolean, 1, 0 },
+        { "TS_PASSWORD", "Always prompt for password upon connection",
+          kTerminalServicesKey, L"fPromptForPassword", Boolean, 1, 0 },
+        { "TS_RPC_ENCRYPTION", "Require secure RPC communication",
+          kTerminalServicesKey, L"fEncryptRPCTraffic", Boolean, 1, 0 },
+        { "TS_SECURITY_LAYER_POLICY", "Require use of specific security layer for remote (RDP) connections",
+          kTerminalServicesKey, L"SecurityLayer", Enum, 0, 0 },
+        { "TS_USER_AUTHENTICATION_POLICY", "Require user authentication for remote connections by using Network Level Authentication",
+          kTerminalServicesKey, L"UserAuthentication", Boolean, 1, 0 },
+        { "TS_ENCRYPTION_POLICY", "Set client connection encryption level",
+          kTerminalServicesKey, L"MinEncryptionLevel", Enum, 0, 0 },
+        // InetRes.admx
+        { "Disable_Downloading_of_Enclosures", "Prevent downloading of enclosures",
+          L"SOFTWARE\\Policies\\Microsoft\\Internet Explorer\\Feeds", L"DisableEnclosureDownload", Boolean, 1, 0 },
+        // Search.admx
+        { "AllowCloudSearch", "Allow Cloud Search",
+          kWindowsSearchKey, L"AllowCloudSearch", Enum, 0, 0 },
+        { "AllowCortana", "Allow Cortana",
+          kWindowsSearchKey, L"AllowCortana", Boolean, 1, 0 },
+        { "AllowIndexingEncryptedStoresOrItems", "Allow indexing of encrypted files",
+          kWindowsSearchKey, L"AllowIndexingEncryptedStoresOrItems", Boolean, 1, 0 },
+        { "AllowSearchToUseLocation", "Allow search and Cortana to use location",
+          kWindowsSearchKey, L"AllowSearchToUseLocation", Boolean, 1, 0 },
+        // MSI.admx
+        { "EnableUserControl", "Allow user control over installs",
+          kInstallerKey, L"EnableUserControl", Boolean, 1, 0 },
+        { "AlwaysInstallElevated", "Always install with elevated privileges",
+          kInstallerKey, L"AlwaysInstallElevated", Boolean, 1, 0 },
+        // PowerShellExecutionPolicy.admx
+        { "EnableScriptBlockLogging", "Turn on PowerShell Script Block Logging",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\PowerShell\\ScriptBlockLogging", L"EnableScriptBlockLogging", Boolean, 1, 0 },
+        { "EnableTranscripting", "Turn on PowerShell Transcription",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\PowerShell\\Transcription", L"EnableTranscripting", Boolean, 1, 0 },
+        // WindowsRemoteManagement.admx, WindowsRemoteShell.admx
+        { "AllowBasic_2", "WinRM Client: Allow Basic authentication",
+          kWinRmClientKey, L"AllowBasic", Boolean, 1, 0 },
+        { "AllowUnencrypted_2", "WinRM Client: Allow unencrypted traffic",
+          kWinRmClientKey, L"AllowUnencryptedTraffic", Boolean, 1, 0 },
+        { "DisallowDigest", "WinRM Client: Disallow Digest authentication",
+          kWinRmClientKey, L"AllowDigest", Boolean, 0, 1 },
+        { "AllowBasic_1", "WinRM Service: Allow Basic authentication",
+          kWinRmServiceKey, L"AllowBasic", Boolean, 1, 0 },
+        { "AllowAutoConfig", "WinRM Service: Allow remote server management through WinRM",
+          kWinRmServiceKey, L"AllowAutoConfig", Boolean, 1, 0 },
+        { "AllowUnencrypted_1", "WinRM Service: Allow unencrypted traffic",
+          kWinRmServiceKey, L"AllowUnencryptedTraffic", Boolean, 1, 0 },
+        { "DisableRunAs", "WinRM Service: Disallow WinRM from storing RunAs credentials",
+          kWinRmServiceKey, L"DisableRunAs", Boolean, 1, 0 },
+        { "AllowRemoteShellAccess", "Allow Remote Shell Access",
+          L"SOFTWARE\\Policies\\Microsoft\\Windows\\WinRM\\Service\\WinRS", L"AllowRemoteShellAccess", Boolean, 1, 0 },
+        // WindowsUpdate.admx
+        { "AutoUpdateCfg", "Configure Automatic Updates",
+          kAutoUpdateKey, L"NoAutoUpdate", Boolean, 0, 1 },
+        { "AutoUpdateCfg_ScheduledInstallDay", "Configure Automatic Updates: Scheduled install day",
+          kAutoUpdateKey, L"ScheduledInstallDay", Enum, 0, 0 },
+        { "DisablePauseUXAccess", "Remove access to \"Pause updates\" feature",
+          kWindowsUpdateKey, L"SetDisablePauseUXAccess", Boolean, 1, 0 },
+    };
+
+    // Section 18 items in benchmark order. An item over a policy already in
+    // kAdmxPolicies is one row here.
+    constexpr AdmxSetting kSettings[] = {
+        { "18.1.1.1", "Ensure 'Prevent enabling lock screen camera' is set to 'Enabled'",
+          "CPL_Personalization_NoLockScreenCamera", "enabled" },
+        { "18.1.1.2", "Ensure 'Prevent enabling lock screen slide show' is set to 'Enabled'",
+          "CPL_Personalization_NoLockScreenSlideshow", "enabled" },
+        { "18.1.2.2", "Ensure 'Allow users to enable online speech recognition services' is set to 'Disabled'",
+          "AllowInputPersonalization", "disabled" },
+        { "18.6.4.4", "Ensure 'Turn off multicast name resolution' is set to 'Enabled'",
+          "Turn_Off_Multicast", "enabled" },
+        { "18.6.8.1", "Ensure 'Enable insecure guest logons' is set to 'Disabled'",
+          "Pol_EnableInsecureGuestLogons", "disabled" },
+        { "18.6.11.2", "Ensure 'Prohibit installation and configuration of Network Bridge on your DNS domain network' is set to 'Enabled'",
+          "NC_AllowNetBridge_NLA", "enabled" },
+        { "18.6.11.3", "Ensure 'Prohibit use of Internet Connection Sharing on your DNS domain network' is set to 'Enabled'",
+          "NC_ShowSharedAccessUI", "enabled" },
+        { "18.6.11.4", "Ensure 'Require domain users to elevate when setting a network's location' is set to 'Enabled'",
+          "NC_StdDomainUserSetLocation", "enabled" },
+        { "18.6.21.1", "Ensure 'Minimize the number of simultaneous connections to the Internet or a Windows Domain' is set to 'Enabled: 3 = Prevent Wi-Fi when on Ethernet'",
+          "WCM_MinimizeConnections", "value == 3" },
+        { "18.6.21.2", "Ensure 'Prohibit connection to non-domain networks when connected to domain authenticated network' is set to 'Enabled'",
+          "WCM_BlockNonDomain", "enabled" },
+        { "18.7.2", "Ensure 'Configure Redirection Guard' is set to 'Enabled: Redirection Guard Enabled'",
+          "RedirectionGuardPolicy", "value == 1" },
+        { "18.7.10", "Ensure 'Limits print driver installation to Administrators' is set to 'Enabled'",
+          "RestrictDriverInstallationToAdministrators", "enabled" },
+        { "18.9.5.1", "Ensure 'Turn On Virtualization Based Security' is set to 'Enabled'",
+          "VirtualizationBasedSecurity", "enabled" },
+        { "18.9.5.2", "Ensure 'Turn On Virtualization Based Security: Select Platform Security Level' is set to 'Secure Boot' or higher",
+          "RequirePlatformSecurityFeatures", "value in {1, 3}" },
+        { "18.9.5.3", "Ensure 'Turn On Virtualization Based Security: Virtualization Based Protection of Code Integrity' is set to 'Enabled with UEFI lock'",
+          "HypervisorEnforcedCodeIntegrity", "value == 1" },
+        { "18.9.5.5", "Ensure 'Turn On Virtualization Based Security: Credential Guard Configuration' is set to 'Enabled with UEFI lock'",
+          "LsaCfgFlags", "value == 1" },
+        { "18.9.5.7", "Ensure 'Turn On Virtualization Based Security: Secure Launch Configuration' is set to 'Enabled'",
+          "ConfigureSystemGuardLaunch", "value == 1" },
+        { "18.9.7.2", "Ensure 'Prevent device metadata retrieval from the Internet' is set to 'Enabled'",
+          "DeviceMetadata_PreventDeviceMetadataFromNetwork", "enabled" },
+        { "18.9.20.1.1", "Ensure 'Turn off downloading of print drivers over HTTP' is set to 'Enabled'",
+          "DisableWebPnPDownload_2", "enabled" },
+        { "18.9.20.1.6", "Ensure 'Turn off printing over HTTP' is set to 'Enabled'",
+          "DisableHTTPPrinting_2", "enabled" },
+        { "18.9.20.1.13", "Ensure 'Turn off Windows Customer Experience Improvement Program' is set to 'Enabled'",
+          "CEIPEnable", "enabled" },
+        { "18.9.20.1.14", "Ensure 'Turn off Windows Error Reporting' is set to 'Enabled'",
+          "PCH_DoNotReport", "enabled" },
+        { "18.9.27.1", "Ensure 'Block user from showing account details on sign-in' is set to 'Enabled'",
+          "BlockUserFromShowingAccountDetailsOnSignin", "enabled" },
+        { "18.9.27.2", "Ensure 'Do not display network selection UI' is set to 'Enabled'",
+          "NoNetworkSelectionUI", "enabled" },
+        { "18.9.27.3", "Ensure 'Do not enumerate connected users on domain-joined computers' is set to 'Enabled'",
+          "NoEnumerateConnectedUsers", "enabled" },
+        { "18.9.27.5", "Ensure 'Turn off app notifications on the lock screen' is set to 'Enabled'",
+          "DisableLockScreenAppNotifications", "enabled" },
+        { "18.9.27.6", "Ensure 'Turn off picture password sign-in' is set to 'Enabled'",
+          "BlockDomainPicturePassword", "enabled" },
+        { "18.9.27.7", "Ensure 'Turn on convenience PIN sign-in' is set to 'Disabled'",
+          "AllowDomainPINLogon", "disabled" },
+        { "18.9.33.6.5", "Ensure 'Require a password when a computer wakes (on battery)' is set to 'Enabled'",
+          "DCPromptForPasswordOnResume", "enabled" },
+        { "18.9.33.6.6", "Ensure 'Require a password when a computer wakes (plugged in)' is set to 'Enabled'",
+          "ACPromptForPasswordOnResume", "enabled" },
+        { "18.9.35.1", "Ensure 'Configure Offer Remote Assistance' is set to 'Disabled'",
+          "RA_Unsolicit", "disabled" },
+        { "18.9.35.2", "Ensure 'Configure Solicited Remote Assistance' is set to 'Disabled'",
+          "RA_Solicit", "disabled" },
+        { "18.9.36.1", "Ensure 'Enable RPC Endpoint Mapper Client Authentication' is set to 'Enabled'",
+          "RpcEnableAuthEpResolution", "enabled" },
+        { "18.9.36.2", "Ensure 'Restrict Unauthenticated RPC clients' is set to 'Enabled: Authenticated'",
+          "RpcRestrictRemoteClients", "value == 1" },
+        { "18.10.7.1", "Ensure 'Disallow Autoplay for non-volume devices' is set to 'Enabled'",
+          "NoAutoplayfornonVolume", "enabled" },
+        { "18.10.13.1", "Ensure 'Turn off cloud consumer account state content' is set to 'Enabled'",
+          "DisableConsumerAccountStateContent", "enabled" },
+        { "18.10.13.3", "Ensure 'Turn off Microsoft consumer experiences' is set to 'Enabled'",
+          "DisableWindowsConsumerFeatures", "enabled" },
+        { "18.10.14.1", "Ensure 'Require pin for pairing' is set to 'Enabled: First Time' OR 'Enabled: Always'",
+          "RequirePinForPairing", "value in {1, 2}" },
+        { "18.10.15.1", "Ensure 'Do not display the password reveal button' is set to 'Enabled'",
+          "DisablePasswordReveal", "enabled" },
+        { "18.10.16.1", "Ensure 'Allow Diagnostic Data' is set to 'Enabled: Diagnostic data off (not recommended)' or 'Enabled: Send required diagnostic data'",
+          "AllowTelemetry", "value <= 1" },
+        { "18.10.16.3", "Ensure 'Disable OneSettings Downloads' is set to 'Enabled'",
+          "DisableOneSettingsDownloads", "enabled" },
+        { "18.10.16.4", "Ensure 'Do not show feedback notifications' is set to 'Enabled'",
+          "DoNotShowFeedbackNotifications", "enabled" },
+        { "18.10.16.5", "Ensure 'Enable OneSettings Auditing' is set to 'Enabled'",
+          "EnableOneSettingsAuditing", "enabled" },
+        { "18.10.16.6", "Ensure 'Limit Diagnostic Log Collection' is set to 'Enabled'",
+          "LimitDiagnosticLogCollection", "enabled" },
+        { "18.10.16.7", "Ensure 'Limit Dump Collection' is set to 'Enabled'",
+          "LimitDumpCollection", "enabled" },
+        { "18.10.17.1", "Ensure 'Download Mode' is NOT set to 'Enabled: Internet'",
+          "DownloadMode", "value != 3" },
+        { "18.10.25.1.2", "Ensure 'Application: Specify the maximum log file size (KB)' is set to 'Enabled: 32,768 or greater'",
+          "Channel_LogMaxSize_Application", "value >= 32768" },
+        { "18.10.25.2.2", "Ensure 'Security: Specify the maximum log file size (KB)' is set to 'Enabled: 196,608 or greater'",
+          "Channel_LogMaxSize_Security", "value >= 196608" },
+        { "18.10.25.3.2", "Ensure 'Setup: Specify the maximum log file size (KB)' is set to 'Enabled: 32,768 or greater'",
+          "Channel_LogMaxSize_Setup", "value >= 32768" },
+        { "18.10.25.4.2", "Ensure 'System: Specify the maximum log file size (KB)' is set to 'Enabled: 32,768 or greater'",
+          "Channel_LogMaxSize_System", "value >= 32768" },
+        { "18.10.28.3", "Ensure 'Turn off Data Execution Prevention for Explorer' is set to 'Disabled'",
+          "NoDataExecutionPrevention", "disabled" },
+        { "18.10.28.4", "Ensure 'Turn off heap termination on corruption' is set to 'Disabled'",
+          "NoHeapTerminationOnCorruption", "disabled" },
+        { "18.10.43.5.1", "Ensure 'Configure local setting override for reporting to Microsoft MAPS' is set to 'Disabled'",
+          "Spynet_LocalSettingOverrideSpynetReporting", "disabled" },
+        { "18.10.43.10.2", "Ensure 'Turn on behavior monitoring' is set to 'Enabled'",
+          "RealtimeProtection_DisableBehaviorMonitoring", "enabled" },
+        { "18.10.43.10.4", "Ensure 'Turn on script scanning' is set to 'Enabled'",
+          "RealtimeProtection_DisableScriptScanning", "enabled" },
+        { "18.10.43.13.1", "Ensure 'Scan removable drives' is set to 'Enabled'",
+          "Scan_DisableRemovableDriveScanning", "enabled" },
+        { "18.10.43.13.3", "Ensure 'Turn on e-mail scanning' is set to 'Enabled'",
+          "Scan_DisableEmailScanning", "enabled" },
+        { "18.10.43.16", "Ensure 'Configure detection for potentially unwanted applications' is set to 'Enabled: Block'",
+          "Root_PUAProtection", "value == 1" },
+        { "18.10.57.2.3", "Ensure 'Do not allow passwords to be saved' is set to 'Enabled'",
+          "TS_CLIENT_DISABLE_PASSWORD_SAVING_2", "enabled" },
+        { "18.10.57.3.3.3", "Ensure 'Do not allow drive redirection' is set to 'Enabled'",
+          "TS_CLIENT_DRIVE_M", "enabled" },
+        { "18.10.57.3.9.1", "Ensure 'Always prompt for password upon connection' is set to 'Enabled'",
+          "TS_PASSWORD", "enabled" },
+        { "18.10.57.3.9.2", "Ensure 'Require secure RPC communication' is set to 'Enabled'",
+          "TS_RPC_ENCRYPTION", "enabled" },
+        { "18.10.57.3.9.3", "Ensure 'Require use of specific security layer for remote (RDP) connections' is set to 'Enabled: SSL'",
+          "TS_SECURITY_LAYER_POLICY", "value == 2" },
+        { "18.10.57.3.9.4", "Ensure 'Require user authentication for remote connections by using Network Level Authentication' is set to 'Enabled'",
+          "TS_USER_AUTHENTICATION_POLICY", "enabled" },
+        { "18.10.57.3.9.5", "Ensure 'Set client connection encryption level' is set to 'Enabled: High Level'",
+          "TS_ENCRYPTION_POLICY", "value == 3" },
+        { "18.10.58.1", "Ensure 'Prevent downloading of enclosures' is set to 'Enabled'",
+          "Disable_Downloading_of_Enclosures", "enabled" },
+        { "18.10.59.2", "Ensure 'Allow Cloud Search' is set to 'Enabled: Disable Cloud Search'",
+          "AllowCloudSearch", "value == 0" },
+        { "18.10.59.3", "Ensure 'Allow Cortana' is set to 'Disabled'",
+          "AllowCortana", "disabled" },
+        { "18.10.59.5", "Ensure 'Allow indexing of encrypted files' is set to 'Disabled'",
+          "AllowIndexingEncryptedStoresOrItems", "disabled" },
+        { "18.10.59.6", "Ensure 'Allow search and Cortana to use location' is set to 'Disabled'",
+          "AllowSearchToUseLocation", "disabled" },
+        { "18.10.81.1", "Ensure 'Allow user control over installs' is set to 'Disabled'",
+          "EnableUserControl", "disabled" },
+        { "18.10.81.2", "Ensure 'Always install with elevated privileges' is set to 'Disabled'",
+          "AlwaysInstallElevated", "disabled" },
+        { "18.10.87.1", "Ensure 'Turn on PowerShell Script Block Logging' is set to 'Enabled'",
+          "EnableScriptBlockLogging", "enabled" },
+        { "18.10.87.2", "Ensure 'Turn on PowerShell Transcription' is set to 'Enabled'",
+          "EnableTranscripting", "enabled" },
+        { "18.10.89.1.1", "Ensure 'Allow Basic authentication' is set to 'Disabled' (WinRM Client)",
+          "AllowBasic_2", "disabled" },
+        { "18.10.89.1.2", "Ensure 'Allow unencrypted traffic' is set to 'Disabled' (WinRM Client)",
+          "AllowUnencrypted_2", "disabled" },
+        { "18.10.89.1.3", "Ensure 'Disallow Digest authentication' is set to 'Enabled'",
+          "DisallowDigest", "enabled" },
+        { "18.10.89.2.1", "Ensure 'Allow Basic authentication' is set to 'Disabled' (WinRM Service)",
+          "AllowBasic_1", "disabled" },
+        { "18.10.89.2.2", "Ensure 'Allow remote server management through WinRM' is set to 'Disabled'",
+          "AllowAutoConfig", "disabled" },
+        { "18.10.89.2.3", "Ensure 'Allow unencrypted traffic' is set to 'Disabled' (WinRM Service)",
+          "AllowUnencrypted_1", "disabled" },
+        { "18.10.89.2.4", "Ensure 'Disallow WinRM from storing RunAs credentials' is set to 'Enabled'",
+          "DisableRunAs", "enabled" },
+        { "18.10.90.1", "Ensure 'Allow Remote Shell Access' is set to 'Disabled'",
+          "AllowRemoteShellAccess", "disabled" },
+        { "18.10.93.2.1", "Ensure 'Configure Automatic Updates' is set to 'Enabled'",
+          "AutoUpdateCfg", "enabled" },
+        { "18.10.93.2.2", "Ensure 'Configure Automatic Updates: Scheduled install day' is set to '0 - Every day'",
+          "AutoUpdateCfg_ScheduledInstallDay", "value == 0" },
+        { "18.10.93.2.3", "Ensure 'Remove access to \"Pause updates\" feature' is set to 'Enabled'",
+          "DisablePauseUXAccess", "enabled" },
+    };
+
+    constexpr size_t kSettingCount = sizeof(kSettings) / sizeof(kSettings[0]);
+
+    const RegistryRuleTable& section18Rules() {
+        static const AdmxIndex index(kAdmxPolicies, sizeof(kAdmxPolicies) / sizeof(kAdmxPolicies[0]));
+        static const AdmxRuleSet rules(index, kSettings, kSettingCount);
+        return rules.getTable();
+    }
+
+    // A RegistryRuleCheck per setting, in static storage and built once per process
+    struct SectionChecks {
+        RegistryRuleChecks<kSettingCount> ruleChecks{ section18Rules() };
+        std::array<BenchmarkCheck*, kSettingCount> pointers{};
+
+        SectionChecks() {
+            for (size_t row = 0; row < kSettingCount; row++) {
+                pointers[row] = ruleChecks[row];
+            }
+        }
+    };
+}
+
+void AdministrativeTemplatesSection::initialize()
+{
+    static SectionChecks sectionChecks;
+    checks = CheckList(sectionChecks.pointers.data(), sectionChecks.pointers.size());
+}
+
+std::vector<BenchmarkResult> AdministrativeTemplatesSection::runChecks()
+{
+    // Rows are in benchmark order, so the table's results are the section's
+    return section18Rules().evaluate(RunContext::current().getRegistry());
+}
@@ -0,0 +1,252 @@
+#include "include/sections/section19/user_administrative_templates_section.h"
+#include "include/admx_index.h"
+#include "include/run_context.h"
+#include "include/string_utils.h"
+#include "include/work_stealing_pool.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+namespace {
+    // Hive-relative: each key is read from every user's hive in turn
+    const wchar_t kControlPanelDesktopKey[] = L"Software\\Policies\\Microsoft\\Windows\\Control Panel\\Desktop";
+    const wchar_t kPushNotificationsKey[] = L"Software\\Policies\\Microsoft\\Windows\\CurrentVersion\\PushNotifications";
+    const wchar_t kAssistanceClientKey[] = L"Software\\Policies\\Microsoft\\Assistance\\Client\\1.0";
+    const wchar_t kAttachmentsKey[] = L"Software\\Microsoft\\Windows\\CurrentVersion\\Policies\\Attachments";
+    const wchar_t kCloudContentKey[] = L"Software\\Policies\\Microsoft\\Windows\\CloudContent";
+    const wchar_t kExplorerKey[] = L"Software\\Microsoft\\Windows\\CurrentVersion\\Policies\\Explorer";
+    const wchar_t kInstallerKey[] = L"Software\\Policies\\Microsoft\\Windows\\Installer";
+    const wchar_t kMediaPlayerKey[] = L"Software\\Policies\\Microsoft\\WindowsMediaPlayer";
+
+    constexpr AdmxElement Boolean = AdmxElement::Boolean;
+    constexpr AdmxElement Decimal = AdmxElement::Decimal;
+
+    /**
+     * User policy definitions the section reads, compiled from the ADMX
+     * files named in the comments. The screen saver policies store their
+     * values as text.
+     */
+    constexpr AdmxPolicy kAdmxPolicies[] = {
+        // ControlPanelDisplay.admx
+        { "CPL_Personalization_EnableScreenSaver", "Enable screen saver",
+          kControlPanelDesktopKey, L"ScreenSaveActive", Boolean, 1, 0, REG_SZ },
+        { "CPL_Personalization_ScreenSaverIsSecure", "Password protect the screen saver",
+          kControlPanelDesktopKey, L"ScreenSaverIsSecure", Boolean, 1, 0, REG_SZ },
+        { "CPL_Personalization_ScreenSaverTimeOut", "Screen saver timeout",
+          kControlPanelDesktopKey, L"ScreenSaveTimeOut", Decimal, 0, 0, REG_SZ },
+        // WPN.admx
+        { "NoToastNotificationOnLockScreen", "Turn off toast notifications on the lock screen",
+          kPushNotificationsKey, L"NoToastApplicationNotificationOnLockScreen", Boolean, 1, 0 },
+        // HelpAndSupport.admx
+        { "HPImplicitFeedback", "Turn off Help Experience Improvement Program",
+          kAssistanceClientKey, L"NoImplicitFeedback", Boolean, 1, 0 },
+        // AttachmentManager.admx
+        { "AM_MarkZoneOnSavedAtttachments", "Do not preserve zone information in file attachments",
+          kAttachmentsKey, L"SaveZoneInformation", Boolean, 1, 2 },
+        { "AM_CallIOfficeAntiVirus", "Notify antivirus programs when opening attachments",
+          kAttachmentsKey, L"ScanWithAntiVirus", Boolean, 3, 1 },
+        // CloudContent.admx
+        { "ConfigureWindowsSpotlight", "Configure Windows spotlight on lock screen",
+          kCloudContentKey, L"ConfigureWindowsSpotlight", Boolean, 1, 2 },
+        { "DisableThirdPartySuggestions", "Do not suggest third-party content in Windows spotlight",
+          kCloudContentKey, L"DisableThirdPartySuggestions", Boolean, 1, 0 },
+        { "DisableTailoredExperiencesWithDiagnosticData", "Do not use diagnostic data for tailored experiences",
+          kCloudContentKey, L"DisableTailoredExperiencesWithDiagnosticData", Boolean, 1, 0 },
+        { "DisableWindowsSpotlightFeatures", "Turn off all Windows spotlight features",
+          kCloudContentKey, L"DisableWindowsSpotlightFeatures", Boolean, 1, 0 },
+        { "DisableSpotlightCollectionOnDesktop", "Turn off Spotlight collection on Desktop",
+          kCloudContentKey, L"DisableSpotlightCollectionOnDesktop", Boolean, 1, 0 },
+        // Sharing.admx
+        { "NoInplaceSharing", "Prevent users from sharing files within their profile.",
+          kExplorerKey, L"NoInplaceSharing", Boolean, 1, 0 },
+        // MSI.admx
+        { "AlwaysInstallElevated", "Always install with elevated privileges",
+          kInstallerKey, L"AlwaysInstallElevated", Boolean, 1, 0 },
+        // WindowsMediaPlayer.admx
+        { "PreventCodecDownload", "Prevent Codec Download",
+          kMediaPlayerKey, L"PreventCodecDownload", Boolean, 1, 0 },
+    };
+
+    constexpr AdmxSetting kSettings[] = {
+        { "19.1.3.1", "Ensure 'Enable screen saver' is set to 'Enabled'",
+          "CPL_Personalization_EnableScreenSaver", "enabled" },
+        { "19.1.3.2", "Ensure 'Password protect the screen saver' is set to 'Enabled'",
+          "CPL_Personalization_ScreenSaverIsSecure", "enabled" },
+        { "19.1.3.3", "Ensure 'Screen saver timeout' is set to 'Enabled: 900 seconds or fewer, but not 0'",
+          "CPL_Personalization_ScreenSaverTimeOut", "value in [1, 900]" },
+        { "19.5.1.1", "Ensure 'Turn off toast notifications on the lock screen' is set to 'Enabled'",
+          "NoToastNotificationOnLockScreen", "enabled" },
+        { "19.6.6.1.1", "Ensure 'Turn off Help Experience Improvement Program' is set to 'Enabled'",
+          "HPImplicitFeedback", "enabled" },
+        { "19.7.5.1", "Ensure 'Do not preserve zone information in file attachments' is set to 'Disabled'",
+          "AM_MarkZoneOnSavedAtttachments", "disabled" },
+        { "19.7.5.2", "Ensure 'Notify antivirus programs when opening attachments' is set to 'Enabled'",
+          "AM_CallIOfficeAntiVirus", "enabled" },
+        { "19.7.8.1", "Ensure 'Configure Windows spotlight on lock screen' is set to 'Disabled'",
+          "ConfigureWindowsSpotlight", "disabled" },
+        { "19.7.8.2", "Ensure 'Do not suggest third-party content in Windows spotlight' is set to 'Enabled'",
+          "DisableThirdPartySuggestions", "enabled" },
+        { "19.7.8.3", "Ensure 'Do not use diagnostic data for tailored experiences' is set to 'Enabled'",
+          "DisableTailoredExperiencesWithDiagnosticData", "enabled" },
+        { "19.7.8.4", "Ensure 'Turn off all Windows spotlight features' is set to 'Enabled'",
+          "DisableWindowsSpotlightFeatures", "enabled" },
+        { "19.7.8.5", "Ensure 'Turn off Spotlight collection on Desktop' is set to 'Enabled'",
+          "DisableSpotlightCollectionOnDesktop", "enabled" },
+        { "19.7.26.1", "Ensure 'Prevent users from sharing files within their profile.' is set to 'Enabled'",
+          "NoInplaceSharing", "enabled" },
+        { "19.7.42.1", "Ensure 'Always install with elevated privileges' is set to 'Disabled'",
+          "AlwaysInstallElevated", "disabled" },
+        { "19.7.44.2.1", "Ensure 'Prevent Codec Download' is set to 'Enabled'",
+          "PreventCodecDownload", "enabled" },
+    };
+
+    constexpr size_t kSettingCount = sizeof(kSettings) / sizeof(kSettings[0]);
+
+    const RegistryRuleTable& section19Rules() {
+        static const AdmxIndex index(kAdmxPolicies, sizeof(kAdmxPolicies) / sizeof(kAdmxPolicies[0]));
+        static const AdmxRuleSet rules(index, kSettings, kSettingCount);
+        return rules.getTable();
+    }
+
+    // Every row of a user whose hive could not be opened
+    std::vector<BenchmarkResult> unreadableHive(const RegistryRuleTable& table) {
+        std::vector<BenchmarkResult> rows;
+        rows.reserve(table.size());
+        for (size_t row = 0; row < table.size(); row++) {
+            rows.emplace_back(table[row].id, table[row].title, CheckStatus::Error,
+                              "Failed to open the user's hive");
+        }
+        return rows;
+    }
+
+    // Every row of a user the check's time budget ran out before
+    std::vector<BenchmarkResult> notEvaluated(const RegistryRuleTable& table) {
+        std::vector<BenchmarkResult> rows;
+        rows.reserve(table.size());
+        for (size_t row = 0; row < table.size(); row++) {
+            rows.emplace_back(table[row].id, table[row].title, CheckStatus::Error,
+                              "Not evaluated: the check's time budget ran out");
+        }
+        return rows;
+    }
+
+    UserPolicySnapshot buildUserPolicies(SystemProbe& probe) {
+        UserPolicySnapshot snapshot;
+        std::vector<UserProfile> profiles;
+        snapshot.status = probe.queryUserProfiles(profiles);
+        if (FAILED(snapshot.status) || profiles.empty()) {
+            return snapshot;
+        }
+
+        // The workers run on behalf of the check that asked for the snapshot:
+        // each gets a context with its deadline and run, and their probe
+        // calls are added to the check's once the pool has joined
+        CheckContext* caller = CheckContext::current();
+        CheckContext::Clock::time_point deadline = caller ? caller->getDeadline()
+                                                          : CheckContext::Clock::time_point::max();
+        RunContext& run = RunContext::current();
+        std::vector<ProbeCallCounts> calls(profiles.size());
+        std::atomic<bool> aborted{false};
+
+        const RegistryRuleTable& table = section19Rules();
+        snapshot.users.resize(profiles.size());
+        unsigned int workers = std::min(run.getJobs(), static_cast<unsigned int>(profiles.size()));
+        WorkStealingPool(workers).run(profiles.size(), [&](size_t i) {
+            // Each task writes only its own user, and the hive it opens is
+            // released before the worker takes the next one
+            UserPolicySnapshot::User& user = snapshot.users[i];
+            user.sid = narrow(profiles[i].sid);
+            if (caller && caller->isCancelled()) {
+                user.rows = notEvaluated(table);
+                aborted = true;
+                return;
+            }
+
+            CheckContext context(deadline, &run);
+            CheckContext::Scope scope(context);
+            std::shared_ptr<const RegistrySource> hive;
+            user.rows = SUCCEEDED(probe.openUserHive(profiles[i], hive)) ? table.evaluate(*hive) : unreadableHive(table);
+            calls[i] = context.getProbeCalls();
+            if (context.wasAborted()) {
+                aborted = true;
+            }
+        });
+
+        if (caller) {
+            for (const ProbeCallCounts& counts : calls) {
+                caller->addProbeCalls(counts);
+            }
+            if (aborted) {
+                caller->markAborted();
+            }
+        }
+        return snapshot;
+    }
+
+    // A UserPolicyCheck per setting, in static storage and built once per process
+    struct SectionChecks {
+        RegistryRuleChecks<kSettingCount, UserPolicyCheck> ruleChecks{ section19Rules() };
+        std::array<BenchmarkCheck*, kSettingCount> pointers{};
+
+        SectionChecks() {
+            for (size_t row = 0; row < kSettingCount; row++) {
+                pointers[row] = ruleChecks[row];
+            }
+        }
+    };
+}
+
+std::shared_ptr<const UserPolicySnapshot> UserAdministrativeTemplatesSection::getUserPolicies()
+{
+    return RunContext::current().getOrBuild<UserPolicySnapshot>(buildUserPolicies);
+}
+
+BenchmarkResult UserPolicyCheck::check()
+{
+    auto policies = UserAdministrativeTemplatesSection::getUserPolicies();
+    if (FAILED(policies->status)) {
+        return BenchmarkResult(getId(), getName(), CheckStatus::Error,
+                               "Failed to enumerate user profiles");
+    }
+    if (policies->users.empty()) {
+        return BenchmarkResult(getId(), getName(), CheckStatus::NotApplicable, "No user profiles found");
+    }
+
+    BenchmarkResult result(getId(), getName(), CheckStatus::Pass, std::string());
+    size_t failed = 0;
+    size_t errors = 0;
+    for (const UserPolicySnapshot::User& user : policies->users) {
+        const BenchmarkResult& row = user.rows[this->row];
+        result.users.push_back({ user.sid, row.status, row.details });
+        failed += row.status == CheckStatus::Fail;
+        errors += row.status == CheckStatus::Error;
+    }
+
+    std::string total = std::to_string(policies->users.size());
+    if (failed) {
+        result.status = CheckStatus::Fail;
+        result.details = std::to_string(failed) + " of " + total + " user(s) do not comply";
+    } else if (errors) {
+        result.status = CheckStatus::Error;
+        result.details = "Could not evaluate " + std::to_string(errors) + " of " + total + " user(s)";
+    } else {
+        result.details = "All " + total + " user(s) comply";
+    }
+    return result;
+}
+
+void UserAdministrativeTemplatesSection::initialize()
+{
+    static SectionChecks sectionChecks;
+    checks = CheckList(sectionChecks.pointers.data(), sectionChecks.pointers.size());
+}
+
+std::vector<BenchmarkResult> UserAdministrativeTemplatesSection::runChecks()
+{
+    std::vector<BenchmarkResult> results;
+    results.reserve(kSettingCount);
+    for (size_t row = 0; row < kSettingCount; row++) {
+        results.push_back(checks[row]->check());
+    }
+    return results;
+}
@@ -1,17 +1,110 @@
 #include "include/sections/section2/security_options.h"
-#include <windows.h>
-#include <ntsecapi.h>
-#include <lm.h>
-#include <iomanip>
-#include <sstream>
-#include <sal.h>
-#include <sddl.h>
-#include <vector>
+#include "include/registry_rule_table.h"
+#include "include/run_context.h"
+#include "include/string_utils.h"
+#include "include/well_known_sids.h"
+#include <array>
 #include <string>
+#include <string_view>
+#include <vector>
 
-#pragma comment(lib, "netapi32.lib")
-#pragma comment(lib, "advapi32.lib")
-#pragma comment(lib, "secur32.lib")
+namespace {
+    const wchar_t kPoliciesSystemKey[] = L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Policies\\System";
+    const wchar_t kLsaKey[] = L"SYSTEM\\CurrentControlSet\\Control\\Lsa";
+    const wchar_t kLanManPrintServersKey[] = L"SYSTEM\\CurrentControlSet\\Control\\Print\\Providers\\LanMan Print Services\\Servers";
+    const wchar_t kNetlogonParametersKey[] = L"SYSTEM\\CurrentControlSet\\Services\\Netlogon\\Parameters";
+
+    // Registry-backed security options, in benchmark order. A new 2.3.x item
+    // that tests one value is a row here, not a check class, and its
+    // expression (see RuleProgram) is data like the rest of the row.
+    constexpr RegistryRule kRegistryRules[] = {
+        { "2.3.1.1", "Ensure 'Accounts: Block Microsoft accounts' is set to 'Users can't add or log on with Microsoft accounts'",
+          kPoliciesSystemKey, L"NoConnectedUser", REG_DWORD, "value == 3",
+          "Failed to check Microsoft account blocking settings",
+          "Microsoft accounts are properly blocked",
+          "Microsoft accounts are not properly blocked" },
+        { "2.3.1.3", "Ensure 'Accounts: Limit local account use of blank passwords to console logon only' is set to 'Enabled'",
+          kLsaKey, L"LimitBlankPasswordUse", REG_DWORD, "value == 1",
+          "Failed to check blank password usage settings",
+          "Blank password usage is properly limited",
+          "Blank password usage is not properly limited" },
+        { "2.3.2.1", "Ensure 'Audit: Force audit policy subcategory settings to override audit policy category settings' is set to 'Enabled'",
+          kLsaKey, L"SCENoApplyLegacyAuditPolicy", REG_DWORD, "value == 1",
+          "Failed to check audit policy override settings",
+          "Audit policy subcategory settings override category settings",
+          "Audit policy subcategory settings do not override category settings" },
+        { "2.3.2.2", "Ensure 'Audit: Shut down system immediately if unable to log security audits' is set to 'Disabled'",
+          kLsaKey, L"CrashOnAuditFail", REG_DWORD, "value == 0",
+          "Failed to check audit failure shutdown settings",
+          "System does not shut down on audit failure",
+          "System is configured to shut down on audit failure" },
+        { "2.3.4.1", "Ensure 'Devices: Prevent users from installing printer drivers' is set to 'Enabled'",
+          kLanManPrintServersKey, L"AddPrinterDrivers", REG_DWORD, "value == 1",
+          "Failed to check printer driver installation restrictions",
+          "Users are prevented from installing printer drivers",
+          "Users are allowed to install printer drivers" },
+        { "2.3.6.1", "Ensure 'Domain member: Digitally encrypt or sign secure channel data (always)' is set to 'Enabled'",
+          kNetlogonParametersKey, L"RequireSignOrSeal", REG_DWORD, "value == 1",
+          "Failed to check secure channel encryption settings",
+          "Secure channel data encryption or signing is required",
+          "Secure channel data encryption or signing is not required" },
+        { "2.3.6.2", "Ensure 'Domain member: Digitally encrypt secure channel data (when possible)' is set to 'Enabled'",
+          kNetlogonParametersKey, L"SealSecureChannel", REG_DWORD, "value == 1",
+          "Failed to check secure channel encryption settings",
+          "Secure channel data encryption is enabled",
+          "Secure channel data encryption is disabled" },
+        { "2.3.6.3", "Ensure 'Domain member: Digitally sign secure channel data (when possible)' is set to 'Enabled'",
+          kNetlogonParametersKey, L"SignSecureChannel", REG_DWORD, "value == 1",
+          "Failed to check secure channel signing settings",
+          "Secure channel data signing is enabled",
+          "Secure channel data signing is disabled" },
+        { "2.3.6.4", "Ensure 'Domain member: Disable machine account password changes' is set to 'Disabled'",
+          kNetlogonParametersKey, L"DisablePasswordChange", REG_DWORD, "value == 0",
+          "Failed to check machine account password change settings",
+          "Machine account password changes are enabled",
+          "Machine account password changes are disabled" },
+        { "2.3.6.5", "Ensure 'Domain member: Maximum machine account password age' is set to '30 or fewer days, but not 0'",
+          kNetlogonParametersKey, L"MaximumPasswordAge", REG_DWORD, "value in [1, 30]",
+          "Failed to check maximum machine account password age",
+          "Maximum password age is set to {} days",
+          "Maximum password age is set to {} days (should be 30 or fewer days, but not 0)" },
+        { "2.3.6.6", "Ensure 'Domain member: Require strong (Windows 2000 or later) session key' is set to 'Enabled'",
+          kNetlogonParametersKey, L"RequireStrongKey", REG_DWORD, "value == 1",
+          "Failed to check session key strength requirements",
+          "Strong session keys are required",
+          "Strong session keys are not required" },
+    };
+
+    constexpr size_t kRuleCount = sizeof(kRegistryRules) / sizeof(kRegistryRules[0]);
+
+    const RegistryRuleTable& registryRules() {
+        static const RegistryRuleTable table(kRegistryRules, kRuleCount);
+        return table;
+    }
+
+    // Next dot-separated number of a benchmark ID, consumed from `id`
+    unsigned long nextIdPart(std::string_view& id) {
+        unsigned long part = 0;
+        size_t i = 0;
+        for (; i < id.size() && id[i] >= '0' && id[i] <= '9'; i++) {
+            part = part * 10 + static_cast<unsigned long>(id[i] - '0');
+        }
+        id.remove_prefix(i < id.size() ? i + 1 : i);
+        return part;
+    }
+
+    // Orders dotted benchmark IDs numerically, so "2.3.10.1" follows "2.3.9.1"
+    bool idLess(std::string_view a, std::string_view b) {
+        while (!a.empty() && !b.empty()) {
+            unsigned long partA = nextIdPart(a);
+            unsigned long partB = nextIdPart(b);
+            if (partA != partB) {
+                return partA < partB;
+            }
+        }
+        return a.empty() && !b.empty();
+    }
+}
 
 // ---------------------------------------------------
 // Static method definitions
@@ -20,78 +113,39 @@
 BOOL SecurityOptionsSection::CheckUserPrivilege(const wchar_t* privilegeName,
                                                 const wchar_t* expectedAccount)
 {
-    // ------------------------------------------------
-    // Placeholder logic — replace with real checks!
-    // ------------------------------------------------
-    // Example:
     // 1) Convert expectedAccount to a SID with GetAccountSid.
-    // 2) Check that this SID actually has the privilegeName
-    //    using LsaEnumerateAccountsWithUserRight or similar.
-
-    PSID pSid = nullptr;
-    if (!GetAccountSid(expectedAccount, &pSid)) {
+    // 2) Check that this SID is among the accounts holding privilegeName.
+    std::wstring sid;
+    if (!GetAccountSid(expectedAccount, sid)) {
         // Could not resolve the account to a SID, so assume no
         return FALSE;
     }
 
-    // In a real implementation, we'd check if pSid has `privilegeName`.
-    // For now, just freeing the SID and returning FALSE.
-    LocalFree(pSid);
-    return FALSE;
-}
-
-HRESULT SecurityOptionsSection::getRegistryValue(
-    const std::wstring& path,
-    const std::wstring& value,
-    DWORD& dataType,
-    std::vector<BYTE>& data
-)
-{
-    HKEY hKey;
-    LONG result = RegOpenKeyExW(HKEY_LOCAL_MACHINE, path.c_str(), 0, KEY_READ, &hKey);
-    if (result != ERROR_SUCCESS) {
-        return HRESULT_FROM_WIN32(result);
+    std::vector<std::wstring> holders;
+    if (FAILED(SystemProbe::current().queryAccountsWithRight(privilegeName, holders))) {
+        return FALSE;
     }
 
-    DWORD dataSize = 0;
-    result = RegQueryValueExW(hKey, value.c_str(), nullptr, &dataType, nullptr, &dataSize);
-    if (result == ERROR_SUCCESS && dataSize > 0) {
-        data.resize(dataSize);
-        result = RegQueryValueExW(hKey, value.c_str(), nullptr, &dataType, data.data(), &dataSize);
+    for (const auto& holder : holders) {
+        if (equalsIgnoreCase(holder, sid)) {
+            return TRUE;
+        }
     }
-
-    RegCloseKey(hKey);
-    return HRESULT_FROM_WIN32(result);
+    return FALSE;
 }
 
 // ---------------------------------------------------
 // Other protected static helpers
 // ---------------------------------------------------
-BOOL SecurityOptionsSection::GetAccountSid(LPCWSTR accountName, PSID* ppSid)
+BOOL SecurityOptionsSection::GetAccountSid(const wchar_t* accountName, std::wstring& sid)
 {
-    DWORD sidSize = 0;
-    DWORD domainSize = 0;
-    SID_NAME_USE sidType;
-    
-    LookupAccountNameW(nullptr, accountName, nullptr, &sidSize, nullptr, &domainSize, &sidType);
-    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
-        return FALSE;
-    }
-
-    *ppSid = static_cast<PSID>(LocalAlloc(LPTR, sidSize));
-    if (!*ppSid) {
-        return FALSE;
-    }
-
-    std::vector<WCHAR> domainName(domainSize);
-    if (!LookupAccountNameW(nullptr, accountName, *ppSid, &sidSize,
-                            domainName.data(), &domainSize, &sidType))
-    {
-        LocalFree(*ppSid);
-        return FALSE;
+    // Built-in principals never need a lookup
+    std::wstring_view wellKnown = findWellKnownSid(accountName);
+    if (!wellKnown.empty()) {
+        sid.assign(wellKnown);
+        return TRUE;
     }
-
-    return TRUE;
+    return SUCCEEDED(SystemProbe::current().lookupAccountSid(accountName, sid)) ? TRUE : FALSE;
 }
 
 std::wstring SecurityOptionsSection::GetPrivilegeDisplayName(const wchar_t* /*privilegeName*/)
@@ -100,7 +154,7 @@ std::wstring SecurityOptionsSection::GetPrivilegeDisplayName(const wchar_t* /*pr
     return L"";
 }
 
-BOOL SecurityOptionsSection::IsUserInGroup(PSID /*userSid*/, const wchar_t* /*groupName*/)
+BOOL SecurityOptionsSection::IsUserInGroup(const std::wstring& /*userSid*/, const wchar_t* /*groupName*/)
 {
     // Placeholder. Real code would check membership.
     return FALSE;
@@ -109,38 +163,66 @@ BOOL SecurityOptionsSection::IsUserInGroup(PSID /*userSid*/, const wchar_t* /*gr
 // ---------------------------------------------------
 // Class: SecurityOptionsSection Implementation
 // ---------------------------------------------------
+namespace {
+    /**
+     * Section 2's checks in benchmark order: the check classes merged with a
+     * RegistryRuleCheck per table row, all in static storage and built once
+     * per process.
+     */
+    struct SectionChecks {
+        // Checks that read something other than a single registry DWORD
+        CheckArray<
+            AccessCredentialManagerCheck,   // 2.2.1
+            AccessFromNetworkCheck,         // 2.2.2
+            ActAsPartOfOSCheck,             // 2.2.3
+            AdjustMemoryQuotasCheck,        // 2.2.4
+            GuestAccountStatusCheck,        // 2.3.1.2
+            RenameAdminAccountCheck,        // 2.3.1.4
+            RenameGuestAccountCheck         // 2.3.1.5
+        > classChecks;
+        RegistryRuleChecks<kRuleCount> ruleChecks{ registryRules() };
+
+        static constexpr size_t kCount = decltype(classChecks)::kSize + kRuleCount;
+        std::array<BenchmarkCheck*, kCount> merged{};
+        std::array<int, kCount> ruleRow{};      // table row of each check, or -1
+
+        SectionChecks() {
+            size_t count = 0;
+            size_t next = 0;
+            for (size_t row = 0; row <= kRuleCount; row++) {
+                while (next < decltype(classChecks)::kSize &&
+                       (row == kRuleCount || idLess(classChecks[next]->getId(), kRegistryRules[row].id))) {
+                    merged[count] = classChecks[next++];
+                    ruleRow[count++] = -1;
+                }
+                if (row < kRuleCount) {
+                    merged[count] = ruleChecks[row];
+                    ruleRow[count++] = static_cast<int>(row);
+                }
+            }
+        }
+    };
+}
+
 void SecurityOptionsSection::initialize()
 {
-    // Register all checks for section 2
-    checks.push_back(std::make_unique<AccessCredentialManagerCheck>());       // 2.2.1
-    checks.push_back(std::make_unique<AccessFromNetworkCheck>());            // 2.2.2
-    checks.push_back(std::make_unique<ActAsPartOfOSCheck>());                // 2.2.3
-    checks.push_back(std::make_unique<AdjustMemoryQuotasCheck>());           // 2.2.4
-
-    checks.push_back(std::make_unique<BlockMicrosoftAccountsCheck>());       // 2.3.1.1
-    checks.push_back(std::make_unique<GuestAccountStatusCheck>());           // 2.3.1.2
-    checks.push_back(std::make_unique<LimitBlankPasswordUseCheck>());        // 2.3.1.3
-    checks.push_back(std::make_unique<RenameAdminAccountCheck>());           // 2.3.1.4
-    checks.push_back(std::make_unique<RenameGuestAccountCheck>());           // 2.3.1.5
-
-    checks.push_back(std::make_unique<AuditForceSubcategoryCheck>());        // 2.3.2.1
-    checks.push_back(std::make_unique<AuditShutdownSystemCheck>());          // 2.3.2.2
-
-    checks.push_back(std::make_unique<PreventPrinterDriversCheck>());        // 2.3.4.1
-
-    checks.push_back(std::make_unique<DigitallyEncryptSecureChannelCheck>());// 2.3.6.1
-    checks.push_back(std::make_unique<DigitallyEncryptChannelCheck>());      // 2.3.6.2
-    checks.push_back(std::make_unique<DigitallySignChannelCheck>());         // 2.3.6.3
-    checks.push_back(std::make_unique<DisablePasswordChangesCheck>());       // 2.3.6.4
-    checks.push_back(std::make_unique<MaximumPasswordAgeCheck>());           // 2.3.6.5
-    checks.push_back(std::make_unique<RequireStrongSessionKeyCheck>());      // 2.3.6.6
+    static SectionChecks sectionChecks;
+    checks = CheckList(sectionChecks.merged.data(), sectionChecks.merged.size());
+    ruleRowOfCheck = sectionChecks.ruleRow.data();
 }
 
 std::vector<BenchmarkResult> SecurityOptionsSection::runChecks()
 {
+    // One pass over the rule table, key by key, then the class checks
+    std::vector<BenchmarkResult> ruleResults = registryRules().evaluate(RunContext::current().getRegistry());
+
     std::vector<BenchmarkResult> results;
-    for (const auto& check : checks) {
-        results.push_back(check->check());
+    for (size_t i = 0; i < checks.size(); i++) {
+        if (ruleRowOfCheck[i] >= 0) {
+            results.push_back(std::move(ruleResults[ruleRowOfCheck[i]]));
+        } else {
+            results.push_back(checks[i]->check());
+        }
     }
     return results;
 }
@@ -148,6 +230,11 @@ std::vector<BenchmarkResult> SecurityOptionsSection::runChecks()
 // ---------------------------------------------------
 // Example Check Implementations
 // ---------------------------------------------------
+void AccessCredentialManagerCheck::declareInputs(ProbeInputs& inputs) const
+{
+    inputs.addAccountRight(L"SeTrustedCredManAccessPrivilege");
+}
+
 BenchmarkResult AccessCredentialManagerCheck::check()
 {
     BenchmarkResult result(getId(), getName(), CheckStatus::Error,
@@ -155,6 +242,12 @@ BenchmarkResult AccessCredentialManagerCheck::check()
 
     const wchar_t* privilege = L"SeTrustedCredManAccessPrivilege";
 
+    // A right that cannot be read leaves the result an error
+    std::vector<std::wstring> holders;
+    if (FAILED(probe().queryAccountsWithRight(privilege, holders))) {
+        return result;
+    }
+
     BOOL hasAccess = SecurityOptionsSection::CheckUserPrivilege(privilege, L"Users") ||
                      SecurityOptionsSection::CheckUserPrivilege(privilege, L"Administrators");
 
@@ -170,6 +263,11 @@ BenchmarkResult AccessCredentialManagerCheck::check()
 }
 
 // 2.2.2
+void AccessFromNetworkCheck::declareInputs(ProbeInputs& inputs) const
+{
+    inputs.addAccountRight(L"SeNetworkLogonRight");
+}
+
 BenchmarkResult AccessFromNetworkCheck::check()
 {
     BenchmarkResult result(getId(), getName(), CheckStatus::Error,
@@ -177,6 +275,11 @@ BenchmarkResult AccessFromNetworkCheck::check()
 
     const wchar_t* privilege = L"SeNetworkLogonRight";
 
+    std::vector<std::wstring> holders;
+    if (FAILED(probe().queryAccountsWithRight(privilege, holders))) {
+        return result;
+    }
+
     bool adminAccess = SecurityOptionsSection::CheckUserPrivilege(privilege, L"Administrators");
     bool rdpAccess   = SecurityOptionsSection::CheckUserPrivilege(privilege, L"Remote Desktop Users");
 
@@ -192,6 +295,11 @@ BenchmarkResult AccessFromNetworkCheck::check()
 }
 
 // 2.2.3
+void ActAsPartOfOSCheck::declareInputs(ProbeInputs& inputs) const
+{
+    inputs.addAccountRight(L"SeTcbPrivilege");
+}
+
 BenchmarkResult ActAsPartOfOSCheck::check()
 {
     BenchmarkResult result(getId(), getName(), CheckStatus::Error,
@@ -199,6 +307,11 @@ BenchmarkResult ActAsPartOfOSCheck::check()
 
     const wchar_t* privilege = L"SeTcbPrivilege";
 
+    std::vector<std::wstring> holders;
+    if (FAILED(probe().queryAccountsWithRight(privilege, holders))) {
+        return result;
+    }
+
     BOOL hasAccess = SecurityOptionsSection::CheckUserPrivilege(privilege, L"Users") ||
                      SecurityOptionsSection::CheckUserPrivilege(privilege, L"Administrators");
 
@@ -214,6 +327,11 @@ BenchmarkResult ActAsPartOfOSCheck::check()
 }
 
 // 2.2.4
+void AdjustMemoryQuotasCheck::declareInputs(ProbeInputs& inputs) const
+{
+    inputs.addAccountRight(L"SeIncreaseQuotaPrivilege");
+}
+
 BenchmarkResult AdjustMemoryQuotasCheck::check()
 {
     BenchmarkResult result(getId(), getName(), CheckStatus::Error,
@@ -221,6 +339,11 @@ BenchmarkResult AdjustMemoryQuotasCheck::check()
 
     const wchar_t* privilege = L"SeIncreaseQuotaPrivilege";
 
+    std::vector<std::wstring> holders;
+    if (FAILED(probe().queryAccountsWithRight(privilege, holders))) {
+        return result;
+    }
+
     bool adminAccess          = SecurityOptionsSection::CheckUserPrivilege(privilege, L"Administrators");
     bool localServiceAccess   = SecurityOptionsSection::CheckUserPrivilege(privilege, L"LOCAL SERVICE");
     bool networkServiceAccess = SecurityOptionsSection::CheckUserPrivilege(privilege, L"NETWORK SERVICE");
@@ -236,364 +359,76 @@ BenchmarkResult AdjustMemoryQuotasCheck::check()
     return result;
 }
 
-// 2.3.1.1
-BenchmarkResult BlockMicrosoftAccountsCheck::check()
+// 2.3.1.2
+void GuestAccountStatusCheck::declareInputs(ProbeInputs& inputs) const
 {
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error,
-                           "Failed to check Microsoft account blocking settings");
-
-    std::wstring registryPath = L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Policies\\System";
-    std::wstring valueName    = L"NoConnectedUser";
-    DWORD dataType;
-    std::vector<BYTE> data;
-
-    HRESULT hr = SecurityOptionsSection::getRegistryValue(registryPath, valueName, dataType, data);
-    if (SUCCEEDED(hr) && dataType == REG_DWORD && data.size() == sizeof(DWORD)) {
-        DWORD value = *reinterpret_cast<DWORD*>(data.data());
-        if (value == 3) {
-            result.status = CheckStatus::Pass;
-            result.details = "Microsoft accounts are properly blocked";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Microsoft accounts are not properly blocked";
-        }
-    }
-
-    return result;
+    inputs.addUser(L"Guest");
 }
 
-// 2.3.1.2
 BenchmarkResult GuestAccountStatusCheck::check()
 {
     BenchmarkResult result(getId(), getName(), CheckStatus::Error,
                            "Failed to check guest account status");
 
-    USER_INFO_1* userInfo = nullptr;
-    NET_API_STATUS status = NetUserGetInfo(nullptr, L"Guest", 1, (LPBYTE*)&userInfo);
-
-    if (status == NERR_Success && userInfo) {
-        if (userInfo->usri1_flags & UF_ACCOUNTDISABLE) {
+    UserAccountInfo userInfo;
+    if (SUCCEEDED(probe().queryUserInfo(L"Guest", userInfo))) {
+        if (userInfo.flags & UF_ACCOUNTDISABLE) {
             result.status = CheckStatus::Pass;
             result.details = "Guest account is disabled";
         } else {
             result.status = CheckStatus::Fail;
             result.details = "Guest account is enabled";
         }
-        NetApiBufferFree(userInfo);
     }
 
     return result;
 }
 
-// 2.3.1.3
-BenchmarkResult LimitBlankPasswordUseCheck::check()
+// 2.3.1.4
+void RenameAdminAccountCheck::declareInputs(ProbeInputs& inputs) const
 {
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error,
-                           "Failed to check blank password usage settings");
-
-    std::wstring registryPath = L"SYSTEM\\CurrentControlSet\\Control\\Lsa";
-    std::wstring valueName    = L"LimitBlankPasswordUse";
-    DWORD dataType;
-    std::vector<BYTE> data;
-
-    HRESULT hr = SecurityOptionsSection::getRegistryValue(registryPath, valueName, dataType, data);
-    if (SUCCEEDED(hr) && dataType == REG_DWORD && data.size() == sizeof(DWORD)) {
-        DWORD value = *reinterpret_cast<DWORD*>(data.data());
-        if (value == 1) {
-            result.status = CheckStatus::Pass;
-            result.details = "Blank password usage is properly limited";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Blank password usage is not properly limited";
-        }
-    }
-
-    return result;
+    inputs.addUser(L"Administrator");
 }
 
-// 2.3.1.4
 BenchmarkResult RenameAdminAccountCheck::check()
 {
     BenchmarkResult result(getId(), getName(), CheckStatus::Error,
                            "Failed to check administrator account name");
 
-    USER_INFO_1* userInfo = nullptr;
-    NET_API_STATUS status = NetUserGetInfo(nullptr, L"Administrator", 1, (LPBYTE*)&userInfo);
-
-    if (status == NERR_Success && userInfo) {
-        if (wcscmp(userInfo->usri1_name, L"Administrator") == 0) {
+    UserAccountInfo userInfo;
+    if (SUCCEEDED(probe().queryUserInfo(L"Administrator", userInfo))) {
+        if (userInfo.name == L"Administrator") {
             result.status = CheckStatus::Fail;
             result.details = "Administrator account uses default name";
         } else {
             result.status = CheckStatus::Pass;
             result.details = "Administrator account has been renamed";
         }
-        NetApiBufferFree(userInfo);
     }
 
     return result;
 }
 
 // 2.3.1.5
+void RenameGuestAccountCheck::declareInputs(ProbeInputs& inputs) const
+{
+    inputs.addUser(L"Guest");
+}
+
 BenchmarkResult RenameGuestAccountCheck::check()
 {
     BenchmarkResult result(getId(), getName(), CheckStatus::Error,
                            "Failed to check guest account name");
 
-    USER_INFO_1* userInfo = nullptr;
-    NET_API_STATUS status = NetUserGetInfo(nullptr, L"Guest", 1, (LPBYTE*)&userInfo);
-
-    if (status == NERR_Success && userInfo) {
-        if (wcscmp(userInfo->usri1_name, L"Guest") == 0) {
+    UserAccountInfo userInfo;
+    if (SUCCEEDED(probe().queryUserInfo(L"Guest", userInfo))) {
+        if (userInfo.name == L"Guest") {
             result.status = CheckStatus::Fail;
             result.details = "Guest account uses default name";
         } else {
             result.status = CheckStatus::Pass;
             result.details = "Guest account has been renamed";
         }
-        NetApiBufferFree(userInfo);
-    }
-
-    return result;
-}
-
-// 2.3.2.1
-BenchmarkResult AuditForceSubcategoryCheck::check()
-{
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error,
-                           "Failed to check audit policy override settings");
-
-    std::wstring registryPath = L"SYSTEM\\CurrentControlSet\\Control\\Lsa";
-    std::wstring valueName    = L"SCENoApplyLegacyAuditPolicy";
-    DWORD dataType;
-    std::vector<BYTE> data;
-
-    HRESULT hr = SecurityOptionsSection::getRegistryValue(registryPath, valueName, dataType, data);
-    if (SUCCEEDED(hr) && dataType == REG_DWORD && data.size() == sizeof(DWORD)) {
-        DWORD value = *reinterpret_cast<DWORD*>(data.data());
-        if (value == 1) {
-            result.status = CheckStatus::Pass;
-            result.details = "Audit policy subcategory settings override category settings";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Audit policy subcategory settings do not override category settings";
-        }
-    }
-
-    return result;
-}
-
-// 2.3.2.2
-BenchmarkResult AuditShutdownSystemCheck::check()
-{
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error,
-                           "Failed to check audit failure shutdown settings");
-
-    std::wstring registryPath = L"SYSTEM\\CurrentControlSet\\Control\\Lsa";
-    std::wstring valueName    = L"CrashOnAuditFail";
-    DWORD dataType;
-    std::vector<BYTE> data;
-
-    HRESULT hr = SecurityOptionsSection::getRegistryValue(registryPath, valueName, dataType, data);
-    if (SUCCEEDED(hr) && dataType == REG_DWORD && data.size() == sizeof(DWORD)) {
-        DWORD value = *reinterpret_cast<DWORD*>(data.data());
-        if (value == 0) {
-            result.status = CheckStatus::Pass;
-            result.details = "System does not shut down on audit failure";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "System is configured to shut down on audit failure";
-        }
-    }
-
-    return result;
-}
-
-// 2.3.4.1
-BenchmarkResult PreventPrinterDriversCheck::check()
-{
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error,
-                           "Failed to check printer driver installation restrictions");
-
-    std::wstring registryPath = L"SYSTEM\\CurrentControlSet\\Control\\Print\\Providers\\LanMan Print Services\\Servers";
-    std::wstring valueName    = L"AddPrinterDrivers";
-    DWORD dataType;
-    std::vector<BYTE> data;
-
-    HRESULT hr = SecurityOptionsSection::getRegistryValue(registryPath, valueName, dataType, data);
-    if (SUCCEEDED(hr) && dataType == REG_DWORD && data.size() == sizeof(DWORD)) {
-        DWORD value = *reinterpret_cast<DWORD*>(data.data());
-        if (value == 1) {
-            result.status = CheckStatus::Pass;
-            result.details = "Users are prevented from installing printer drivers";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Users are allowed to install printer drivers";
-        }
-    }
-
-    return result;
-}
-
-// 2.3.6.1
-BenchmarkResult DigitallyEncryptSecureChannelCheck::check()
-{
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error,
-                           "Failed to check secure channel encryption settings");
-
-    std::wstring registryPath = L"SYSTEM\\CurrentControlSet\\Services\\Netlogon\\Parameters";
-    std::wstring valueName    = L"RequireSignOrSeal";
-    DWORD dataType;
-    std::vector<BYTE> data;
-
-    HRESULT hr = SecurityOptionsSection::getRegistryValue(registryPath, valueName, dataType, data);
-    if (SUCCEEDED(hr) && dataType == REG_DWORD && data.size() == sizeof(DWORD)) {
-        DWORD value = *reinterpret_cast<DWORD*>(data.data());
-        if (value == 1) {
-            result.status = CheckStatus::Pass;
-            result.details = "Secure channel data encryption or signing is required";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Secure channel data encryption or signing is not required";
-        }
-    }
-
-    return result;
-}
-
-// 2.3.6.2
-BenchmarkResult DigitallyEncryptChannelCheck::check()
-{
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error,
-                           "Failed to check secure channel encryption settings");
-
-    std::wstring registryPath = L"SYSTEM\\CurrentControlSet\\Services\\Netlogon\\Parameters";
-    std::wstring valueName    = L"SealSecureChannel";
-    DWORD dataType;
-    std::vector<BYTE> data;
-
-    HRESULT hr = SecurityOptionsSection::getRegistryValue(registryPath, valueName, dataType, data);
-    if (SUCCEEDED(hr) && dataType == REG_DWORD && data.size() == sizeof(DWORD)) {
-        DWORD value = *reinterpret_cast<DWORD*>(data.data());
-        if (value == 1) {
-            result.status = CheckStatus::Pass;
-            result.details = "Secure channel data encryption is enabled";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Secure channel data encryption is disabled";
-        }
-    }
-
-    return result;
-}
-
-// 2.3.6.3
-BenchmarkResult DigitallySignChannelCheck::check()
-{
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error,
-                           "Failed to check secure channel signing settings");
-
-    std::wstring registryPath = L"SYSTEM\\CurrentControlSet\\Services\\Netlogon\\Parameters";
-    std::wstring valueName    = L"SignSecureChannel";
-    DWORD dataType;
-    std::vector<BYTE> data;
-
-    HRESULT hr = SecurityOptionsSection::getRegistryValue(registryPath, valueName, dataType, data);
-    if (SUCCEEDED(hr) && dataType == REG_DWORD && data.size() == sizeof(DWORD)) {
-        DWORD value = *reinterpret_cast<DWORD*>(data.data());
-        if (value == 1) {
-            result.status = CheckStatus::Pass;
-            result.details = "Secure channel data signing is enabled";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Secure channel data signing is disabled";
-        }
-    }
-
-    return result;
-}
-
-// 2.3.6.4
-BenchmarkResult DisablePasswordChangesCheck::check()
-{
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error,
-                           "Failed to check machine account password change settings");
-
-    std::wstring registryPath = L"SYSTEM\\CurrentControlSet\\Services\\Netlogon\\Parameters";
-    std::wstring valueName    = L"DisablePasswordChange";
-    DWORD dataType;
-    std::vector<BYTE> data;
-
-    HRESULT hr = SecurityOptionsSection::getRegistryValue(registryPath, valueName, dataType, data);
-    if (SUCCEEDED(hr) && dataType == REG_DWORD && data.size() == sizeof(DWORD)) {
-        DWORD value = *reinterpret_cast<DWORD*>(data.data());
-        if (value == 0) {
-            result.status = CheckStatus::Pass;
-            result.details = "Machine account password changes are enabled";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Machine account password changes are disabled";
-        }
-    }
-
-    return result;
-}
-
-// 2.3.6.5
-BenchmarkResult MaximumPasswordAgeCheck::check()
-{
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error,
-                           "Failed to check maximum machine account password age");
-
-    std::wstring registryPath = L"SYSTEM\\CurrentControlSet\\Services\\Netlogon\\Parameters";
-    std::wstring valueName    = L"MaximumPasswordAge";
-    DWORD dataType;
-    std::vector<BYTE> data;
-
-    HRESULT hr = SecurityOptionsSection::getRegistryValue(registryPath, valueName, dataType, data);
-    if (SUCCEEDED(hr) && dataType == REG_DWORD && data.size() == sizeof(DWORD)) {
-        DWORD value = *reinterpret_cast<DWORD*>(data.data());
-        if (value > 0 && value <= 30) {
-            result.status = CheckStatus::Pass;
-            std::stringstream ss;
-            ss << "Maximum password age is set to " << value << " days";
-            result.details = ss.str();
-        } else if (value == 0) {
-            result.status = CheckStatus::Fail;
-            result.details = "Maximum password age is set to never expire (0)";
-        } else {
-            result.status = CheckStatus::Fail;
-            std::stringstream ss;
-            ss << "Maximum password age is set to " << value
-               << " days (should be 30 or fewer days, but not 0)";
-            result.details = ss.str();
-        }
-    }
-
-    return result;
-}
-
-// 2.3.6.6
-BenchmarkResult RequireStrongSessionKeyCheck::check()
-{
-    BenchmarkResult result(getId(), getName(), CheckStatus::Error,
-                           "Failed to check session key strength requirements");
-
-    std::wstring registryPath = L"SYSTEM\\CurrentControlSet\\Services\\Netlogon\\Parameters";
-    std::wstring valueName    = L"RequireStrongKey";
-    DWORD dataType;
-    std::vector<BYTE> data;
-
-    HRESULT hr = SecurityOptionsSection::getRegistryValue(registryPath, valueName, dataType, data);
-    if (SUCCEEDED(hr) && dataType == REG_DWORD && data.size() == sizeof(DWORD)) {
-        DWORD value = *reinterpret_cast<DWORD*>(data.data());
-        if (value == 1) {
-            result.status = CheckStatus::Pass;
-            result.details = "Strong session keys are required";
-        } else {
-            result.status = CheckStatus::Fail;
-            result.details = "Strong session keys are not required";
-        }
     }
 
     return result;
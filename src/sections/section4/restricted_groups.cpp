@@ -1,15 +1,27 @@
 #include "include/sections/section4/restricted_groups.h"
-#include <lm.h>
-#include <sddl.h>
+#include "include/string_utils.h"
 #include <sstream>    // <-- Needed for std::stringstream
 #include <string>     // <-- Ensures std::string is recognized
 #include <vector>
 
-// Link libraries if needed
-#pragma comment(lib, "netapi32.lib")
+namespace {
+struct RestrictedGroup {
+    std::wstring name;
+    std::vector<std::wstring> allowedMembers;
+};
+
+const RestrictedGroup kRestrictedGroups[] = {
+    {L"Administrators", {L"Administrator", L"Domain Admins"}},
+    {L"Backup Operators", {}},
+    {L"Power Users", {}}
+};
+}
 
 void RestrictedGroupsSection::initialize() {
-    checks.push_back(std::make_unique<RestrictedGroupCheck>());
+    static const CheckArray<
+        RestrictedGroupCheck
+    > sectionChecks;
+    checks = sectionChecks.list();
 }
 
 std::vector<BenchmarkResult> RestrictedGroupsSection::runChecks() {
@@ -21,33 +33,11 @@ std::vector<BenchmarkResult> RestrictedGroupsSection::runChecks() {
 }
 
 std::vector<std::wstring> RestrictedGroupCheck::getGroupMembers(const std::wstring& groupName) {
+    // Entries are "domain\username" or similar; a missing group has no members
     std::vector<std::wstring> members;
-    LOCALGROUP_MEMBERS_INFO_2* memberInfo = nullptr;
-    DWORD entriesRead = 0;
-    DWORD totalEntries = 0;
-    NET_API_STATUS status;
-    
-    status = NetLocalGroupGetMembers(
-        nullptr,                   // local server
-        groupName.c_str(),         // group name
-        2,                         // level (LOCALGROUP_MEMBERS_INFO_2)
-        (LPBYTE*)&memberInfo,
-        MAX_PREFERRED_LENGTH,
-        &entriesRead,
-        &totalEntries,
-        nullptr
-    );
-    
-    if (status == NERR_Success && memberInfo != nullptr) {
-        for (DWORD i = 0; i < entriesRead; i++) {
-            // memberInfo[i].lgrmi2_domainandname contains "domain\username" or similar
-            if (memberInfo[i].lgrmi2_domainandname) {
-                members.push_back(memberInfo[i].lgrmi2_domainandname);
-            }
-        }
-        NetApiBufferFree(memberInfo);
+    if (FAILED(probe().queryLocalGroupMembers(groupName, members))) {
+        members.clear();
     }
-    
     return members;
 }
 
@@ -60,8 +50,7 @@ bool RestrictedGroupCheck::validateGroupMembership(const std::wstring& groupName
     for (const auto& member : currentMembers) {
         bool isAllowed = false;
         for (const auto& allowed : allowedMembers) {
-            // _wcsicmp is a case-insensitive wide-char compare
-            if (_wcsicmp(member.c_str(), allowed.c_str()) == 0) {
+            if (equalsIgnoreCase(member, allowed)) {
                 isAllowed = true;
                 break;
             }
@@ -73,26 +62,21 @@ bool RestrictedGroupCheck::validateGroupMembership(const std::wstring& groupName
     return true;
 }
 
+void RestrictedGroupCheck::declareInputs(ProbeInputs& inputs) const {
+    for (const auto& group : kRestrictedGroups) {
+        inputs.addLocalGroup(group.name);
+    }
+}
+
 BenchmarkResult RestrictedGroupCheck::check() {
     // Default result - assume Error unless we can check properly
     BenchmarkResult result(getId(), getName(), CheckStatus::Error,
                            "Failed to check restricted groups configuration");
 
-    struct RestrictedGroup {
-        std::wstring name;
-        std::vector<std::wstring> allowedMembers;
-    };
-
-    std::vector<RestrictedGroup> restrictedGroups = {
-        {L"Administrators", {L"Administrator", L"Domain Admins"}},
-        {L"Backup Operators", {}},
-        {L"Power Users", {}}
-    };
-
     bool allGroupsValid = true;
     std::stringstream details;  // We'll build output messages here
 
-    for (const auto& group : restrictedGroups) {
+    for (const auto& group : kRestrictedGroups) {
         if (!validateGroupMembership(group.name, group.allowedMembers)) {
             allGroupsValid = false;
             // Convert wstring to string for insertion into std::stringstream
@@ -4,59 +4,80 @@
  * system_services.cpp
  *************************************************************/
 #include "include/sections/section5/system_services.h"
-#include <windows.h>
+#include "include/run_context.h"
+#include "include/string_utils.h"
 #include <sstream>
 
+// -----------------------------------------------------
+// ServiceSnapshot Implementation
+// -----------------------------------------------------
+ServiceSnapshot::ServiceSnapshot(HRESULT status, std::vector<ServiceEntry> services)
+    : status(status), services(std::move(services))
+{
+    for (size_t i = 0; i < this->services.size(); i++) {
+        byName.emplace(toLowerCopy(this->services[i].name), i);
+    }
+}
+
+const ServiceEntry* ServiceSnapshot::find(const std::wstring& serviceName) const
+{
+    auto it = byName.find(toLowerCopy(serviceName));
+    return (it != byName.end()) ? &services[it->second] : nullptr;
+}
+
 // -----------------------------------------------------
 // SystemServicesSection Implementation
 // -----------------------------------------------------
 void SystemServicesSection::initialize()
 {
     // Add all checks for Section 5 (services 5.1 - 5.44)
-    checks.push_back(std::make_unique<BluetoothAudioGatewayCheck>());          // 5.1
-    checks.push_back(std::make_unique<BluetoothSupportServiceCheck>());        // 5.2
-    checks.push_back(std::make_unique<ComputerBrowserCheck>());                // 5.3
-    checks.push_back(std::make_unique<DownloadedMapsManagerCheck>());          // 5.4
-    checks.push_back(std::make_unique<GeolocationServiceCheck>());             // 5.5
-    checks.push_back(std::make_unique<IISAdminServiceCheck>());                // 5.6
-    checks.push_back(std::make_unique<InfraredMonitorServiceCheck>());         // 5.7
-    checks.push_back(std::make_unique<LinkLayerTopologyDiscoveryMapperCheck>()); // 5.8
-    checks.push_back(std::make_unique<LxssManagerCheck>());                    // 5.9
-    checks.push_back(std::make_unique<MicrosoftFTPServiceCheck>());            // 5.10
-    checks.push_back(std::make_unique<MicrosoftiSCSIInitiatorServiceCheck>());  // 5.11
-    checks.push_back(std::make_unique<OpenSSHServerCheck>());                  // 5.12
-    checks.push_back(std::make_unique<PeerNameResolutionProtocolCheck>());      // 5.13
-    checks.push_back(std::make_unique<PeerNetworkingGroupingCheck>());         // 5.14
-    checks.push_back(std::make_unique<PeerNetworkingIdentityManagerCheck>());   // 5.15
-    checks.push_back(std::make_unique<PNRPMachineNamePublicationServiceCheck>()); // 5.16
-    checks.push_back(std::make_unique<PrintSpoolerCheck>());                   // 5.17
-    checks.push_back(std::make_unique<ProblemReportsServiceCheck>());          // 5.18
-    checks.push_back(std::make_unique<RemoteAccessAutoConnectionManagerCheck>()); // 5.19
-    checks.push_back(std::make_unique<RemoteDesktopConfigurationCheck>());     // 5.20
-    checks.push_back(std::make_unique<RemoteDesktopServicesCheck>());          // 5.21
-    checks.push_back(std::make_unique<RemoteDesktopServicesUserModePortRedirectorCheck>()); // 5.22
-    checks.push_back(std::make_unique<RPCLocatorCheck>());                     // 5.23
-    checks.push_back(std::make_unique<RemoteRegistryCheck>());                 // 5.24
-    checks.push_back(std::make_unique<RoutingAndRemoteAccessCheck>());         // 5.25
-    checks.push_back(std::make_unique<ServerServiceCheck>());                  // 5.26
-    checks.push_back(std::make_unique<SimpleTCPIPServicesCheck>());            // 5.27
-    checks.push_back(std::make_unique<SNMPServiceCheck>());                    // 5.28
-    checks.push_back(std::make_unique<SpecialAdministrationConsoleHelperCheck>()); // 5.29
-    checks.push_back(std::make_unique<SSDPDiscoveryCheck>());                  // 5.30
-    checks.push_back(std::make_unique<UPnPDeviceHostCheck>());                 // 5.31
-    checks.push_back(std::make_unique<WebManagementServiceCheck>());           // 5.32
-    checks.push_back(std::make_unique<WindowsErrorReportingServiceCheck>());    // 5.33
-    checks.push_back(std::make_unique<WindowsEventCollectorCheck>());          // 5.34
-    checks.push_back(std::make_unique<WindowsMediaPlayerNetworkSharingServiceCheck>()); // 5.35
-    checks.push_back(std::make_unique<WindowsMobileHotspotServiceCheck>());    // 5.36
-    checks.push_back(std::make_unique<WindowsPushNotificationsSystemServiceCheck>()); // 5.37
-    checks.push_back(std::make_unique<WindowsPushToInstallServiceCheck>());    // 5.38
-    checks.push_back(std::make_unique<WindowsRemoteManagementCheck>());        // 5.39
-    checks.push_back(std::make_unique<WorldWideWebPublishingServiceCheck>());  // 5.40
-    checks.push_back(std::make_unique<XboxAccessoryManagementServiceCheck>()); // 5.41
-    checks.push_back(std::make_unique<XboxLiveAuthManagerCheck>());            // 5.42
-    checks.push_back(std::make_unique<XboxLiveGameSaveCheck>());              // 5.43
-    checks.push_back(std::make_unique<XboxLiveNetworkingServiceCheck>());      // 5.44
+    static const CheckArray<
+        BluetoothAudioGatewayCheck,                       // 5.1
+        BluetoothSupportServiceCheck,                     // 5.2
+        ComputerBrowserCheck,                             // 5.3
+        DownloadedMapsManagerCheck,                       // 5.4
+        GeolocationServiceCheck,                          // 5.5
+        IISAdminServiceCheck,                             // 5.6
+        InfraredMonitorServiceCheck,                      // 5.7
+        LinkLayerTopologyDiscoveryMapperCheck,            // 5.8
+        LxssManagerCheck,                                 // 5.9
+        MicrosoftFTPServiceCheck,                         // 5.10
+        MicrosoftiSCSIInitiatorServiceCheck,              // 5.11
+        OpenSSHServerCheck,                               // 5.12
+        PeerNameResolutionProtocolCheck,                  // 5.13
+        PeerNetworkingGroupingCheck,                      // 5.14
+        PeerNetworkingIdentityManagerCheck,               // 5.15
+        PNRPMachineNamePublicationServiceCheck,           // 5.16
+        PrintSpoolerCheck,                                // 5.17
+        ProblemReportsServiceCheck,                       // 5.18
+        RemoteAccessAutoConnectionManagerCheck,           // 5.19
+        RemoteDesktopConfigurationCheck,                  // 5.20
+        RemoteDesktopServicesCheck,                       // 5.21
+        RemoteDesktopServicesUserModePortRedirectorCheck, // 5.22
+        RPCLocatorCheck,                                  // 5.23
+        RemoteRegistryCheck,                              // 5.24
+        RoutingAndRemoteAccessCheck,                      // 5.25
+        ServerServiceCheck,                               // 5.26
+        SimpleTCPIPServicesCheck,                         // 5.27
+        SNMPServiceCheck,                                 // 5.28
+        SpecialAdministrationConsoleHelperCheck,          // 5.29
+        SSDPDiscoveryCheck,                               // 5.30
+        UPnPDeviceHostCheck,                              // 5.31
+        WebManagementServiceCheck,                        // 5.32
+        WindowsErrorReportingServiceCheck,                // 5.33
+        WindowsEventCollectorCheck,                       // 5.34
+        WindowsMediaPlayerNetworkSharingServiceCheck,     // 5.35
+        WindowsMobileHotspotServiceCheck,                 // 5.36
+        WindowsPushNotificationsSystemServiceCheck,       // 5.37
+        WindowsPushToInstallServiceCheck,                 // 5.38
+        WindowsRemoteManagementCheck,                     // 5.39
+        WorldWideWebPublishingServiceCheck,               // 5.40
+        XboxAccessoryManagementServiceCheck,              // 5.41
+        XboxLiveAuthManagerCheck,                         // 5.42
+        XboxLiveGameSaveCheck,                            // 5.43
+        XboxLiveNetworkingServiceCheck                    // 5.44
+    > sectionChecks;
+    checks = sectionChecks.list();
 }
 
 std::vector<BenchmarkResult> SystemServicesSection::runChecks()
@@ -68,43 +89,43 @@ std::vector<BenchmarkResult> SystemServicesSection::runChecks()
     return results;
 }
 
+void SystemServicesSection::declareInputs(ProbeInputs& inputs) const
+{
+    inputs.addServices();
+}
+
+// The SCM is enumerated once per run, on first use, and every 5.x check
+// resolves its service from that snapshot.
+std::shared_ptr<const ServiceSnapshot> SystemServicesSection::getServiceSnapshot()
+{
+    return RunContext::current().getOrBuild<ServiceSnapshot>([](SystemProbe& probe) {
+        std::vector<ServiceEntry> services;
+        HRESULT hr = probe.queryServices(services);
+        return ServiceSnapshot(hr, std::move(services));
+    });
+}
+
 // Helper function
-bool SystemServicesSection::IsServiceDisabledOrNotInstalled(const std::wstring& serviceName)
+HRESULT SystemServicesSection::IsServiceDisabledOrNotInstalled(const std::wstring& serviceName, bool& compliant)
 {
-    SC_HANDLE hSCM = OpenSCManager(nullptr, nullptr, SC_MANAGER_CONNECT);
-    if (!hSCM) {
-        return false; // Could not open SCM; treat as error
+    auto snapshot = getServiceSnapshot();
+    if (FAILED(snapshot->getStatus())) {
+        return snapshot->getStatus(); // Could not query the SCM
     }
 
-    SC_HANDLE hService = OpenServiceW(hSCM, serviceName.c_str(), SERVICE_QUERY_CONFIG);
-    if (!hService) {
-        // Possibly not installed
-        DWORD err = GetLastError();
-        CloseServiceHandle(hSCM);
-        if (err == ERROR_SERVICE_DOES_NOT_EXIST) {
-            // "Not installed" => pass for the "Disabled or Not Installed" requirement
-            return true;
-        }
-        return false;
+    const ServiceEntry* service = snapshot->find(serviceName);
+    if (!service) {
+        // "Not installed" => pass for the "Disabled or Not Installed" requirement
+        compliant = true;
+        return S_OK;
     }
-
-    // Query the config
-    QUERY_SERVICE_CONFIGW svcConfig = {};
-    BYTE buffer[8192];
-    DWORD bytesNeeded = 0;
-    LPQUERY_SERVICE_CONFIGW pConfig = reinterpret_cast<LPQUERY_SERVICE_CONFIGW>(buffer);
-
-    BOOL success = QueryServiceConfigW(hService, pConfig, sizeof(buffer), &bytesNeeded);
-
-    CloseServiceHandle(hService);
-    CloseServiceHandle(hSCM);
-
-    if (!success) {
-        return false; 
+    if (FAILED(service->status)) {
+        return service->status; // Could not read its configuration
     }
 
     // If the StartType is SERVICE_DISABLED, we pass
-    return (pConfig->dwStartType == SERVICE_DISABLED);
+    compliant = (service->config.startType == SERVICE_DISABLED);
+    return S_OK;
 }
 
 // -----------------------------------------------------
@@ -115,8 +136,11 @@ BenchmarkResult CHECKNAME::check()                                           \
 {                                                                            \
     BenchmarkResult r(getId(), getName(), CheckStatus::Error,                \
                       "Failed to check service configuration");              \
-    bool disabledOrMissing = SystemServicesSection::IsServiceDisabledOrNotInstalled(L##SERVICENAME); \
-    if (disabledOrMissing) {                                                \
+    bool disabledOrMissing = false;                                          \
+    if (FAILED(SystemServicesSection::IsServiceDisabledOrNotInstalled(L##SERVICENAME, disabledOrMissing))) { \
+        return r;                                                            \
+    }                                                                        \
+    if (disabledOrMissing) {                                                 \
         r.status  = CheckStatus::Pass;                                       \
         r.details = #SERVICENAME " is disabled or not installed";            \
     } else {                                                                 \
@@ -1,5 +1,6 @@
 #include "include/sections/section9/windows_firewall_section.h"
-#include <windows.h>
+#include "include/run_context.h"
+#include <cstring>
 #include <string>
 #include <iostream>   // for printing error messages if desired
 
@@ -8,16 +9,19 @@
    -------------------------------------------------- */
 void WindowsFirewallSection::initialize()
 {
-    // Add each check to the "checks" vector
-    checks.push_back(std::make_unique<FirewallDomainStateCheck>());        
-    checks.push_back(std::make_unique<FirewallDomainInboundActionCheck>());
-    checks.push_back(std::make_unique<FirewallDomainNotifyCheck>());
+    // Every check of section 9, built once per process
+    static const CheckArray<
+        FirewallDomainStateCheck,
+        FirewallDomainInboundActionCheck,
+        FirewallDomainNotifyCheck,
 
-    checks.push_back(std::make_unique<FirewallPrivateStateCheck>());
-    checks.push_back(std::make_unique<FirewallPrivateInboundActionCheck>());
+        FirewallPrivateStateCheck,
+        FirewallPrivateInboundActionCheck,
 
-    checks.push_back(std::make_unique<FirewallPublicStateCheck>());
-    checks.push_back(std::make_unique<FirewallPublicInboundActionCheck>());
+        FirewallPublicStateCheck,
+        FirewallPublicInboundActionCheck
+    > sectionChecks;
+    checks = sectionChecks.list();
 }
 
 std::vector<BenchmarkResult> WindowsFirewallSection::runChecks()
@@ -30,52 +34,52 @@ std::vector<BenchmarkResult> WindowsFirewallSection::runChecks()
 }
 
 /**
- * CheckFirewallPolicyDword:
+ * FirewallPolicyDwordRule:
  *  - Reads the subkey under HKLM\SOFTWARE\Policies\Microsoft\WindowsFirewall\<profileKey>
- *  - Compares the named value to expectedValue
+ *  - Passes when the named value equals expectedValue
  */
-bool WindowsFirewallSection::CheckFirewallPolicyDword(
+ScalarRule WindowsFirewallSection::FirewallPolicyDwordRule(
     const std::wstring& profileKey,
     const std::wstring& valueName,
     DWORD expectedValue
 )
 {
-    DWORD data = 0;
-    if (!ReadFirewallRegDword(profileKey, valueName, data)) {
-        return false;
-    }
-    return (data == expectedValue);
+    return ScalarRule{ &ReadFirewallRegDword, PolicyKeyPath(profileKey), valueName,
+                       expectedValue, expectedValue, CheckStatus::Fail };
 }
 
-/**
- * ReadFirewallRegDword:
- *   - Actually does the registry open/query for:
- *       HKLM\SOFTWARE\Policies\Microsoft\WindowsFirewall\<profileKey>
- */
-bool WindowsFirewallSection::ReadFirewallRegDword(
+void WindowsFirewallSection::DeclareFirewallPolicyDword(
+    ProbeInputs& inputs,
     const std::wstring& profileKey,
-    const std::wstring& valueName,
-    DWORD& outValue
+    const std::wstring& valueName
 )
 {
-    std::wstring path = L"SOFTWARE\\Policies\\Microsoft\\WindowsFirewall\\" + profileKey;
+    inputs.addRegistryValue(PolicyKeyPath(profileKey), valueName);
+}
 
-    HKEY hKey = nullptr;
-    LONG rc   = RegOpenKeyExW(HKEY_LOCAL_MACHINE, path.c_str(), 0, KEY_READ, &hKey);
-    if (rc != ERROR_SUCCESS) {
-        return false;
+std::wstring WindowsFirewallSection::PolicyKeyPath(const std::wstring& profileKey)
+{
+    return L"SOFTWARE\\Policies\\Microsoft\\WindowsFirewall\\" + profileKey;
+}
+
+/**
+ * ReadFirewallRegDword:
+ *   - Looks up, in the run's registry cache:
+ *       HKLM\SOFTWARE\Policies\Microsoft\WindowsFirewall\<profileKey>\<valueName>
+ *     (rule.path and rule.valueName), which must be a REG_DWORD.
+ */
+HRESULT WindowsFirewallSection::ReadFirewallRegDword(const ScalarRule& rule, DWORD& outValue)
+{
+    RegistryValue value;
+    HRESULT hr = RunContext::current().getRegistry().getValue(rule.path, rule.valueName, value);
+    if (FAILED(hr)) {
+        return hr;
     }
-    DWORD data = 0;
-    DWORD dataSize = sizeof(data);
-    DWORD type = 0;
-    rc = RegQueryValueExW(hKey, valueName.c_str(), nullptr, &type, reinterpret_cast<LPBYTE>(&data), &dataSize);
-    RegCloseKey(hKey);
-
-    if (rc == ERROR_SUCCESS && type == REG_DWORD) {
-        outValue = data;
-        return true;
+    if (value.type != REG_DWORD || value.data.size() != sizeof(DWORD)) {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
     }
-    return false;
+    std::memcpy(&outValue, value.data.data(), sizeof(DWORD));
+    return S_OK;
 }
 
 
@@ -84,151 +88,176 @@ bool WindowsFirewallSection::ReadFirewallRegDword(
    -------------------------------------------------- */
 
 // 9.1.1 - Domain: Firewall state => On (EnableFirewall=1)
+void FirewallDomainStateCheck::declareInputs(ProbeInputs& inputs) const
+{
+    WindowsFirewallSection::DeclareFirewallPolicyDword(inputs, L"DomainProfile", L"EnableFirewall");
+}
+
+const ScalarRule* FirewallDomainStateCheck::getScalarRule() const
+{
+    static const ScalarRule rule = WindowsFirewallSection::FirewallPolicyDwordRule(L"DomainProfile", L"EnableFirewall", 1);
+    return &rule;
+}
+
 BenchmarkResult FirewallDomainStateCheck::check()
 {
-    BenchmarkResult r(getId(), getName(), CheckStatus::Error,
-                      "Failed to check Windows Firewall: Domain: Firewall state");
-    
-    // "EnableFirewall"=1 under DomainProfile => On
-    bool pass = WindowsFirewallSection::CheckFirewallPolicyDword(
-        L"DomainProfile",
-        L"EnableFirewall",
-        1
-    );
-    if (pass) {
-        r.status  = CheckStatus::Pass;
-        r.details = "Domain firewall is ON (EnableFirewall=1).";
-    } else {
-        r.status  = CheckStatus::Fail;
-        r.details = "Domain firewall is NOT set to On.";
+    return checkScalar();
+}
+
+std::string FirewallDomainStateCheck::describeScalar(CheckStatus status, DWORD /*value*/) const
+{
+    if (status == CheckStatus::Pass) {
+        return "Domain firewall is ON (EnableFirewall=1).";
     }
-    return r;
+    return "Domain firewall is NOT set to On.";
 }
 
 // 9.1.2 - Domain: Inbound connections => Block (DefaultInboundAction=1)
+void FirewallDomainInboundActionCheck::declareInputs(ProbeInputs& inputs) const
+{
+    WindowsFirewallSection::DeclareFirewallPolicyDword(inputs, L"DomainProfile", L"DefaultInboundAction");
+}
+
+const ScalarRule* FirewallDomainInboundActionCheck::getScalarRule() const
+{
+    static const ScalarRule rule = WindowsFirewallSection::FirewallPolicyDwordRule(L"DomainProfile", L"DefaultInboundAction", 1);
+    return &rule;
+}
+
 BenchmarkResult FirewallDomainInboundActionCheck::check()
 {
-    BenchmarkResult r(getId(), getName(), CheckStatus::Error,
-                      "Failed to check Windows Firewall: Domain: Inbound connections");
-
-    // "DefaultInboundAction"=1 => Block
-    bool pass = WindowsFirewallSection::CheckFirewallPolicyDword(
-        L"DomainProfile",
-        L"DefaultInboundAction",
-        1
-    );
-    if (pass) {
-        r.status  = CheckStatus::Pass;
-        r.details = "Domain inbound connections => Block (DefaultInboundAction=1).";
-    } else {
-        r.status  = CheckStatus::Fail;
-        r.details = "Domain inbound connections are NOT set to 'Block (default)'.";
+    return checkScalar();
+}
+
+std::string FirewallDomainInboundActionCheck::describeScalar(CheckStatus status, DWORD /*value*/) const
+{
+    if (status == CheckStatus::Pass) {
+        return "Domain inbound connections => Block (DefaultInboundAction=1).";
     }
-    return r;
+    return "Domain inbound connections are NOT set to 'Block (default)'.";
 }
 
 // 9.1.3 - Domain: Display a notification => No => "DisableNotifications"=1
+void FirewallDomainNotifyCheck::declareInputs(ProbeInputs& inputs) const
+{
+    WindowsFirewallSection::DeclareFirewallPolicyDword(inputs, L"DomainProfile", L"DisableNotifications");
+}
+
+const ScalarRule* FirewallDomainNotifyCheck::getScalarRule() const
+{
+    static const ScalarRule rule = WindowsFirewallSection::FirewallPolicyDwordRule(L"DomainProfile", L"DisableNotifications", 1);
+    return &rule;
+}
+
 BenchmarkResult FirewallDomainNotifyCheck::check()
 {
-    BenchmarkResult r(getId(), getName(), CheckStatus::Error,
-                      "Failed to check Windows Firewall: Domain: Display a notification => 'No'");
-
-    // "DisableNotifications"=1 => No notifications
-    bool pass = WindowsFirewallSection::CheckFirewallPolicyDword(
-        L"DomainProfile",
-        L"DisableNotifications",
-        1
-    );
-    if (pass) {
-        r.status  = CheckStatus::Pass;
-        r.details = "Domain notifications => No (DisableNotifications=1).";
-    } else {
-        r.status  = CheckStatus::Fail;
-        r.details = "Domain notifications are not set to 'No'.";
+    return checkScalar();
+}
+
+std::string FirewallDomainNotifyCheck::describeScalar(CheckStatus status, DWORD /*value*/) const
+{
+    if (status == CheckStatus::Pass) {
+        return "Domain notifications => No (DisableNotifications=1).";
     }
-    return r;
+    return "Domain notifications are not set to 'No'.";
 }
 
 // 9.2.1 - Private: Firewall state => On (EnableFirewall=1)
+void FirewallPrivateStateCheck::declareInputs(ProbeInputs& inputs) const
+{
+    WindowsFirewallSection::DeclareFirewallPolicyDword(inputs, L"PrivateProfile", L"EnableFirewall");
+}
+
+const ScalarRule* FirewallPrivateStateCheck::getScalarRule() const
+{
+    static const ScalarRule rule = WindowsFirewallSection::FirewallPolicyDwordRule(L"PrivateProfile", L"EnableFirewall", 1);
+    return &rule;
+}
+
 BenchmarkResult FirewallPrivateStateCheck::check()
 {
-    BenchmarkResult r(getId(), getName(), CheckStatus::Error,
-                      "Failed to check Windows Firewall: Private: Firewall state");
-
-    bool pass = WindowsFirewallSection::CheckFirewallPolicyDword(
-        L"PrivateProfile",
-        L"EnableFirewall",
-        1
-    );
-    if (pass) {
-        r.status  = CheckStatus::Pass;
-        r.details = "Private firewall is ON (EnableFirewall=1).";
-    } else {
-        r.status  = CheckStatus::Fail;
-        r.details = "Private firewall is NOT set to On.";
+    return checkScalar();
+}
+
+std::string FirewallPrivateStateCheck::describeScalar(CheckStatus status, DWORD /*value*/) const
+{
+    if (status == CheckStatus::Pass) {
+        return "Private firewall is ON (EnableFirewall=1).";
     }
-    return r;
+    return "Private firewall is NOT set to On.";
 }
 
 // 9.2.2 - Private: Inbound connections => Block => (DefaultInboundAction=1)
+void FirewallPrivateInboundActionCheck::declareInputs(ProbeInputs& inputs) const
+{
+    WindowsFirewallSection::DeclareFirewallPolicyDword(inputs, L"PrivateProfile", L"DefaultInboundAction");
+}
+
+const ScalarRule* FirewallPrivateInboundActionCheck::getScalarRule() const
+{
+    static const ScalarRule rule = WindowsFirewallSection::FirewallPolicyDwordRule(L"PrivateProfile", L"DefaultInboundAction", 1);
+    return &rule;
+}
+
 BenchmarkResult FirewallPrivateInboundActionCheck::check()
 {
-    BenchmarkResult r(getId(), getName(), CheckStatus::Error,
-                      "Failed to check Windows Firewall: Private: Inbound connections");
-
-    bool pass = WindowsFirewallSection::CheckFirewallPolicyDword(
-        L"PrivateProfile",
-        L"DefaultInboundAction",
-        1
-    );
-    if (pass) {
-        r.status  = CheckStatus::Pass;
-        r.details = "Private inbound connections => Block (1).";
-    } else {
-        r.status  = CheckStatus::Fail;
-        r.details = "Private inbound connections are NOT set to 'Block'.";
+    return checkScalar();
+}
+
+std::string FirewallPrivateInboundActionCheck::describeScalar(CheckStatus status, DWORD /*value*/) const
+{
+    if (status == CheckStatus::Pass) {
+        return "Private inbound connections => Block (1).";
     }
-    return r;
+    return "Private inbound connections are NOT set to 'Block'.";
 }
 
 // 9.3.1 - Public: Firewall state => On (EnableFirewall=1)
+void FirewallPublicStateCheck::declareInputs(ProbeInputs& inputs) const
+{
+    WindowsFirewallSection::DeclareFirewallPolicyDword(inputs, L"PublicProfile", L"EnableFirewall");
+}
+
+const ScalarRule* FirewallPublicStateCheck::getScalarRule() const
+{
+    static const ScalarRule rule = WindowsFirewallSection::FirewallPolicyDwordRule(L"PublicProfile", L"EnableFirewall", 1);
+    return &rule;
+}
+
 BenchmarkResult FirewallPublicStateCheck::check()
 {
-    BenchmarkResult r(getId(), getName(), CheckStatus::Error,
-                      "Failed to check Windows Firewall: Public: Firewall state");
-
-    bool pass = WindowsFirewallSection::CheckFirewallPolicyDword(
-        L"PublicProfile",
-        L"EnableFirewall",
-        1
-    );
-    if (pass) {
-        r.status  = CheckStatus::Pass;
-        r.details = "Public firewall is ON (EnableFirewall=1).";
-    } else {
-        r.status  = CheckStatus::Fail;
-        r.details = "Public firewall is NOT set to On.";
+    return checkScalar();
+}
+
+std::string FirewallPublicStateCheck::describeScalar(CheckStatus status, DWORD /*value*/) const
+{
+    if (status == CheckStatus::Pass) {
+        return "Public firewall is ON (EnableFirewall=1).";
     }
-    return r;
+    return "Public firewall is NOT set to On.";
 }
 
 // 9.3.2 - Public: Inbound connections => Block => (DefaultInboundAction=1)
+void FirewallPublicInboundActionCheck::declareInputs(ProbeInputs& inputs) const
+{
+    WindowsFirewallSection::DeclareFirewallPolicyDword(inputs, L"PublicProfile", L"DefaultInboundAction");
+}
+
+const ScalarRule* FirewallPublicInboundActionCheck::getScalarRule() const
+{
+    static const ScalarRule rule = WindowsFirewallSection::FirewallPolicyDwordRule(L"PublicProfile", L"DefaultInboundAction", 1);
+    return &rule;
+}
+
 BenchmarkResult FirewallPublicInboundActionCheck::check()
 {
-    BenchmarkResult r(getId(), getName(), CheckStatus::Error,
-                      "Failed to check Windows Firewall: Public: Inbound connections");
-
-    bool pass = WindowsFirewallSection::CheckFirewallPolicyDword(
-        L"PublicProfile",
-        L"DefaultInboundAction",
-        1
-    );
-    if (pass) {
-        r.status  = CheckStatus::Pass;
-        r.details = "Public inbound connections => Block (1).";
-    } else {
-        r.status  = CheckStatus::Fail;
-        r.details = "Public inbound connections are NOT set to 'Block'.";
+    return checkScalar();
+}
+
+std::string FirewallPublicInboundActionCheck::describeScalar(CheckStatus status, DWORD /*value*/) const
+{
+    if (status == CheckStatus::Pass) {
+        return "Public inbound connections => Block (1).";
     }
-    return r;
+    return "Public inbound connections are NOT set to 'Block'.";
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "include/text_decode.h"
+
+namespace {
+void appendCodePoint(std::wstring& out, uint32_t cp) {
+    if (sizeof(wchar_t) == 2 && cp >= 0x10000) {
+        cp -= 0x10000;
+        out.push_back(static_cast<wchar_t>(0xD800 + (cp >> 10)));
+        out.push_back(static_cast<wchar_t>(0xDC00 + (cp & 0x3FF)));
+    } else {
+        out.push_back(static_cast<wchar_t>(cp));
+    }
+}
+
+std::wstring decodeUtf8(const BYTE* p, const BYTE* end) {
+    std::wstring out;
+    out.reserve(end - p);
+    while (p < end) {
+        BYTE lead = *p++;
+        if (lead < 0x80) {
+            out.push_back(static_cast<wchar_t>(lead));
+            continue;
+        }
+        int extra = (lead >= 0xF0 && lead < 0xF8) ? 3 : (lead >= 0xE0) ? 2 : (lead >= 0xC0) ? 1 : -1;
+        uint32_t cp = (extra == 3) ? (lead & 0x07) : (extra == 2) ? (lead & 0x0F) : (lead & 0x1F);
+        if (extra < 0 || end - p < extra) {
+            out.push_back(L'\xFFFD');
+            continue;
+        }
+        bool valid = true;
+        for (int i = 0; i < extra; i++) {
+            if ((p[i] & 0xC0) != 0x80) {
+                valid = false;
+                break;
+            }
+            cp = (cp << 6) | (p[i] & 0x3F);
+        }
+        if (!valid) {
+            out.push_back(L'\xFFFD');
+            continue;
+        }
+        p += extra;
+        appendCodePoint(out, cp);
+    }
+    return out;
+}
+
+std::wstring decodeUtf16le(const BYTE* p, const BYTE* end) {
+    std::wstring out;
+    out.reserve((end - p) / 2);
+    for (; p + 1 < end; p += 2) {
+        uint32_t unit = static_cast<uint32_t>(p[0] | (p[1] << 8));
+        if (sizeof(wchar_t) > 2 && unit >= 0xD800 && unit < 0xDC00 && p + 3 < end) {
+            uint32_t low = static_cast<uint32_t>(p[2] | (p[3] << 8));
+            if (low >= 0xDC00 && low < 0xE000) {
+                appendCodePoint(out, 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00));
+                p += 2;
+                continue;
+            }
+        }
+        out.push_back(static_cast<wchar_t>(unit));
+    }
+    return out;
+}
+}
+
+std::wstring decodeText(const BYTE* data, size_t size) {
+    const BYTE* end = data + size;
+    if (size >= 2 && data[0] == 0xFF && data[1] == 0xFE) {
+        return decodeUtf16le(data + 2, end);
+    }
+    if (size >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) {
+        return decodeUtf8(data + 3, end);
+    }
+    return decodeUtf8(data, end);
+}
+
+std::string encodeUtf8(const std::wstring& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        uint32_t cp = static_cast<uint32_t>(text[i]);
+        if (sizeof(wchar_t) == 2 && cp >= 0xD800 && cp < 0xDC00 && i + 1 < text.size()) {
+            uint32_t low = static_cast<uint32_t>(text[i + 1]);
+            if (low >= 0xDC00 && low < 0xE000) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            }
+        }
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+    return out;
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "include/work_stealing_pool.h"
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class TaskDeque {
+public:
+    void push(size_t index) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(index);
+    }
+
+    // Owner side: newest task first.
+    bool pop(size_t& index) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) {
+            return false;
+        }
+        index = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+
+    // Thief side: oldest task first, away from the owner's end.
+    bool steal(size_t& index) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) {
+            return false;
+        }
+        index = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+};
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned int workerCount)
+    : workerCount(workerCount > 0 ? workerCount : 1) {}
+
+void WorkStealingPool::run(size_t taskCount, const std::function<void(size_t)>& task) {
+    if (taskCount == 0) {
+        return;
+    }
+
+    size_t threadCount = std::min<size_t>(workerCount, taskCount);
+    std::vector<std::unique_ptr<TaskDeque>> deques;
+    for (size_t w = 0; w < threadCount; w++) {
+        deques.push_back(std::make_unique<TaskDeque>());
+    }
+
+    // Seed each deque with a contiguous block. The owner pops from the back,
+    // so push the block in reverse to start on its first task.
+    size_t perWorker = (taskCount + threadCount - 1) / threadCount;
+    for (size_t w = 0; w < threadCount; w++) {
+        size_t begin = w * perWorker;
+        size_t end = std::min(taskCount, begin + perWorker);
+        for (size_t i = end; i > begin; i--) {
+            deques[w]->push(i - 1);
+        }
+    }
+
+    std::mutex errorMutex;
+    std::exception_ptr firstError;
+
+    auto worker = [&](size_t self) {
+        size_t index = 0;
+        while (true) {
+            bool found = deques[self]->pop(index);
+            for (size_t k = 1; !found && k < threadCount; k++) {
+                found = deques[(self + k) % threadCount]->steal(index);
+            }
+            // No task creates new tasks, so once every deque is empty the
+            // run is over for this worker.
+            if (!found) {
+                return;
+            }
+
+            try {
+                task(index);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (size_t w = 0; w < threadCount; w++) {
+        threads.emplace_back(worker, w);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
\ No newline at end of file